@@ -17,8 +17,8 @@ Item {
         chart.width = height + 2*chart.plotArea.x
     }
 
-    function draw(points, depth, initPos) {
-        chart.draw(points, depth, initPos)
+    function draw(profile, depth, initPos) {
+        chart.draw(profile, depth, initPos)
         correctChartSize()
     }
     onWidthChanged: correctChartSize()
@@ -93,15 +93,15 @@ Item {
             color: 'lime'
         }
 
-        function draw(points, depth, initPost) {
-            if (points) {
+        function draw(profile, depth, initPost) {
+            if (profile) {
                 // If there is no user configuration, we set the max and min automatically
                 if(maxDepthToDraw == 0 && minDepthToDraw == 0) {
-                    Util.update(serie, points, initPost, depth, initPost, depth, 1)
-                    Util.update(serieInv, points, initPost, depth, initPost, depth, -1)
+                    Util.update(serie, profile, initPost, depth, initPost, depth, 1)
+                    Util.update(serieInv, profile, initPost, depth, initPost, depth, -1)
                 } else {
-                    Util.update(serie, points, initPost, depth, minDepthToDraw, maxDepthToDraw, 1)
-                    Util.update(serieInv, points, initPost, depth, minDepthToDraw, maxDepthToDraw, -1)
+                    Util.update(serie, profile, initPost, depth, minDepthToDraw, maxDepthToDraw, 1)
+                    Util.update(serieInv, profile, initPost, depth, minDepthToDraw, maxDepthToDraw, -1)
                 }
                 return
             }
@@ -34,6 +34,13 @@ Item {
                     udpIp.text = ping.link.configuration.argsAsConst()[0]
                     udpPort.text = ping.link.configuration.argsAsConst()[1]
                     break
+                case AbstractLinkNamespace.Tcp:
+                    conntype.currentIndex = 2
+                    udpLayout.enabled = true
+                    serialLayout.enabled = false
+                    udpIp.text = ping.link.configuration.argsAsConst()[0]
+                    udpPort.text = ping.link.configuration.argsAsConst()[1]
+                    break
                 case AbstractLinkNamespace.PinkSimulation:
                     conntype.currentIndex = 2
                     udpLayout.enabled = false
@@ -97,7 +104,7 @@ Item {
                 // Check AbstractLinkNamespace::LinkType for correct index type
                 // None = 0, File, Serial, Udp, Tcp..
                 // Simulation is done via normal device manager since it does not need user configuration
-                model: ["Serial (default)", "UDP"]
+                model: ["Serial (default)", "UDP", "TCP"]
                 onActivated: {
                     switch(index) {
                         case 0: // Serial
@@ -106,6 +113,7 @@ Item {
                             break
 
                         case 1: // UDP
+                        case 2: // TCP
                             udpLayout.enabled = true
                             serialLayout.enabled = false
                             break
@@ -162,7 +170,7 @@ Item {
                 enabled: false
 
                 Text {
-                    text: "UDP Host/Port:"
+                    text: conntype.currentText + " Host/Port:"
                     color: udpIp.isValid ? Material.primary : Material.color(Material.Error)
                 }
 
@@ -201,7 +209,7 @@ Item {
                 Layout.fillWidth: true
                 Layout.columnSpan: 5
 
-                // Disable if using an invalid UDP address
+                // Disable if using an invalid UDP or TCP address
                 enabled: conntype.currentIndex === 0 || udpIp.isValid
 
                 onClicked: {
@@ -218,6 +226,11 @@ Item {
                             connectionType = AbstractLinkNamespace.Udp
                             connectionConf = [udpIp.text, udpPort.text]
                             break
+
+                        case 2: // TCP
+                            connectionType = AbstractLinkNamespace.Tcp
+                            connectionConf = [udpIp.text, udpPort.text]
+                            break
                     }
                     DeviceManager.connectLinkDirectly(connectionType, connectionConf, connectionDevice)
                 }
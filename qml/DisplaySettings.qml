@@ -61,6 +61,85 @@ ColumnLayout {
                     onCheckedChanged: SettingsManager.replayMenu = checked
                 }
 
+                Label {
+                    text: "Frame overflow:"
+                }
+
+                ComboBox {
+                    id: framePolicyCB
+                    Layout.columnSpan:  4
+                    Layout.fillWidth: true
+                    // Same order of FrameQueue::Policy
+                    model: ["Drop oldest", "Merge (max)", "Merge (mean)", "Block"]
+                    currentIndex: SettingsManager.framePolicy
+                    onCurrentIndexChanged: SettingsManager.framePolicy = currentIndex
+                }
+
+                Label {
+                    text: "Log flush:"
+                }
+
+                ComboBox {
+                    id: logFlushPolicyCB
+                    Layout.columnSpan:  4
+                    Layout.fillWidth: true
+                    // Same order of AsyncLogWriter::FlushPolicy
+                    model: ["When chunk is full", "Every second", "Every second with disk sync"]
+                    currentIndex: SettingsManager.logFlushPolicy
+                    onCurrentIndexChanged: SettingsManager.logFlushPolicy = currentIndex
+                }
+
+                CheckBox {
+                    id: logCompressionChB
+                    text: "Compress logs"
+                    checked: SettingsManager.logCompression
+                    Layout.columnSpan:  5
+                    Layout.fillWidth: true
+                    onCheckedChanged: SettingsManager.logCompression = checked
+                }
+
+                CheckBox {
+                    id: serialLowLatencyChB
+                    text: "Low latency serial"
+                    checked: SettingsManager.serialLowLatency
+                    Layout.columnSpan:  5
+                    Layout.fillWidth: true
+                    onCheckedChanged: SettingsManager.serialLowLatency = checked
+                }
+
+                CheckBox {
+                    id: sharedMemoryOutputChB
+                    text: "Shared memory output"
+                    checked: SettingsManager.sharedMemoryOutput
+                    Layout.columnSpan:  5
+                    Layout.fillWidth: true
+                    onCheckedChanged: SettingsManager.sharedMemoryOutput = checked
+                }
+
+                Label {
+                    text: "Relay ports:"
+                }
+
+                TextField {
+                    id: relayTcpPortTF
+                    placeholderText: "TCP"
+                    text: SettingsManager.relayTcpPort ? SettingsManager.relayTcpPort : ""
+                    validator: IntValidator { bottom: 0; top: 65535 }
+                    Layout.columnSpan:  2
+                    Layout.fillWidth: true
+                    onEditingFinished: SettingsManager.relayTcpPort = text ? parseInt(text) : 0
+                }
+
+                TextField {
+                    id: relayUdpPortTF
+                    placeholderText: "UDP"
+                    text: SettingsManager.relayUdpPort ? SettingsManager.relayUdpPort : ""
+                    validator: IntValidator { bottom: 0; top: 65535 }
+                    Layout.columnSpan:  2
+                    Layout.fillWidth: true
+                    onEditingFinished: SettingsManager.relayUdpPort = text ? parseInt(text) : 0
+                }
+
                 Loader {
                     sourceComponent: DeviceManager.primarySensor ?
                         DeviceManager.primarySensor.sensorVisualizer().displaySettings : null
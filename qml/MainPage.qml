@@ -9,6 +9,7 @@ import Qt.labs.settings 1.0
 import AbstractLinkNamespace 1.0
 import DeviceManager 1.0
 import FileManager 1.0
+import OverviewPlot 1.0
 import Ping 1.0
 import SettingsManager 1.0
 import StyleManager 1.0
@@ -150,6 +151,36 @@ Item {
                 }
             }
 
+            PingButton {
+                id: replayStepBackBt
+                text: "◀▮"
+                enabled: replayStartBt.enabled
+                onClicked: {
+                    replayStartBt.text = "▶"
+                    ping.link.step(-1)
+                }
+            }
+
+            PingButton {
+                id: replayStepForwardBt
+                text: "▮▶"
+                enabled: replayStartBt.enabled
+                onClicked: {
+                    replayStartBt.text = "▶"
+                    ping.link.step(1)
+                }
+            }
+
+            ComboBox {
+                id: replayRateCB
+                enabled: replayStartBt.enabled
+                // Rate 0 is unthrottled
+                property var rates: [0.1, 0.25, 0.5, 1, 2, 5, 10, 100, 0]
+                model: ["0.1x", "0.25x", "0.5x", "1x", "2x", "5x", "10x", "100x", "Max"]
+                currentIndex: rates.indexOf(ping ? ping.link.replayRate : 10)
+                onActivated: ping.link.replayRate = rates[index]
+            }
+
             Text {
                 id: timeText
                 text: "Time:"
@@ -160,14 +191,20 @@ Item {
                 id: replaySlider
                 enabled: ping ? !ping.link.isWritable() : false
                 from: 0
-                value: ping ? ping.link.packageIndex : 0
-                stepSize: 1
-                to: ping ? ping.link.packageSize : 0
-                onValueChanged: {
-                    if(ping.link.packageIndex !== value) {
-                        ping.link.packageIndex = value
-                        ping.link.start()
-                    }
+                // Time in milliseconds, seeks are coalesced by the link while dragging
+                value: ping ? ping.link.elapsedTimeMs : 0
+                to: ping ? ping.link.totalTimeMs : 0
+                onMoved: ping.link.seek(value)
+
+                // Log minimap, the overview covers the whole log duration
+                OverviewPlot {
+                    anchors.fill: parent
+                    anchors.leftMargin: parent.leftPadding
+                    anchors.rightMargin: parent.rightPadding
+                    z: -1
+                    opacity: 0.6
+                    overview: ping ? ping.link.overview : null
+                    visible: overview
                 }
             }
 
@@ -200,15 +237,17 @@ Item {
 
     PingFileDialog {
         id: replayFileDialog
-        title: "Please choose a log file"
+        title: "Please choose one or more log files"
         nameFilters: ["Binary files (*.bin)"]
+        // Logs of the same dive are played as a single log
+        selectMultiple: true
         // Accessing folder variable directly does not work
         // From: https://stackoverflow.com/questions/46672657/how-to-set-filedialogs-folder-from-a-unc-path-in-qml
         // Bug: https://bugreports.qt.io/browse/QTBUG-63710
         Component.onCompleted: folder = FileManager.getPathFrom(FileManager.SensorLog)
         onAccepted: {
-            ping.connectLink(AbstractLinkNamespace.File, [fileUrl, "r"])
-            replayFileName.text = "File: " + fileName
+            ping.connectLink(AbstractLinkNamespace.File, [fileUrls.join(";"), "r"])
+            replayFileName.text = "File: " + fileName + (fileUrls.length > 1 ? " (+" + (fileUrls.length - 1) + ")" : "")
         }
     }
 
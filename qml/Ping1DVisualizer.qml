@@ -21,18 +21,28 @@ Item {
     Connections {
         target: ping
 
-        onPointsUpdate: {
+        // Every profile is a waterfall column, the waterfall queues them
+        onProfileReceived: {
             // Move from mm to m
-            root.draw(ping.points, ping.confidence, ping.start_mm*1e-3, ping.length_mm * 1e-3, ping.distance*1e-3)
+            waterfall.draw(ping.profile, confidence, start_mm*1e-3, length_mm*1e-3, distance*1e-3)
         }
 
-        onDistanceUpdate: {
-            root.setDepth(ping.distance/1e3)
+        // All property changes inside a display frame arrive together
+        onFrameUpdate: {
+            var frame = ping.frame
+            if(frame.pointsUpdated) {
+                chart.draw(ping.profile, (frame.length_mm + frame.start_mm)*1e-3, frame.start_mm*1e-3)
+            }
+            root.setDepth(frame.distance/1e3)
+            root.setConfidence(frame.confidence)
         }
+    }
 
-        onConfidenceUpdate: {
-            root.setConfidence(ping.confidence)
-        }
+    Connections {
+        target: ping ? ping.link : null
+
+        // Data before a seek is not continuous with the new position, the log pre-roll will rebuild it
+        onSeeked: clear()
     }
 
     onWidthChanged: {
@@ -41,11 +51,6 @@ Item {
         }
     }
 
-    function draw(points, confidence, initialPoint, length, distance) {
-        waterfall.draw(points, confidence, initialPoint, length, distance)
-        chart.draw(points, length + initialPoint, initialPoint)
-    }
-
     function setDepth(depth) {
         depthAxis.depth_mm = depth
         readout.value = depth
@@ -65,6 +70,19 @@ Item {
             Layout.fillWidth: true
             Layout.preferredWidth: 350
             Layout.minimumWidth: 350
+            framePolicy: SettingsManager.framePolicy
+
+            Text {
+                id: frameCounters
+                visible: waterfall.droppedFrames + waterfall.mergedFrames > 0
+                anchors.left: parent.left
+                anchors.bottom: parent.bottom
+                anchors.margins: 5
+                font.family: "Arial"
+                font.pointSize: 9
+                text: "Dropped frames: " + waterfall.droppedFrames + "  Merged frames: " + waterfall.mergedFrames
+                color: StyleManager.secondaryColor
+            }
 
             Rectangle {
                 x: waterfall.mousePos.x - width/2 + height/2
@@ -36,19 +36,26 @@ Item {
 
         onDataChanged: {
             shapeSpinner.angle = (ping.angle + 0.25)*180/200
-            root.draw(ping.data, ping.angle, 0, ping.range, ping.angular_speed, ping.sectorSize)
+            root.draw(ping.profile, ping.angle, 0, ping.range, ping.angular_speed, ping.sectorSize)
         }
     }
 
+    Connections {
+        target: ping ? ping.link : null
+
+        // Data before a seek is not continuous with the new position, the log pre-roll will rebuild it
+        onSeeked: clear()
+    }
+
     onWidthChanged: {
         if(chart.Layout.minimumWidth === chart.width) {
             waterfall.parent.width = width - chart.width
         }
     }
 
-    function draw(points, angle, initialPoint, length, angleStep, sectorSize) {
-        waterfall.draw(points, angle, initialPoint, length, angleStep, sectorSize)
-        chart.draw(points, length + initialPoint, initialPoint)
+    function draw(profile, angle, initialPoint, length, angleStep, sectorSize) {
+        waterfall.draw(profile, angle, initialPoint, length, angleStep, sectorSize)
+        chart.draw(profile, length + initialPoint, initialPoint)
     }
 
     QC1.SplitView {
@@ -67,6 +74,8 @@ Item {
                 anchors.horizontalCenter: parent.horizontalCenter
                 anchors.verticalCenter: ping.sectorSize > 180 ? parent.verticalCenter : parent.bottom
 
+                framePolicy: SettingsManager.framePolicy
+
                 property var scale: ping.sectorSize >= 180 ? 1 : 0.8/Math.sin(ping.sectorSize*Math.PI/360)
                 property bool verticalFlip: false
                 property bool horizontalFlip: false
@@ -171,6 +180,18 @@ Item {
                 angle: ping.sectorSize
                 maxDistance: waterfall.maxDistance
             }
+
+            Text {
+                id: frameCounters
+                visible: waterfall.droppedFrames + waterfall.mergedFrames > 0
+                anchors.left: parent.left
+                anchors.bottom: parent.bottom
+                anchors.margins: 5
+                font.family: "Arial"
+                font.pointSize: 9
+                text: "Dropped frames: " + waterfall.droppedFrames + "  Merged frames: " + waterfall.mergedFrames
+                color: StyleManager.secondaryColor
+            }
         }
 
         Chart {
@@ -8,9 +8,12 @@ Item {
     property alias folder: fileDialog.folder
     property alias title: fileDialog.title
     property alias shortcuts: fileDialog.shortcuts
+    property alias selectMultiple: fileDialog.selectMultiple
 
     property var fileName: ""
     property var fileUrl: ""
+    // Local paths of all selected files
+    property var fileUrls: []
     property alias nameFilters: fileDialog.nameFilters
 
     signal accepted(var file)
@@ -26,6 +29,11 @@ Item {
             var folderUrl = fileDialog.folder
 
             root.fileUrl = toLocalPath(fileUrl)
+            var fileUrls = []
+            for (var i = 0; i < fileDialog.fileUrls.length; i++) {
+                fileUrls.push(toLocalPath(fileDialog.fileUrls[i]))
+            }
+            root.fileUrls = fileUrls
             root.fileName = getFileName(folderUrl, fileUrl)
 
             print("Dialog window finished.")
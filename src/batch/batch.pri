@@ -0,0 +1,7 @@
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/*.h
+
+SOURCES += \
+    $$PWD/*.cpp
@@ -0,0 +1,323 @@
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFuture>
+#include <QHash>
+#include <QMap>
+#include <QSaveFile>
+#include <QSet>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include "batchprocessor.h"
+#include "logger.h"
+#include "parser-ping.h"
+#include "sensorlogreader.h"
+
+PING_LOGGING_CATEGORY(BATCHPROCESSOR, "ping.batchprocessor")
+
+namespace {
+const QByteArray binaryMagic = QByteArrayLiteral("PINGDPT1");
+const int binaryRecordSize = 16;
+// Write the time series in blocks of this size
+const int bufferSize = 1024 * 1024;
+}
+
+BatchProcessor::BatchProcessor(const QString& fileName, const QString& outputName, const Options& options)
+    : _messageStatistics{}
+    , _options(options)
+{
+    _summary.fileName = fileName;
+    _summary.outputName = outputName;
+    _summary.renamed = outputName != QFileInfo(fileName).completeBaseName();
+}
+
+QStringList BatchProcessor::outputNames(const QStringList& logs, const QStringList& roots)
+{
+    QHash<QString, int> baseNames;
+    for(const auto& log : logs) {
+        baseNames[QFileInfo(log).completeBaseName().toLower()]++;
+    }
+
+    QStringList names;
+    // Compared in lower case, file systems can be case insensitive
+    QSet<QString> usedNames;
+    for(int i = 0; i < logs.size(); i++) {
+        const QFileInfo logInfo(logs[i]);
+        QString name = logInfo.completeBaseName();
+        const QString root = roots.value(i);
+        if(baseNames[name.toLower()] > 1 && !root.isEmpty()) {
+            const QString folder = QDir(root).relativeFilePath(logInfo.absolutePath());
+            if(folder != QStringLiteral(".")) {
+                name = QString(folder).replace('/', '_') + '_' + name;
+            }
+        }
+
+        QString uniqueName = name;
+        for(int suffix = 2; usedNames.contains(uniqueName.toLower()); suffix++) {
+            uniqueName = QStringLiteral("%1_%2").arg(name).arg(suffix);
+        }
+        usedNames.insert(uniqueName.toLower());
+        names.append(uniqueName);
+    }
+    return names;
+}
+
+BatchProcessor::Summary BatchProcessor::process()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    SensorLogReader reader;
+    if(!reader.open(_summary.fileName)) {
+        qCWarning(BATCHPROCESSOR) << "Not possible to open log:" << _summary.fileName;
+        return _summary;
+    }
+    reader.waitForIndex();
+
+    const QString extension = _options.format == Binary ? QStringLiteral("bin") : QStringLiteral("csv");
+    _output.setFileName(QDir(_options.outputDirectory).filePath(
+                            QStringLiteral("%1_depth.%2").arg(_summary.outputName, extension)));
+    if(!_output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(BATCHPROCESSOR) << "Not possible to create output:" << _output.fileName() << _output.errorString();
+        return _summary;
+    }
+
+    _buffer.reserve(bufferSize + 256);
+    if(_options.format == Binary) {
+        _buffer.append(binaryMagic);
+        char recordSize[4];
+        qToLittleEndian<quint32>(binaryRecordSize, recordSize);
+        _buffer.append(recordSize, sizeof(recordSize));
+    } else {
+        _buffer.append("time_ns,distance_mm,confidence\n");
+    }
+
+    static constexpr Dispatch dispatch{{
+            &BatchProcessor::handleDistance,
+            &BatchProcessor::handleDistanceSimple,
+            &BatchProcessor::handleProfile,
+            &BatchProcessor::handlePing360DeviceData,
+        }};
+
+    // The parser lives in this thread, messages are handled synchronously while parsing each packet
+    PingParserExt parser;
+    QObject::connect(&parser, &Parser::newMessage, [this](const ping_message& msg) {
+        dispatch.call(this, msg, _messageStatistics);
+    });
+
+    const qint64 firstTimestamp = reader.size() ? reader.timestamp(0) : 0;
+    for(int i = 0; i < reader.size(); i++) {
+        _timestamp = reader.timestamp(i) - firstTimestamp;
+        const QByteArray packet = reader.packet(i);
+        _summary.bytes += packet.size();
+        parser.parseBuffer(packet);
+
+        if(_buffer.size() >= bufferSize && !flush()) {
+            return _summary;
+        }
+    }
+
+    if(!flush()) {
+        return _summary;
+    }
+    _output.close();
+
+    _summary.valid = true;
+    _summary.packets = reader.size();
+    _summary.startTime = reader.startTime() / 1000000;
+    _summary.durationNs = _timestamp;
+    _summary.messages = parser.parsed;
+    _summary.parseErrors = parser.errors;
+    if(_summary.samples) {
+        _summary.distanceMean = _distanceSum / _summary.samples;
+        _summary.confidenceMean = _confidenceSum / _summary.samples;
+    }
+    _summary.processingMs = timer.elapsed();
+    return _summary;
+}
+
+bool BatchProcessor::flush()
+{
+    if(_output.write(_buffer) != _buffer.size()) {
+        qCWarning(BATCHPROCESSOR) << "Failed to write output:" << _output.fileName() << _output.errorString();
+        return false;
+    }
+    _buffer.clear();
+    return true;
+}
+
+void BatchProcessor::addSample(quint32 distance, quint16 confidence)
+{
+    if(!_summary.samples) {
+        _summary.distanceMin = distance;
+        _summary.distanceMax = distance;
+    }
+    _summary.samples++;
+    _summary.distanceMin = qMin(_summary.distanceMin, distance);
+    _summary.distanceMax = qMax(_summary.distanceMax, distance);
+    _distanceSum += distance;
+    _confidenceSum += confidence;
+
+    if(_options.format == Binary) {
+        char record[binaryRecordSize] {};
+        qToLittleEndian<qint64>(_timestamp, record);
+        qToLittleEndian<quint32>(distance, record + 8);
+        qToLittleEndian<quint16>(confidence, record + 12);
+        _buffer.append(record, binaryRecordSize);
+    } else {
+        _buffer.append(QByteArray::number(_timestamp)).append(',')
+        .append(QByteArray::number(distance)).append(',')
+        .append(QByteArray::number(confidence)).append('\n');
+    }
+}
+
+void BatchProcessor::handleDistance(const ping_message& msg)
+{
+    const ping1d_distance m(msg);
+    addSample(m.distance(), m.confidence());
+}
+
+void BatchProcessor::handleDistanceSimple(const ping_message& msg)
+{
+    const ping1d_distance_simple m(msg);
+    addSample(m.distance(), m.confidence());
+}
+
+void BatchProcessor::handleProfile(const ping_message& msg)
+{
+    const ping1d_profile m(msg);
+    addSample(m.distance(), m.confidence());
+}
+
+void BatchProcessor::handlePing360DeviceData(const ping_message& msg)
+{
+    Q_UNUSED(msg)
+    _summary.profiles++;
+}
+
+QString BatchProcessor::Summary::csvHeader()
+{
+    return QStringLiteral("file,output,renamed,valid,start_time_ms,duration_s,packets,bytes,messages,parse_errors,"
+                          "samples,distance_min_mm,distance_mean_mm,distance_max_mm,confidence_mean,"
+                          "ping360_profiles,processing_ms");
+}
+
+QString BatchProcessor::Summary::toCsv() const
+{
+    return QStringLiteral("\"%1\",\"%2\",%3,%4,%5,%6,%7,%8,%9,%10,%11,%12,%13,%14,%15,%16,%17")
+           .arg(QString(fileName).replace('"', QStringLiteral("\"\"")))
+           .arg(QString(outputName).replace('"', QStringLiteral("\"\"")))
+           .arg(renamed ? 1 : 0)
+           .arg(valid ? 1 : 0)
+           .arg(startTime)
+           .arg(durationNs * 1e-9, 0, 'f', 3)
+           .arg(packets)
+           .arg(bytes)
+           .arg(messages)
+           .arg(parseErrors)
+           .arg(samples)
+           .arg(distanceMin)
+           .arg(distanceMean, 0, 'f', 1)
+           .arg(distanceMax)
+           .arg(confidenceMean, 0, 'f', 1)
+           .arg(profiles)
+           .arg(processingMs);
+}
+
+int BatchProcessor::run(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Process sensor logs without the graphical interface."));
+    parser.addHelpOption();
+    parser.addOptions({
+        {"batch", "Process sensor logs without the graphical interface."},
+        {"output", "Output folder, created if it does not exist.", "folder", "."},
+        {"format", "Time series format: csv or binary.", "format", "csv"},
+        {"threads", "Number of logs processed in parallel, all cores by default.", "threads", "0"},
+    });
+    parser.addPositionalArgument("logs", "Sensor log files or folders with logs (*.bin).", "logs...");
+    parser.process(arguments);
+
+    QTextStream out(stdout);
+    Options options;
+    options.outputDirectory = parser.value("output");
+    const QString format = parser.value("format");
+    if(format != QStringLiteral("csv") && format != QStringLiteral("binary")) {
+        out << "Invalid format: " << format << '\n';
+        return 2;
+    }
+    options.format = format == QStringLiteral("binary") ? Binary : Csv;
+
+    if(!QDir().mkpath(options.outputDirectory)) {
+        out << "Not possible to create output folder: " << options.outputDirectory << '\n';
+        return 2;
+    }
+
+    // Logs sorted by name and the input folder of each one
+    QMap<QString, QString> logRoots;
+    for(const auto& path : parser.positionalArguments()) {
+        if(!QFileInfo(path).isDir()) {
+            logRoots.insert(path, {});
+            continue;
+        }
+        QDirIterator iterator(path, {QStringLiteral("*.bin")}, QDir::Files, QDirIterator::Subdirectories);
+        while(iterator.hasNext()) {
+            logRoots.insert(iterator.next(), path);
+        }
+    }
+    if(logRoots.isEmpty()) {
+        parser.showHelp(2);
+    }
+    const QStringList logs = logRoots.keys();
+    const QStringList outputNames = BatchProcessor::outputNames(logs, logRoots.values());
+
+    // Workers have their own pool, log indexing runs in the global pool
+    QThreadPool pool;
+    const int threads = parser.value("threads").toInt();
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+    out << "Processing " << logs.size() << " logs with " << pool.maxThreadCount() << " threads." << '\n';
+
+    QVector<QFuture<Summary>> futures;
+    futures.reserve(logs.size());
+    for(int i = 0; i < logs.size(); i++) {
+        const QString log = logs[i];
+        const QString outputName = outputNames[i];
+        futures.append(QtConcurrent::run(&pool, [log, outputName, options] {
+            BatchProcessor processor(log, outputName, options);
+            return processor.process();
+        }));
+    }
+
+    QSaveFile summaryFile(QDir(options.outputDirectory).filePath(QStringLiteral("summary.csv")));
+    if(!summaryFile.open(QIODevice::WriteOnly)) {
+        out << "Not possible to create summary: " << summaryFile.errorString() << '\n';
+        return 2;
+    }
+    QTextStream summaryStream(&summaryFile);
+    summaryStream << Summary::csvHeader() << '\n';
+
+    int failed = 0;
+    for(int i = 0; i < futures.size(); i++) {
+        const Summary summary = futures[i].result();
+        summaryStream << summary.toCsv() << '\n';
+        failed += !summary.valid;
+        out << QStringLiteral("[%1/%2] %3: %4 samples, %5 ms%6%7")
+            .arg(i + 1).arg(futures.size()).arg(summary.fileName).arg(summary.samples).arg(summary.processingMs)
+            .arg(summary.renamed ? QStringLiteral(", name used by another log, output: %1").arg(summary.outputName)
+                 : QString())
+            .arg(summary.valid ? QString() : QStringLiteral(" (failed)")) << '\n';
+        out.flush();
+    }
+    summaryStream.flush();
+    if(!summaryFile.commit()) {
+        out << "Not possible to write summary: " << summaryFile.errorString() << '\n';
+        return 2;
+    }
+
+    return failed ? 1 : 0;
+}
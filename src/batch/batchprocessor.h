@@ -0,0 +1,165 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QString>
+#include <QStringList>
+
+#include "messagedispatchtable.h"
+#include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+
+Q_DECLARE_LOGGING_CATEGORY(BATCHPROCESSOR)
+
+/**
+ * @brief Process sensor logs without the graphical interface
+ *  Each log is decoded with SensorLogReader and PingParserExt, the depth and confidence of Ping1D messages
+ *  are written as a time series and a summary of all logs is written in summary.csv.
+ *  Logs are processed in parallel, one log per thread.
+ *  Outputs are named after the log, logs with the same name in different folders get unique names (check outputNames).
+ *
+ *  E.g: pingviewer --batch --output results --format binary Sensor_Log/
+ *
+ *  Binary time series, all values are little endian:
+ *      Header: "PINGDPT1", quint32 record size
+ *      Record: qint64 time in nanoseconds from the first packet, quint32 distance in mm, quint16 confidence in %,
+ *          quint16 reserved
+ */
+class BatchProcessor
+{
+public:
+    enum Format {
+        Csv,
+        Binary,
+    };
+
+    /**
+     * @brief Output configuration shared by all logs
+     *
+     */
+    struct Options {
+        QString outputDirectory = QStringLiteral(".");
+        Format format = Csv;
+    };
+
+    /**
+     * @brief Summary statistics of a single log
+     *
+     */
+    struct Summary {
+        QString fileName;
+        // Base name of the output files
+        QString outputName;
+        // Another log has the same name, the output name is not the log name
+        bool renamed = false;
+        bool valid = false;
+        // Log start in milliseconds since epoch, 0 if not available
+        qint64 startTime = 0;
+        qint64 durationNs = 0;
+        int packets = 0;
+        qint64 bytes = 0;
+        int messages = 0;
+        int parseErrors = 0;
+        // Number of depth samples
+        int samples = 0;
+        quint32 distanceMin = 0;
+        quint32 distanceMax = 0;
+        double distanceMean = 0;
+        double confidenceMean = 0;
+        // Ping360 profiles
+        int profiles = 0;
+        qint64 processingMs = 0;
+
+        /**
+         * @brief Return CSV header of toCsv
+         *
+         * @return QString
+         */
+        static QString csvHeader();
+
+        /**
+         * @brief Return summary as a CSV line
+         *
+         * @return QString
+         */
+        QString toCsv() const;
+    };
+
+    /**
+     * @brief Construct a new Batch Processor object for a single log
+     *
+     * @param fileName
+     * @param outputName base name of the output files, unique in the output folder (check outputNames)
+     * @param options
+     */
+    BatchProcessor(const QString& fileName, const QString& outputName, const Options& options);
+
+    /**
+     * @brief Decode the log and write its time series
+     *
+     * @return Summary
+     */
+    Summary process();
+
+    /**
+     * @brief Run batch command line interface
+     *
+     * @param arguments application arguments
+     * @return int exit code, 0 if all logs were processed
+     */
+    static int run(const QStringList& arguments);
+
+    /**
+     * @brief Return a unique output name for each log, logs with the same name would overwrite each other outputs
+     *  Logs with the same name use the path relative to their input folder (e.g. survey1_log),
+     *  a numeric suffix is added if the names still collide (e.g. log_2).
+     *
+     * @param logs log files
+     * @param roots input folder of each log, empty for logs that are not inside an input folder
+     * @return QStringList
+     */
+    static QStringList outputNames(const QStringList& logs, const QStringList& roots = {});
+
+private:
+    Q_DISABLE_COPY(BatchProcessor)
+
+    /**
+     * @brief Add a depth sample to the time series and summary
+     *
+     * @param distance mm
+     * @param confidence %
+     */
+    void addSample(quint32 distance, quint16 confidence);
+
+    /**
+     * @brief Write buffered time series in the output file
+     *
+     * @return true
+     * @return false
+     */
+    bool flush();
+
+    void handleDistance(const ping_message& msg);
+    void handleDistanceSimple(const ping_message& msg);
+    void handleProfile(const ping_message& msg);
+    void handlePing360DeviceData(const ping_message& msg);
+
+    using Dispatch = MessageDispatchTable<BatchProcessor,
+          Ping1dId::DISTANCE,
+          Ping1dId::DISTANCE_SIMPLE,
+          Ping1dId::PROFILE,
+          Ping360Id::DEVICE_DATA
+          >;
+    Dispatch::Statistics _messageStatistics;
+
+    Options _options;
+    Summary _summary;
+    QFile _output;
+    QByteArray _buffer;
+    // Time of the packet being parsed, from the first packet
+    qint64 _timestamp = 0;
+    double _distanceSum = 0;
+    double _confidenceSum = 0;
+};
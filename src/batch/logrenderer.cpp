@@ -0,0 +1,375 @@
+#include <cmath>
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtMath>
+
+#include "batchprocessor.h"
+#include "logger.h"
+#include "logrenderer.h"
+#include "parser-ping.h"
+#include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+#include "sensorlogreader.h"
+#include "waterfall.h"
+
+PING_LOGGING_CATEGORY(LOGRENDERER, "ping.logrenderer")
+
+LogRenderer::LogRenderer(const QString& fileName, const QString& outputName, const Options& options)
+    : _fileName(fileName)
+    , _baseName(outputName)
+    , _options(options)
+    , _colors(256)
+{
+    const WaterfallGradient gradient = Waterfall::gradient(_options.theme);
+    for(int i = 0; i < _colors.size(); i++) {
+        _colors[i] = gradient.isOk() ? gradient.getColor(i / 255.0f).rgb() : qRgb(i, i, i);
+    }
+    if(!gradient.isOk()) {
+        qCWarning(LOGRENDERER) << "Invalid theme:" << _options.theme << ", using grayscale.";
+    }
+}
+
+bool LogRenderer::forEachMessage(const std::function<void(const ping_message&)>& handler) const
+{
+    SensorLogReader reader;
+    if(!reader.open(_fileName)) {
+        qCWarning(LOGRENDERER) << "Not possible to open log:" << _fileName;
+        return false;
+    }
+    reader.waitForIndex();
+
+    PingParserExt parser;
+    QObject::connect(&parser, &Parser::newMessage, handler);
+    for(int i = 0; i < reader.size(); i++) {
+        parser.parseBuffer(reader.packet(i));
+    }
+    return reader.size() > 0;
+}
+
+LogRenderer::Profile LogRenderer::ping360Profile(const ping_message& msg, int* angle) const
+{
+    // The sample period is in 25 ns ticks, the range is half of the travelled distance
+    static const double samplePeriodTickDuration = 25e-9;
+
+    const ping360_device_data m(msg);
+    *angle = m.angle();
+
+    Profile profile;
+    profile.length = m.sample_period() * samplePeriodTickDuration * m.number_of_samples() * _options.speedOfSound / 2;
+    profile.samples = QByteArray(reinterpret_cast<const char*>(m.data()), m.data_length());
+    return profile;
+}
+
+bool LogRenderer::scan()
+{
+    const bool valid = forEachMessage([this](const ping_message& msg) {
+        switch(msg.message_id()) {
+        case Ping1dId::PROFILE: {
+            const ping1d_profile m(msg);
+            _ping1dProfiles++;
+            _maxRange = qMax(_maxRange, (m.scan_start() + m.scan_length()) / 1000.0f);
+            break;
+        }
+        case Ping360Id::DEVICE_DATA: {
+            int angle;
+            const Profile profile = ping360Profile(msg, &angle);
+            _ping360Profiles++;
+            _maxRange = qMax(_maxRange, profile.start + profile.length);
+            break;
+        }
+        default:
+            break;
+        }
+    });
+
+    qCDebug(LOGRENDERER) << _fileName << "Ping1D profiles:" << _ping1dProfiles << "Ping360 profiles:"
+                         << _ping360Profiles << "Maximum range:" << _maxRange;
+    return valid && (_ping1dProfiles || _ping360Profiles) && _maxRange > 0;
+}
+
+bool LogRenderer::render()
+{
+    if(!scan()) {
+        qCWarning(LOGRENDERER) << "Log has no profiles to render:" << _fileName;
+        return false;
+    }
+    return _ping1dProfiles >= _ping360Profiles ? renderWaterfall() : renderPolar();
+}
+
+bool LogRenderer::renderWaterfall()
+{
+    const int height = qCeil(_maxRange * _options.pixelsPerMeter);
+    const int profilesPerTile = qMax(1, _options.tileSize / _options.columnWidth);
+    const int tileRows = (height + _options.tileSize - 1) / _options.tileSize;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(_options.threads > 0 ? _options.threads : QThread::idealThreadCount());
+    // Limit the number of tiles waiting to be rendered, the log is parsed faster than tiles are rendered
+    QSemaphore pendingTiles(pool.maxThreadCount() * 2);
+
+    QVector<Profile> profiles;
+    profiles.reserve(profilesPerTile);
+    int tileColumn = 0;
+    const auto renderColumn = [&] {
+        const ProfileBatch batch(new QVector<Profile>(std::move(profiles)));
+        profiles = QVector<Profile>();
+        profiles.reserve(profilesPerTile);
+        const int x = tileColumn * profilesPerTile * _options.columnWidth;
+        for(int row = 0; row < tileRows; row++) {
+            pendingTiles.acquire();
+            QtConcurrent::run(&pool, [this, batch, row, x, tileColumn, &pendingTiles] {
+                saveTile(waterfallTile(*batch, row), QPoint(x, row * _options.tileSize), row, tileColumn);
+                pendingTiles.release();
+            });
+        }
+        tileColumn++;
+    };
+
+    forEachMessage([&](const ping_message& msg) {
+        if(msg.message_id() != Ping1dId::PROFILE) {
+            return;
+        }
+        const ping1d_profile m(msg);
+        Profile profile;
+        profile.start = m.scan_start() / 1000.0f;
+        profile.length = m.scan_length() / 1000.0f;
+        profile.samples = QByteArray(reinterpret_cast<const char*>(m.profile_data()), m.profile_data_length());
+        profiles.append(profile);
+        if(profiles.size() == profilesPerTile) {
+            renderColumn();
+        }
+    });
+    if(!profiles.isEmpty()) {
+        renderColumn();
+    }
+    pool.waitForDone();
+
+    return saveManifest(QStringLiteral("waterfall"), QSize(_ping1dProfiles * _options.columnWidth, height))
+           && !_failedTiles;
+}
+
+QImage LogRenderer::waterfallTile(const QVector<Profile>& profiles, int row) const
+{
+    const int top = row * _options.tileSize;
+    const int height = qMin(_options.tileSize, qCeil(_maxRange * _options.pixelsPerMeter) - top);
+    QImage tile(profiles.size() * _options.columnWidth, height, QImage::Format_ARGB32);
+    tile.fill(Qt::transparent);
+
+    for(int column = 0; column < profiles.size(); column++) {
+        const Profile& profile = profiles[column];
+        const int samples = profile.samples.size();
+        if(!samples || profile.length <= 0) {
+            continue;
+        }
+
+        const uchar* data = reinterpret_cast<const uchar*>(profile.samples.constData());
+        for(int y = 0; y < height; y++) {
+            const float depth = (top + y + 0.5f) / _options.pixelsPerMeter;
+            const int sample = std::floor((depth - profile.start) / profile.length * samples);
+            if(sample < 0 || sample >= samples) {
+                continue;
+            }
+            QRgb* line = reinterpret_cast<QRgb*>(tile.scanLine(y)) + column * _options.columnWidth;
+            std::fill(line, line + _options.columnWidth, _colors[data[sample]]);
+        }
+    }
+    return tile;
+}
+
+bool LogRenderer::renderPolar()
+{
+    _polarProfiles.fill(Profile(), _ping360AngleResolution);
+    forEachMessage([this](const ping_message& msg) {
+        if(msg.message_id() != Ping360Id::DEVICE_DATA) {
+            return;
+        }
+        int angle;
+        const Profile profile = ping360Profile(msg, &angle);
+        _polarProfiles[angle % _ping360AngleResolution] = profile;
+    });
+
+    // The sensor may skip angles (angular step > 1), fill them with the nearest profile
+    static const int maximumAngleGap = 10;
+    const QVector<Profile> measured = _polarProfiles;
+    for(int angle = 0; angle < _ping360AngleResolution; angle++) {
+        for(int gap = 1; gap <= maximumAngleGap && _polarProfiles[angle].samples.isEmpty(); gap++) {
+            for(const int neighbour : {angle - gap, angle + gap}) {
+                const Profile& profile = measured[(neighbour + _ping360AngleResolution) % _ping360AngleResolution];
+                if(!profile.samples.isEmpty()) {
+                    _polarProfiles[angle] = profile;
+                    break;
+                }
+            }
+        }
+    }
+
+    const int size = 2 * qCeil(_maxRange * _options.pixelsPerMeter);
+    const int tiles = (size + _options.tileSize - 1) / _options.tileSize;
+
+    // Profiles are only read from now on, tiles can be rendered in parallel
+    QThreadPool pool;
+    pool.setMaxThreadCount(_options.threads > 0 ? _options.threads : QThread::idealThreadCount());
+    for(int row = 0; row < tiles; row++) {
+        for(int column = 0; column < tiles; column++) {
+            const QRect area = QRect(column * _options.tileSize, row * _options.tileSize, _options.tileSize,
+                                     _options.tileSize).intersected(QRect(0, 0, size, size));
+            QtConcurrent::run(&pool, [this, area, row, column] {
+                saveTile(polarTile(area), area.topLeft(), row, column);
+            });
+        }
+    }
+    pool.waitForDone();
+
+    return saveManifest(QStringLiteral("polar"), QSize(size, size)) && !_failedTiles;
+}
+
+QImage LogRenderer::polarTile(const QRect& area) const
+{
+    QImage tile(area.size(), QImage::Format_ARGB32);
+    tile.fill(Qt::transparent);
+
+    // Angle zero is up and grows clockwise
+    const double center = qCeil(_maxRange * _options.pixelsPerMeter);
+    for(int y = 0; y < area.height(); y++) {
+        QRgb* line = reinterpret_cast<QRgb*>(tile.scanLine(y));
+        const double dy = (center - (area.y() + y + 0.5)) / _options.pixelsPerMeter;
+        for(int x = 0; x < area.width(); x++) {
+            const double dx = (area.x() + x + 0.5 - center) / _options.pixelsPerMeter;
+            double angle = std::atan2(dx, dy);
+            if(angle < 0) {
+                angle += 2 * M_PI;
+            }
+            const int bin = static_cast<int>(std::lround(angle / (2 * M_PI) * _ping360AngleResolution))
+                            % _ping360AngleResolution;
+            const Profile& profile = _polarProfiles[bin];
+            const int samples = profile.samples.size();
+            if(!samples || profile.length <= 0) {
+                continue;
+            }
+
+            const double distance = std::hypot(dx, dy);
+            const int sample = std::floor((distance - profile.start) / profile.length * samples);
+            if(sample < 0 || sample >= samples) {
+                continue;
+            }
+            line[x] = _colors[static_cast<uchar>(profile.samples[sample])];
+        }
+    }
+    return tile;
+}
+
+void LogRenderer::saveTile(const QImage& tile, const QPoint& position, int row, int column)
+{
+    const QString tileName = QStringLiteral("%1_%2_%3.png").arg(_baseName)
+                             .arg(row, 4, 10, QChar('0')).arg(column, 4, 10, QChar('0'));
+    if(!tile.save(QDir(_options.outputDirectory).filePath(tileName))) {
+        qCWarning(LOGRENDERER) << "Failed to save tile:" << tileName;
+        _failedTiles++;
+        return;
+    }
+
+    QMutexLocker locker(&_tilesMutex);
+    _tiles.append(QJsonObject{
+        {"file", tileName},
+        {"x", position.x()},
+        {"y", position.y()},
+        {"width", tile.width()},
+        {"height", tile.height()},
+    });
+}
+
+bool LogRenderer::saveManifest(const QString& type, const QSize& size) const
+{
+    QSaveFile manifestFile(QDir(_options.outputDirectory).filePath(_baseName + QStringLiteral("_tiles.json")));
+    if(!manifestFile.open(QIODevice::WriteOnly)) {
+        qCWarning(LOGRENDERER) << "Not possible to save manifest:" << manifestFile.fileName();
+        return false;
+    }
+
+    QMutexLocker locker(&_tilesMutex);
+    const QJsonObject manifest {
+        {"log", _fileName},
+        {"type", type},
+        {"width", size.width()},
+        {"height", size.height()},
+        {"tileSize", _options.tileSize},
+        {"pixelsPerMeter", _options.pixelsPerMeter},
+        {"maxRange", _maxRange},
+        {"tiles", _tiles},
+    };
+    manifestFile.write(QJsonDocument(manifest).toJson());
+    return manifestFile.commit();
+}
+
+int LogRenderer::run(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Render sensor logs to tiled images."));
+    parser.addHelpOption();
+    parser.addOptions({
+        {"render", "Render sensor logs without the graphical interface."},
+        {"output", "Output folder, created if it does not exist.", "folder", "."},
+        {"pixels-per-meter", "Image resolution.", "pixels", "100"},
+        {"tile-size", "Tile width and height in pixels.", "pixels", "2048"},
+        {"column-width", "Width of each Ping1D profile in pixels.", "pixels", "1"},
+        {"speed-of-sound", "Ping360 speed of sound in m/s.", "speed", "1500"},
+        {"theme", "Waterfall theme.", "theme", "Thermal blue"},
+        {"threads", "Number of tiles rendered in parallel, all cores by default.", "threads", "0"},
+    });
+    parser.addPositionalArgument("logs", "Sensor log files.", "logs...");
+    parser.process(arguments);
+
+    QTextStream out(stdout);
+    Options options;
+    options.outputDirectory = parser.value("output");
+    options.pixelsPerMeter = parser.value("pixels-per-meter").toDouble();
+    options.tileSize = parser.value("tile-size").toInt();
+    options.columnWidth = parser.value("column-width").toInt();
+    options.speedOfSound = parser.value("speed-of-sound").toDouble();
+    options.theme = parser.value("theme");
+    options.threads = parser.value("threads").toInt();
+
+    if(options.pixelsPerMeter <= 0 || options.tileSize < 64 || options.columnWidth < 1
+            || options.columnWidth > options.tileSize || options.speedOfSound <= 0) {
+        out << "Invalid render options.\n";
+        return 2;
+    }
+    if(parser.positionalArguments().isEmpty()) {
+        parser.showHelp(2);
+    }
+    if(!QDir().mkpath(options.outputDirectory)) {
+        out << "Not possible to create output folder: " << options.outputDirectory << '\n';
+        return 2;
+    }
+
+    // Logs with the same name would overwrite each other tiles and manifest
+    const QStringList logs = parser.positionalArguments();
+    const QStringList outputNames = BatchProcessor::outputNames(logs);
+
+    int failed = 0;
+    for(int i = 0; i < logs.size(); i++) {
+        QElapsedTimer timer;
+        timer.start();
+        LogRenderer renderer(logs[i], outputNames[i], options);
+        const bool rendered = renderer.render();
+        failed += !rendered;
+        out << logs[i] << (rendered ? ": rendered in " : ": failed after ") << timer.elapsed() << " ms";
+        if(outputNames[i] != QFileInfo(logs[i]).completeBaseName()) {
+            out << ", name used by another log, output: " << outputNames[i];
+        }
+        out << '\n';
+        out.flush();
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include <QByteArray>
+#include <QImage>
+#include <QJsonArray>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QRgb>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "ping-message.h"
+
+Q_DECLARE_LOGGING_CATEGORY(LOGRENDERER)
+
+/**
+ * @brief Render a sensor log to a tiled image, without the graphical interface
+ *  Ping1D logs are rendered as a waterfall with one column per profile and depth in y,
+ *  Ping360 logs are rendered as a polar mosaic with the last profile of each angle.
+ *  The image is split in square tiles rendered in parallel and saved as PNG files when finished,
+ *  only the tiles being rendered are kept in memory. A JSON manifest has the position of each tile.
+ *
+ *  E.g: pingviewer --render --pixels-per-meter 200 --output render log.bin
+ */
+class LogRenderer
+{
+public:
+    /**
+     * @brief Render configuration
+     *
+     */
+    struct Options {
+        QString outputDirectory = QStringLiteral(".");
+        double pixelsPerMeter = 100;
+        int tileSize = 2048;
+        // Waterfall column width in pixels
+        int columnWidth = 1;
+        // Ping360 speed of sound in m/s
+        double speedOfSound = 1500;
+        QString theme = QStringLiteral("Thermal blue");
+        int threads = 0;
+    };
+
+    /**
+     * @brief Construct a new Log Renderer object
+     *
+     * @param fileName
+     * @param outputName base name of the tiles and manifest, unique in the output folder
+     *  (check BatchProcessor::outputNames)
+     * @param options
+     */
+    LogRenderer(const QString& fileName, const QString& outputName, const Options& options);
+
+    /**
+     * @brief Render log tiles and manifest
+     *
+     * @return true
+     * @return false
+     */
+    bool render();
+
+    /**
+     * @brief Run render command line interface
+     *
+     * @param arguments application arguments
+     * @return int exit code, 0 if all logs were rendered
+     */
+    static int run(const QStringList& arguments);
+
+private:
+    Q_DISABLE_COPY(LogRenderer)
+
+    /**
+     * @brief Ping1D profile or Ping360 device data, with range in meters
+     *
+     */
+    struct Profile {
+        float start = 0;
+        float length = 0;
+        QByteArray samples;
+    };
+    using ProfileBatch = QSharedPointer<const QVector<Profile>>;
+
+    /**
+     * @brief Parse all messages of the log
+     *
+     * @param handler called for each message
+     * @return true
+     * @return false log is not valid
+     */
+    bool forEachMessage(const std::function<void(const ping_message&)>& handler) const;
+
+    /**
+     * @brief Find sensor type and maximum range
+     *
+     * @return true
+     * @return false log has no profiles
+     */
+    bool scan();
+
+    /**
+     * @brief Return Ping360 profile, in meters
+     *
+     * @param msg device data message
+     * @param angle gradians
+     * @return Profile
+     */
+    Profile ping360Profile(const ping_message& msg, int* angle) const;
+
+    bool renderWaterfall();
+    bool renderPolar();
+
+    /**
+     * @brief Render a waterfall tile
+     *
+     * @param profiles profiles of the tile column
+     * @param row tile row
+     * @return QImage
+     */
+    QImage waterfallTile(const QVector<Profile>& profiles, int row) const;
+
+    /**
+     * @brief Render a polar tile
+     *
+     * @param area tile area in the mosaic
+     * @return QImage
+     */
+    QImage polarTile(const QRect& area) const;
+
+    /**
+     * @brief Save tile and add it to the manifest, thread safe
+     *
+     * @param tile
+     * @param position top left corner in the mosaic
+     * @param row
+     * @param column
+     */
+    void saveTile(const QImage& tile, const QPoint& position, int row, int column);
+
+    /**
+     * @brief Save manifest with all tiles
+     *
+     * @param type waterfall or polar
+     * @param size mosaic size
+     * @return true
+     * @return false
+     */
+    bool saveManifest(const QString& type, const QSize& size) const;
+
+    QString _fileName;
+    QString _baseName;
+    Options _options;
+    QVector<QRgb> _colors;
+
+    int _ping1dProfiles = 0;
+    int _ping360Profiles = 0;
+    // Maximum range of all profiles in meters
+    float _maxRange = 0;
+
+    // Last Ping360 profile of each angle
+    QVector<Profile> _polarProfiles;
+
+    mutable QMutex _tilesMutex;
+    QJsonArray _tiles;
+    std::atomic<int> _failedTiles{0};
+
+    static const int _ping360AngleResolution = 400;
+};
@@ -0,0 +1,18 @@
+message(Configuring benchmark build...)
+
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/*.h
+
+SOURCES += \
+    $$PWD/*.cpp
+
+# libFuzzer build: qmake CONFIG+=benchmark CONFIG+=fuzz, compiled with clang
+# The fuzzer runtime provides the main function, the benchmark main is disabled
+fuzz {
+    message(Configuring libFuzzer harness...)
+    DEFINES += PING_VIEWER_LIBFUZZER
+    QMAKE_CXXFLAGS += -fsanitize=fuzzer,address,undefined
+    QMAKE_LFLAGS += -fsanitize=fuzzer,address,undefined
+}
@@ -0,0 +1,181 @@
+#ifndef PING_VIEWER_LIBFUZZER
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLoggingCategory>
+#include <QSysInfo>
+#include <QTextStream>
+
+#include "parserbenchmark.h"
+#include "pipelinebenchmark.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+/**
+ * @brief Run the fuzzer harness over a file or all files of a directory (AFL style: --fuzz @@)
+ *
+ * @param path
+ * @return int number of inputs
+ */
+int runFuzzInputs(const QString& path)
+{
+    QStringList files;
+    const QFileInfo info(path);
+    if(info.isDir()) {
+        for(const auto& entry : QDir(path).entryInfoList(QDir::Files)) {
+            files.append(entry.absoluteFilePath());
+        }
+    } else {
+        files.append(path);
+    }
+
+    for(const auto& fileName : files) {
+        QFile file(fileName);
+        if(!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        const QByteArray input = file.readAll();
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.constData()), input.size());
+    }
+    return files.size();
+}
+
+/**
+ * @brief Write the json report in the output file or stdout
+ *
+ * @param parser
+ * @param report
+ * @return int exit code
+ */
+int writeReport(const QCommandLineParser& parser, const QJsonObject& report)
+{
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    if(parser.isSet("output")) {
+        QFile file(parser.value("output"));
+        if(!file.open(QIODevice::WriteOnly)) {
+            QTextStream(stderr) << "Not possible to write: " << file.fileName() << endl;
+            return 1;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    return 0;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    // Plots are painted offscreen, no display is necessary
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("Ping Viewer Benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Protocol parser benchmark and fuzzer harness.");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"log", "Replay a Sensor_Log file, can be used multiple times.", "file"},
+        {"iterations", "Number of iterations for each benchmark.", "number", "10"},
+        {"messages", "Number of messages in the synthetic streams.", "number", "10000"},
+        {"output", "Write the json result to file instead of stdout.", "file"},
+        {"fuzz", "Run the fuzzer harness over a file or directory and exit.", "path"},
+        {"pipeline", "Run the end to end pipeline benchmark (link, parser, sensor and plots) instead."},
+        {"duration", "Duration of each pipeline run in milliseconds.", "ms", "10000"},
+        {"rate", "Messages per second of the simulated pipeline links.", "number", "5000"},
+        {"sensor", "Sensor of the logs in the pipeline benchmark: ping1d or ping360.", "type", "ping1d"},
+    });
+    parser.process(app);
+
+    if(parser.isSet("fuzz")) {
+        runFuzzInputs(parser.value("fuzz"));
+        return 0;
+    }
+
+    // Parsing errors are part of the benchmark, do not measure the logging
+    QLoggingCategory::setFilterRules(QStringLiteral("ping.*=false"));
+
+    const int iterations = qMax(1, parser.value("iterations").toInt());
+    const int messages = qMax(1, parser.value("messages").toInt());
+    static const quint32 seed = 42;
+
+    QJsonArray results;
+    if(parser.isSet("pipeline")) {
+        const int duration = qMax(1, parser.value("duration").toInt());
+        const QString rate = QStringLiteral("rate=%1").arg(qMax(1, parser.value("rate").toInt()));
+        const QString seedArgument = QStringLiteral("seed=%1").arg(seed);
+        results.append(PipelineBenchmark::run("pipeline.simulation.ping1d",
+            {LinkType::Ping1DSimulation, {rate, seedArgument}}, PipelineBenchmark::Ping1D, duration));
+        results.append(PipelineBenchmark::run("pipeline.simulation.ping360",
+            {LinkType::Ping360Simulation, {rate, seedArgument}}, PipelineBenchmark::Ping360, duration));
+
+        const auto sensorType = parser.value("sensor") == QLatin1String("ping360") ? PipelineBenchmark::Ping360
+                                : PipelineBenchmark::Ping1D;
+        for(const auto& log : parser.values("log")) {
+            results.append(PipelineBenchmark::run("pipeline.log." + QFileInfo(log).fileName(),
+                {LinkType::File, {log, QStringLiteral("r")}}, sensorType, duration));
+        }
+
+        return writeReport(parser, {
+            {"benchmark", "pipeline"},
+            {"git_version", GIT_VERSION},
+            {"cpu", QSysInfo::currentCpuArchitecture()},
+            {"platform", QGuiApplication::platformName()},
+            {"results", results},
+            {"peak_rss_bytes", PipelineBenchmark::peakRss()},
+        });
+    }
+
+    const QByteArray clean = ParserBenchmark::syntheticStream(messages, seed);
+    const QList<QPair<QString, ParserBenchmark::Corruption>> corruptions {
+        {"clean", ParserBenchmark::None},
+        {"bitflip", ParserBenchmark::BitFlip},
+        {"truncation", ParserBenchmark::Truncation},
+        {"noise", ParserBenchmark::Noise},
+    };
+    for(const auto& corruption : corruptions) {
+        const QByteArray data = ParserBenchmark::corrupt(clean, corruption.second, seed);
+        results.append(ParserBenchmark::parser("parser.synthetic." + corruption.first, data, iterations).toJson());
+        // Byte by byte path, it'll find a device in the first message
+        results.append(ParserBenchmark::protocolDetector("protocoldetector.synthetic." + corruption.first, data,
+                       iterations).toJson());
+    }
+
+    for(const auto& log : parser.values("log")) {
+        const QByteArray data = ParserBenchmark::readSensorLog(log);
+        if(data.isEmpty()) {
+            continue;
+        }
+        results.append(ParserBenchmark::parser("parser.log." + QFileInfo(log).fileName(), data, iterations).toJson());
+    }
+
+    results.append(ParserBenchmark::hexValidator(messages, iterations).toJson());
+
+    // Ping1D profile and Ping360 device data sizes
+    for(const int length : {210, 1224}) {
+        for(const auto& result : ParserBenchmark::checksum(length, messages * iterations)) {
+            results.append(result);
+        }
+    }
+
+    return writeReport(parser, {
+        {"benchmark", "parser"},
+        {"git_version", GIT_VERSION},
+        {"cpu", QSysInfo::currentCpuArchitecture()},
+        {"iterations", iterations},
+        {"results", results},
+    });
+}
+
+#endif
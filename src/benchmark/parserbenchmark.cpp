@@ -0,0 +1,308 @@
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include <ping-message-common.h>
+#include <ping-message-ping1d.h>
+#include <ping-message-ping360.h>
+
+#include "hexvalidator.h"
+#include "linkconfiguration.h"
+#include "parser-ping.h"
+#include "parserbenchmark.h"
+#include "pingchecksum.h"
+#include "protocoldetector.h"
+#include "sensorlogreader.h"
+
+namespace {
+// Avoid the compiler removing the benchmark loops
+volatile int sink = 0;
+
+QByteArray toByteArray(const ping_message& message)
+{
+    return QByteArray(reinterpret_cast<const char*>(message.msgData), message.msgDataLength());
+}
+}
+
+QJsonObject ParserBenchmark::Result::toJson() const
+{
+    const double seconds = nanoseconds / 1e9;
+    return {
+        {"name", name},
+        {"bytes", bytes},
+        {"messages", messages},
+        {"errors", errors},
+        {"seconds", seconds},
+        {"mb_per_s", seconds > 0 ? bytes / seconds / 1e6 : 0.0},
+        {"messages_per_s", seconds > 0 ? messages / seconds : 0.0},
+    };
+}
+
+QByteArray ParserBenchmark::syntheticStream(int messages, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    QByteArray stream;
+
+    static const int ping1dSamples = 200;
+    static const int ping360Samples = 1200;
+    ping1d_profile profile(ping1dSamples);
+    ping360_device_data deviceData(ping360Samples);
+    common_device_information deviceInformation;
+
+    for(int i = 0; i < messages; i++) {
+        // Mostly profiles, as in a real sensor stream
+        switch(i % 8) {
+        case 0:
+            deviceInformation.set_device_type(random.bounded(3));
+            deviceInformation.set_firmware_version_major(random.bounded(4));
+            deviceInformation.updateChecksum();
+            stream.append(toByteArray(deviceInformation));
+            break;
+        case 1:
+        case 2:
+        case 3:
+            deviceData.set_angle(i % 400);
+            deviceData.set_number_of_samples(ping360Samples);
+            deviceData.set_data_length(ping360Samples);
+            for(int sample = 0; sample < ping360Samples; sample++) {
+                deviceData.set_data_at(sample, random.bounded(256));
+            }
+            deviceData.updateChecksum();
+            stream.append(toByteArray(deviceData));
+            break;
+        default:
+            profile.set_distance(random.bounded(50000));
+            profile.set_ping_number(i);
+            profile.set_profile_data_length(ping1dSamples);
+            for(int sample = 0; sample < ping1dSamples; sample++) {
+                profile.set_profile_data_at(sample, random.bounded(256));
+            }
+            profile.updateChecksum();
+            stream.append(toByteArray(profile));
+            break;
+        }
+    }
+
+    return stream;
+}
+
+QByteArray ParserBenchmark::corrupt(const QByteArray& data, Corruption corruption, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    QByteArray corrupted;
+    corrupted.reserve(data.size());
+
+    switch(corruption) {
+    case None:
+        return data;
+
+    case BitFlip:
+        // One flipped bit in each 1kB, in average
+        corrupted = data;
+        for(int i = 0; i < corrupted.size(); i++) {
+            if(random.bounded(1024) == 0) {
+                corrupted[i] = corrupted[i] ^ (1 << random.bounded(8));
+            }
+        }
+        return corrupted;
+
+    case Truncation:
+        // Drop random spans of the stream, like lost serial chunks
+        for(int i = 0; i < data.size();) {
+            const int span = 1 + random.bounded(2048);
+            if(random.bounded(8) != 0) {
+                corrupted.append(data.mid(i, span));
+            }
+            i += span;
+        }
+        return corrupted;
+
+    case Noise:
+        // Garbage between messages and sometimes a fake start sequence
+        for(int i = 0; i < data.size();) {
+            const int span = 1 + random.bounded(1024);
+            corrupted.append(data.mid(i, span));
+            const int noise = random.bounded(64);
+            for(int n = 0; n < noise; n++) {
+                corrupted.append(static_cast<char>(random.bounded(256)));
+            }
+            if(random.bounded(4) == 0) {
+                corrupted.append("BR", 2);
+            }
+            i += span;
+        }
+        return corrupted;
+    }
+
+    return data;
+}
+
+QByteArray ParserBenchmark::readSensorLog(const QString& fileName)
+{
+    SensorLogReader reader;
+    if(!reader.open(fileName)) {
+        return {};
+    }
+    reader.waitForIndex();
+
+    QByteArray link;
+    for(int i = 0; i < reader.size(); i++) {
+        link.append(reader.packet(i));
+    }
+    return link;
+}
+
+ParserBenchmark::Result ParserBenchmark::parser(const QString& name, const QByteArray& data, int iterations,
+        int chunkSize)
+{
+    Result result;
+    result.name = name;
+
+    QElapsedTimer timer;
+    for(int iteration = 0; iteration < iterations; iteration++) {
+        PingParserExt parser;
+        timer.start();
+        for(int i = 0; i < data.size(); i += chunkSize) {
+            parser.parseBuffer(QByteArray::fromRawData(data.constData() + i, qMin(chunkSize, data.size() - i)));
+        }
+        result.nanoseconds += timer.nsecsElapsed();
+        result.messages += parser.parsed;
+        result.errors += parser.errors;
+        result.bytes += data.size();
+    }
+
+    return result;
+}
+
+ParserBenchmark::Result ParserBenchmark::protocolDetector(const QString& name, const QByteArray& data, int iterations,
+        int chunkSize)
+{
+    Result result;
+    result.name = name;
+
+    ProtocolDetector detector;
+    LinkConfiguration linkConf;
+    QElapsedTimer timer;
+    for(int iteration = 0; iteration < iterations; iteration++) {
+        detector._parser.clearBuffer();
+        timer.start();
+        for(int i = 0; i < data.size(); i += chunkSize) {
+            if(detector.checkBuffer(QByteArray::fromRawData(data.constData() + i, qMin(chunkSize, data.size() - i)),
+                                    linkConf)) {
+                result.messages++;
+            }
+        }
+        result.nanoseconds += timer.nsecsElapsed();
+        result.bytes += data.size();
+    }
+
+    return result;
+}
+
+ParserBenchmark::Result ParserBenchmark::hexValidator(int lines, int iterations)
+{
+    Result result;
+    result.name = QStringLiteral("hexvalidator.synthetic");
+
+    // 16 bytes data records with a valid checksum
+    QRandomGenerator random(lines);
+    QList<QByteArray> hexLines;
+    for(int line = 0; line < lines; line++) {
+        QByteArray bytes;
+        bytes.append(static_cast<char>(16));
+        bytes.append(static_cast<char>((line * 16) >> 8));
+        bytes.append(static_cast<char>(line * 16));
+        bytes.append(static_cast<char>(0));
+        for(int i = 0; i < 16; i++) {
+            bytes.append(static_cast<char>(random.bounded(256)));
+        }
+        uint8_t checksum = 0;
+        for(const auto byte : bytes) {
+            checksum += static_cast<uint8_t>(byte);
+        }
+        bytes.append(static_cast<char>(~checksum + 1));
+        hexLines.append(':' + bytes.toHex().toUpper());
+    }
+
+    QElapsedTimer timer;
+    for(int iteration = 0; iteration < iterations; iteration++) {
+        timer.start();
+        for(const auto& line : hexLines) {
+            if(HexValidator::check(line)) {
+                result.messages++;
+            } else {
+                result.errors++;
+            }
+            result.bytes += line.size();
+        }
+        result.nanoseconds += timer.nsecsElapsed();
+    }
+
+    return result;
+}
+
+QJsonArray ParserBenchmark::checksum(int length, int iterations)
+{
+    QRandomGenerator random(length);
+    QByteArray data(length, 0);
+    for(auto& byte : data) {
+        byte = static_cast<char>(random.bounded(256));
+    }
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.constData());
+
+    auto run = [&](const QString& name, uint16_t(*function)(const uint8_t*, int)) {
+        Result result;
+        result.name = name;
+        QElapsedTimer timer;
+        timer.start();
+        for(int iteration = 0; iteration < iterations; iteration++) {
+            sink = sink + function(bytes, length);
+        }
+        result.nanoseconds = timer.nsecsElapsed();
+        result.bytes = qint64(length) * iterations;
+        result.messages = iterations;
+        return result.toJson();
+    };
+
+    return {
+        run(QStringLiteral("checksum.%1.%2").arg(PingChecksum::implementation()).arg(length), PingChecksum::calculate),
+        run(QStringLiteral("checksum.scalar.%1").arg(length), PingChecksum::calculateScalar),
+    };
+}
+
+void ParserBenchmark::fuzzOne(const uint8_t* data, size_t size)
+{
+    if(size < 1) {
+        return;
+    }
+
+    const int chunkSize = 1 + data[0];
+    const QByteArray input = QByteArray::fromRawData(reinterpret_cast<const char*>(data + 1), size - 1);
+
+    if(PingChecksum::calculate(data, size) != PingChecksum::calculateScalar(data, size)) {
+        qFatal("Checksum %s differs from scalar checksum", PingChecksum::implementation());
+    }
+
+    // Asynchronous parser path, check that every message is consistent
+    PingParserExt parser;
+    QObject::connect(&parser, &Parser::newMessage, [](const ping_message& message) {
+        // The fuzz oracle must run in release builds, where Q_ASSERT is compiled out
+        if(message.msgDataLength() != message.payload_length() + 10) {
+            qFatal("Parsed message %d has inconsistent length: %d", message.message_id(), message.msgDataLength());
+        }
+        sink = sink + message.message_id();
+    });
+    for(int i = 0; i < input.size(); i += chunkSize) {
+        parser.parseBuffer(input.mid(i, chunkSize));
+    }
+
+    // Synchronous parser path used by the protocol detector
+    static ProtocolDetector detector;
+    LinkConfiguration linkConf;
+    detector._parser.clearBuffer();
+    detector.checkBuffer(input, linkConf);
+
+    // Each line of the input as a hex file line
+    for(const auto& line : input.split('\n')) {
+        sink = sink + HexValidator::check(line.trimmed());
+    }
+}
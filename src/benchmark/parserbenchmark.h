@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * @brief Throughput benchmark and fuzzing entry points for the protocol parsing path
+ *  Covers PingParserExt, HexValidator and ProtocolDetector::checkBuffer
+ *
+ */
+class ParserBenchmark
+{
+public:
+    /**
+     * @brief Corruption patterns applied over synthetic streams
+     *
+     */
+    enum Corruption {
+        None,
+        BitFlip,
+        Truncation,
+        Noise,
+    };
+
+    /**
+     * @brief Result of a single benchmark run
+     *
+     */
+    struct Result {
+        QString name;
+        qint64 bytes = 0;
+        qint64 messages = 0;
+        qint64 errors = 0;
+        qint64 nanoseconds = 0;
+
+        /**
+         * @brief Return the result as a json object, with MB/s and messages/s
+         *
+         * @return QJsonObject
+         */
+        QJsonObject toJson() const;
+    };
+
+    ParserBenchmark() = delete;
+    ~ParserBenchmark() = delete;
+
+    /**
+     * @brief Create a stream with Ping1D profiles, Ping360 device data and common messages
+     *
+     * @param messages number of messages in the stream
+     * @param seed random seed, the same seed always returns the same stream
+     * @return QByteArray
+     */
+    static QByteArray syntheticStream(int messages, quint32 seed);
+
+    /**
+     * @brief Return a corrupted copy of data
+     *
+     * @param data
+     * @param corruption
+     * @param seed
+     * @return QByteArray
+     */
+    static QByteArray corrupt(const QByteArray& data, Corruption corruption, quint32 seed);
+
+    /**
+     * @brief Return the link data of a Sensor_Log file, concatenated
+     *
+     * @param fileName
+     * @return QByteArray empty if the file can't be read
+     */
+    static QByteArray readSensorLog(const QString& fileName);
+
+    /**
+     * @brief Feed data to PingParserExt::parseBuffer in chunks of chunkSize
+     *
+     * @param name
+     * @param data
+     * @param iterations
+     * @param chunkSize
+     * @return Result
+     */
+    static Result parser(const QString& name, const QByteArray& data, int iterations, int chunkSize = 4096);
+
+    /**
+     * @brief Run ProtocolDetector::checkBuffer over data in chunks of chunkSize
+     *
+     * @param name
+     * @param data
+     * @param iterations
+     * @param chunkSize
+     * @return Result
+     */
+    static Result protocolDetector(const QString& name, const QByteArray& data, int iterations, int chunkSize = 4096);
+
+    /**
+     * @brief Run HexValidator::check over a synthetic Intel Hex file
+     *
+     * @param lines number of lines
+     * @param iterations
+     * @return Result
+     */
+    static Result hexValidator(int lines, int iterations);
+
+    /**
+     * @brief Compare PingChecksum::calculate against the scalar version over messages of size length
+     *
+     * @param length
+     * @param iterations
+     * @return QJsonArray results for the vectorized and scalar versions
+     */
+    static QJsonArray checksum(int length, int iterations);
+
+    /**
+     * @brief Run a single fuzzing input over all parsing paths
+     *  The first byte selects the chunk size used to split the input
+     *
+     * @param data
+     * @param size
+     */
+    static void fuzzOne(const uint8_t* data, size_t size);
+};
@@ -0,0 +1,24 @@
+#include <QCoreApplication>
+#include <QLoggingCategory>
+
+#include "parserbenchmark.h"
+
+/**
+ * @brief libFuzzer entry point, also used by the AFL style harness (--fuzz)
+ *
+ * @param data
+ * @param size
+ * @return int
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    static bool initialized = false;
+    if(!initialized) {
+        // Parsing errors are expected and logging would dominate the run time
+        QLoggingCategory::setFilterRules(QStringLiteral("*=false"));
+        initialized = true;
+    }
+
+    ParserBenchmark::fuzzOne(data, size);
+    return 0;
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QImage>
+#include <QPainter>
+#include <QQueue>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include <ping-message-ping1d.h>
+#include <ping-message-ping360.h>
+
+#include "parser.h"
+#include "ping.h"
+#include "ping360.h"
+#include "pipelinebenchmark.h"
+#include "polarplot.h"
+#include "waterfallplot.h"
+
+namespace {
+/**
+ * @brief Timestamps of a profile in the pipeline, nanoseconds since the start of the run
+ *
+ */
+struct ProfileTimes {
+    qint64 received;
+    qint64 parsed;
+};
+}
+
+QJsonObject PipelineBenchmark::Stage::toJson() const
+{
+    if(samples.isEmpty()) {
+        return {{"count", 0}};
+    }
+
+    QVector<qint64> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    const auto percentile = [&sorted](double fraction) {
+        const int index = qBound(0, static_cast<int>(std::ceil(fraction * sorted.size())) - 1, sorted.size() - 1);
+        return sorted[index] / 1e3;
+    };
+
+    double sum = 0;
+    for(const auto sample : sorted) {
+        sum += sample;
+    }
+
+    return {
+        {"count", sorted.size()},
+        {"mean_us", sum / sorted.size() / 1e3},
+        {"p50_us", percentile(0.5)},
+        {"p90_us", percentile(0.9)},
+        {"p99_us", percentile(0.99)},
+        {"max_us", sorted.last() / 1e3},
+    };
+}
+
+QJsonObject PipelineBenchmark::run(const QString& name, const LinkConfiguration& linkConfiguration,
+                                   SensorType sensorType, int durationMs, const QSize& viewport)
+{
+    // Logs of simulated links are part of the pipeline, they are written in a temporary folder
+    QTemporaryDir logDir;
+    const LinkConfiguration logConfiguration{LinkType::File, {logDir.filePath("pipeline.bin"), QStringLiteral("w")}};
+
+    QScopedPointer<PingSensor> sensor;
+    QScopedPointer<Waterfall> plot;
+    if(sensorType == Ping360) {
+        sensor.reset(new ::Ping360());
+        plot.reset(new PolarPlot());
+    } else {
+        sensor.reset(new Ping());
+        plot.reset(new WaterfallPlot());
+    }
+    plot->setSize(viewport);
+    QImage target(viewport, QImage::Format_RGBA8888);
+
+    QElapsedTimer clock;
+    clock.start();
+
+    Stage parse;
+    Stage sensorStage;
+    Stage draw;
+    Stage total;
+    Stage paint;
+    qint64 bytes = 0;
+    qint64 buffers = 0;
+    qint64 messages = 0;
+    qint64 drawn = 0;
+    qint64 lastReceived = 0;
+    qint64 lastPaint = -paintIntervalMs * 1000000LL;
+    QQueue<ProfileTimes> pending;
+    QList<QMetaObject::Connection> connections;
+
+    // This sink is added before the parser, it runs when the link delivers the buffer
+    const int sink = sensor->linkTee()->addSink(QStringLiteral("benchmark"), sensor.data(), [&](const QByteArray& data) {
+        lastReceived = clock.nsecsElapsed();
+        bytes += data.size();
+        buffers++;
+    }, 0);
+
+    connections << QObject::connect(sensor->parser(), &Parser::newMessage, sensor.data(), [&](const ping_message& message) {
+        messages++;
+        if(message.message_id() != Ping1dId::PROFILE && message.message_id() != Ping360Id::DEVICE_DATA) {
+            return;
+        }
+        const qint64 now = clock.nsecsElapsed();
+        parse.samples.append(now - lastReceived);
+        pending.enqueue({lastReceived, now});
+    });
+
+    const auto drawProfile = [&](const std::function<void()>& function) {
+        if(pending.isEmpty()) {
+            return;
+        }
+        const ProfileTimes times = pending.dequeue();
+        const qint64 updated = clock.nsecsElapsed();
+        sensorStage.samples.append(updated - times.parsed);
+
+        function();
+        const qint64 drawnTime = clock.nsecsElapsed();
+        draw.samples.append(drawnTime - updated);
+        total.samples.append(drawnTime - times.received);
+        drawn++;
+
+        if(drawnTime - lastPaint >= paintIntervalMs * 1000000LL) {
+            QPainter painter(&target);
+            plot->paint(&painter);
+            painter.end();
+            lastPaint = clock.nsecsElapsed();
+            paint.samples.append(lastPaint - drawnTime);
+        }
+    };
+
+    if(sensorType == Ping360) {
+        auto ping360 = static_cast<::Ping360*>(sensor.data());
+        auto polarPlot = static_cast<PolarPlot*>(plot.data());
+        connections << QObject::connect(ping360, &::Ping360::dataChanged, ping360, [&drawProfile, ping360, polarPlot] {
+            drawProfile([ping360, polarPlot] {
+                polarPlot->draw(ping360->profile(), ping360->angle(), 0, ping360->range(), ping360->angular_speed(),
+                                ping360->sectorSize());
+                // Profiles are drawn by the frame queue, draw them now to time each one
+                polarPlot->flush();
+            });
+        });
+    } else {
+        auto ping = static_cast<Ping*>(sensor.data());
+        auto waterfallPlot = static_cast<WaterfallPlot*>(plot.data());
+        connections << QObject::connect(ping, &Ping::profileReceived, ping,
+        [&drawProfile, ping, waterfallPlot](int confidence, int start_mm, int length_mm, int distance) {
+            drawProfile([=] {
+                waterfallPlot->draw(ping->profile(), confidence, start_mm * 1e-3, length_mm * 1e-3, distance * 1e-3);
+                waterfallPlot->flush();
+            });
+        });
+    }
+
+    const qint64 start = clock.nsecsElapsed();
+    sensor->connectLink(linkConfiguration, logConfiguration);
+    if(!sensor->link() || !sensor->link()->isOpen()) {
+        sensor->linkTee()->removeSink(sink);
+        for(const auto& connection : connections) {
+            QObject::disconnect(connection);
+        }
+        return {{"name", name}, {"error", QStringLiteral("Link is not available")}};
+    }
+    // Logs are replayed as fast as possible
+    sensor->link()->setReplayRate(0);
+
+    QEventLoop loop;
+    QTimer durationTimer;
+    durationTimer.setSingleShot(true);
+    QObject::connect(&durationTimer, &QTimer::timeout, &loop, &QEventLoop::quit);
+    durationTimer.start(durationMs);
+    QTimer idleTimer;
+    QObject::connect(&idleTimer, &QTimer::timeout, &loop, [&] {
+        if(buffers && clock.nsecsElapsed() - lastReceived > idleTimeoutMs * 1000000LL) {
+            loop.quit();
+        }
+    });
+    idleTimer.start(idleTimeoutMs / 10);
+    loop.exec();
+
+    const double seconds = (clock.nsecsElapsed() - start) / 1e9;
+    const QVariantMap linkStatistics = sensor->link()->statistics();
+    sensor->link()->finishConnection();
+
+    // The connections use local variables of this function
+    sensor->linkTee()->removeSink(sink);
+    for(const auto& connection : connections) {
+        QObject::disconnect(connection);
+    }
+
+    return {
+        {"name", name},
+        {"seconds", seconds},
+        {"bytes", bytes},
+        {"buffers", buffers},
+        {"messages", messages},
+        {"profiles_drawn", drawn},
+        {"profiles_pending", pending.size()},
+        {"messages_per_s", messages / seconds},
+        {"profiles_per_s", drawn / seconds},
+        {"mb_per_s", bytes / seconds / 1e6},
+        {"link", QJsonObject::fromVariantMap(linkStatistics)},
+        {"frames", QJsonObject::fromVariantMap(plot->frameQueue()->statistics())},
+        {"latency", QJsonObject{
+                {"parse", parse.toJson()},
+                {"sensor", sensorStage.toJson()},
+                {"draw", draw.toJson()},
+                {"total", total.toJson()},
+                {"paint", paint.toJson()},
+            }
+        },
+        {"peak_rss_bytes", peakRss()},
+    };
+}
+
+qint64 PipelineBenchmark::peakRss()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef Q_OS_MACOS
+        return usage.ru_maxrss;
+#else
+        return usage.ru_maxrss * 1024LL;
+#endif
+    }
+#endif
+    return -1;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+#include "linkconfiguration.h"
+
+/**
+ * @brief End to end benchmark of the sensor pipeline: link, parser, sensor and waterfall
+ *  The pipeline runs in the application event loop as in the interface, but the plots are painted offscreen.
+ *  Each profile is timed from the moment its link buffer is delivered until the plot draws it,
+ *  plots are painted in an image with the display refresh rate.
+ *
+ */
+class PipelineBenchmark
+{
+public:
+    /**
+     * @brief Sensor and plot used in the pipeline
+     *
+     */
+    enum SensorType {
+        Ping1D,
+        Ping360,
+    };
+
+    /**
+     * @brief Latency samples of a pipeline stage, in nanoseconds
+     *
+     */
+    struct Stage {
+        QVector<qint64> samples;
+
+        /**
+         * @brief Return count, mean, p50, p90, p99 and max in microseconds
+         *
+         * @return QJsonObject
+         */
+        QJsonObject toJson() const;
+    };
+
+    PipelineBenchmark() = delete;
+    ~PipelineBenchmark() = delete;
+
+    /**
+     * @brief Run the pipeline until durationMs is over or the link stops sending data
+     *
+     * @param name
+     * @param linkConfiguration simulation or log link
+     * @param sensorType
+     * @param durationMs
+     * @param viewport size of the painted plot
+     * @return QJsonObject throughput, stage latencies and peak RSS
+     */
+    static QJsonObject run(const QString& name, const LinkConfiguration& linkConfiguration, SensorType sensorType,
+                           int durationMs, const QSize& viewport = {1280, 720});
+
+    /**
+     * @brief Return the peak resident set size of the process
+     *
+     * @return qint64 bytes, -1 if not available
+     */
+    static qint64 peakRss();
+
+    // Time without data that ends the run, e.g. at the end of a log
+    static const int idleTimeoutMs = 1000;
+    // Plots are painted at most in this interval, like a 60 Hz display
+    static const int paintIntervalMs = 16;
+};
@@ -2,6 +2,7 @@
 #include "logger.h"
 #include "ping.h"
 #include "ping360.h"
+#include "settingsmanager.h"
 
 PING_LOGGING_CATEGORY(DEVICEMANAGER, "ping.devicemanager");
 
@@ -24,6 +25,55 @@ DeviceManager::DeviceManager() :
     connect(&_ping360EthernetFinder, &Ping360EthernetFinder::availableLinkFound, this, &DeviceManager::append);
     append({AbstractLinkNamespace::Ping1DSimulation, {}, "Ping1D Simulation", PingDeviceType::PING1D}, "Ping1D");
     append({AbstractLinkNamespace::Ping360Simulation, {}, "Ping360 Simulation", PingDeviceType::PING360}, "Ping360");
+
+    // Commands from relay clients go to the primary sensor
+    connect(&_linkRelay, &LinkRelay::clientData, this, [this](const QByteArray& data) {
+        if(_primarySensor && _primarySensor->link() && _primarySensor->link()->isOpen()) {
+            emit _primarySensor->link()->sendData(data);
+        }
+    });
+    connect(SettingsManager::self(), &SettingsManager::relayTcpPortChanged, this, &DeviceManager::updateLinkRelay);
+    connect(SettingsManager::self(), &SettingsManager::relayUdpPortChanged, this, &DeviceManager::updateLinkRelay);
+    updateLinkRelay();
+}
+
+void DeviceManager::updateLinkRelay()
+{
+    const quint16 tcpPort = qBound(0, SettingsManager::self()->relayTcpPort(), 65535);
+    const quint16 udpPort = qBound(0, SettingsManager::self()->relayUdpPort(), 65535);
+
+    detachLinkRelay();
+    if(!tcpPort && !udpPort) {
+        _linkRelay.close();
+        return;
+    }
+
+    // Only local processes should share the sensor
+    if(!_linkRelay.listen(QHostAddress::LocalHost, tcpPort, udpPort)) {
+        qCWarning(DEVICEMANAGER) << "Relay is not listening on all ports, requested TCP:" << tcpPort
+                                 << "UDP:" << udpPort << "listening TCP:" << _linkRelay.tcpPort()
+                                 << "UDP:" << _linkRelay.udpPort();
+    }
+    attachLinkRelay();
+}
+
+void DeviceManager::attachLinkRelay()
+{
+    if(!_primarySensor || !_linkRelay.isListening()) {
+        return;
+    }
+
+    _linkRelaySink = _primarySensor->linkTee()->addSink(QStringLiteral("relay"), &_linkRelay, [this](const QByteArray& data) {
+        _linkRelay.send(data);
+    });
+}
+
+void DeviceManager::detachLinkRelay()
+{
+    if(_primarySensor) {
+        _primarySensor->linkTee()->removeSink(_linkRelaySink);
+    }
+    _linkRelaySink = -1;
 }
 
 void DeviceManager::append(const LinkConfiguration& linkConf, const QString& deviceName)
@@ -96,6 +146,9 @@ void DeviceManager::connectLink(LinkConfiguration* linkConf)
     _sensors[Name][objIndex] = PingHelper::nameFromDeviceType(linkConf->deviceType());
     qCDebug(DEVICEMANAGER) << "Connecting with sensor:" << _sensors[Name][objIndex].toString() << *linkConf;
 
+    // The relay moves to the new sensor, its ports stay bound
+    detachLinkRelay();
+
     // We could use a single Ping instance, but since we are going to support multiple devices
     // this pointer will hold everything for us
     if(linkConf->deviceType() == PingDeviceType::PING1D) {
@@ -103,6 +156,7 @@ void DeviceManager::connectLink(LinkConfiguration* linkConf)
     } else {
         _primarySensor.reset(new Ping360());
     }
+    attachLinkRelay();
 
     emit primarySensorChanged();
     _primarySensor->connectLink(*linkConf);
@@ -5,6 +5,7 @@
 #include <QThread>
 
 #include "abstractlinknamespace.h"
+#include "linkrelay.h"
 #include "ping360ethernetfinder.h"
 #include "protocoldetector.h"
 #include "sensor.h"
@@ -139,6 +140,15 @@ public:
     }
     Q_PROPERTY(QVariant primarySensor READ primarySensor NOTIFY primarySensorChanged)
 
+    /**
+     * @brief Return the relay that re-serves the primary sensor link data to local clients
+     *  The relay is kept between connections, so the ports stay bound when the sensor changes.
+     *
+     * @return LinkRelay*
+     */
+    LinkRelay* linkRelay() { return &_linkRelay; };
+    Q_PROPERTY(LinkRelay* linkRelay READ linkRelay CONSTANT)
+
 signals:
     void countChanged();
     void sensorChanged(int objIndex);
@@ -160,6 +170,24 @@ private:
      */
     void updateAvailableConnections(const QVector<LinkConfiguration>& availableLinkConfigurations);
 
+    /**
+     * @brief Open or close the relay ports from the settings
+     *
+     */
+    void updateLinkRelay();
+
+    /**
+     * @brief Add the relay as a sink of the primary sensor link tee, if the relay is listening
+     *
+     */
+    void attachLinkRelay();
+
+    /**
+     * @brief Remove the relay sink from the primary sensor link tee
+     *
+     */
+    void detachLinkRelay();
+
     // Role and names
     enum Roles {
         Available = 0,
@@ -174,6 +202,8 @@ private:
         {{Name}, {"name"}},
     };
 
+    LinkRelay _linkRelay;
+    int _linkRelaySink = -1;
     QSharedPointer<Sensor> _primarySensor;
     ProtocolDetector* _detector;
     Ping360EthernetFinder _ping360EthernetFinder;
@@ -3,12 +3,20 @@
 #include "abstractlink.h"
 #include "abstractlinknamespace.h"
 
-const QString AbstractLink::_timeFormat = QStringLiteral("hh:mm:ss.zzz");
-
 AbstractLink::AbstractLink(QObject* parent)
     : QObject(parent)
     , _type(LinkType::None)
 {
 }
 
+QString AbstractLink::durationString(qint64 msecs)
+{
+    msecs = qMax<qint64>(0, msecs);
+    return QStringLiteral("%1:%2:%3.%4")
+           .arg(msecs / 3600000, 2, 10, QChar('0'))
+           .arg(msecs / 60000 % 60, 2, 10, QChar('0'))
+           .arg(msecs / 1000 % 60, 2, 10, QChar('0'))
+           .arg(msecs % 1000, 3, 10, QChar('0'));
+}
+
 AbstractLink::~AbstractLink() = default;
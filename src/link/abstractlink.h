@@ -2,8 +2,10 @@
 
 #include <QObject>
 #include <QTime>
+#include <QVariantMap>
 
 #include "linkconfiguration.h"
+#include "logoverview.h"
 
 /**
  * @brief The abstract connection link base class
@@ -53,7 +55,14 @@ public:
      *
      * @return QString
      */
-    Q_INVOKABLE virtual QString elapsedTimeString() { return elapsedTime().toString(_timeFormat); };
+    Q_INVOKABLE virtual QString elapsedTimeString() { return durationString(elapsedTimeMs()); };
+
+    /**
+     * @brief Return elapsed time in milliseconds, not limited to a single day
+     *
+     * @return qint64
+     */
+    Q_INVOKABLE virtual qint64 elapsedTimeMs() { return qMax(0, QTime(0, 0).msecsTo(elapsedTime())); };
 
     /**
      * @brief Return error in a human friendly message
@@ -106,6 +115,13 @@ public:
      */
     Q_INVOKABLE virtual int packageSize() { return 0; };
 
+    /**
+     * @brief Return overview of the data, available only in links with a known end (e.g. logs)
+     *
+     * @return LogOverview* nullptr if not available
+     */
+    virtual LogOverview* overview() { return nullptr; };
+
     /**
      * @brief Return package index
      *
@@ -119,6 +135,13 @@ public:
      */
     Q_INVOKABLE virtual void pause() {};
 
+    /**
+     * @brief Return replay rate
+     *
+     * @return double 1 for real time, 0 for unthrottled
+     */
+    virtual double replayRate() { return 1; };
+
     /**
      * @brief Return the link name
      *
@@ -126,6 +149,13 @@ public:
      */
     const QString name() { return _name; }
 
+    /**
+     * @brief Seek to a time
+     *
+     * @param msecs time from the start in milliseconds
+     */
+    Q_INVOKABLE virtual void seek(qint64 msecs) { Q_UNUSED(msecs) };
+
     /**
      * @brief Set the auto connection state
      *
@@ -156,6 +186,13 @@ public:
      */
     Q_INVOKABLE virtual void setPackageIndex(int index) { Q_UNUSED(index) };
 
+    /**
+     * @brief Set replay rate
+     *
+     * @param rate 1 for real time, 0 for unthrottled
+     */
+    virtual void setReplayRate(double rate) { Q_UNUSED(rate) };
+
     /**
      * @brief Set link type
      *
@@ -175,6 +212,20 @@ public:
      */
     Q_INVOKABLE virtual bool startConnection() { return true;};
 
+    /**
+     * @brief Return link statistics, the counters depend on the link type
+     *
+     * @return QVariantMap counter name and value
+     */
+    Q_INVOKABLE virtual QVariantMap statistics() { return {}; };
+
+    /**
+     * @brief Pause and move a number of packages
+     *
+     * @param packages 1 for the next package, -1 for the previous one
+     */
+    Q_INVOKABLE virtual void step(int packages) { Q_UNUSED(packages) };
+
     /**
      * @brief Return total time
      *
@@ -187,7 +238,14 @@ public:
      *
      * @return QString
      */
-    Q_INVOKABLE virtual QString totalTimeString() { return totalTime().toString(_timeFormat); };
+    Q_INVOKABLE virtual QString totalTimeString() { return durationString(totalTimeMs()); };
+
+    /**
+     * @brief Return total time in milliseconds, not limited to a single day
+     *
+     * @return qint64
+     */
+    Q_INVOKABLE virtual qint64 totalTimeMs() { return qMax(0, QTime(0, 0).msecsTo(totalTime())); };
 
     /**
      * @brief Return LinkType
@@ -219,13 +277,17 @@ public:
     Q_PROPERTY(qint64 byteSize READ byteSize NOTIFY byteSizeChanged)
     Q_PROPERTY(LinkConfiguration* configuration READ configuration NOTIFY configurationChanged)
     Q_PROPERTY(QTime elapsedTime READ elapsedTime NOTIFY elapsedTimeChanged)
+    Q_PROPERTY(qint64 elapsedTimeMs READ elapsedTimeMs NOTIFY elapsedTimeChanged)
     Q_PROPERTY(QString elapsedTimeString READ elapsedTimeString NOTIFY elapsedTimeChanged)
     Q_PROPERTY(bool isAutoConnect READ isAutoConnect WRITE setAutoConnect NOTIFY autoConnectChanged)
     Q_PROPERTY(QStringList listAvailableConnections READ listAvailableConnections NOTIFY availableConnectionsChanged)
     Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(LogOverview* overview READ overview NOTIFY overviewChanged)
     Q_PROPERTY(int packageIndex READ packageIndex WRITE setPackageIndex NOTIFY packageIndexChanged)
     Q_PROPERTY(int packageSize READ packageSize NOTIFY packageSizeChanged)
+    Q_PROPERTY(double replayRate READ replayRate WRITE setReplayRate NOTIFY replayRateChanged)
     Q_PROPERTY(QTime totalTime READ totalTime NOTIFY totalTimeChanged)
+    Q_PROPERTY(qint64 totalTimeMs READ totalTimeMs NOTIFY totalTimeChanged)
     Q_PROPERTY(QString totalTimeString READ totalTimeString NOTIFY totalTimeChanged)
     Q_PROPERTY(LinkType type READ type WRITE setType NOTIFY linkChanged)
 
@@ -241,11 +303,22 @@ signals:
     void byteSizeChanged();
     void packageSizeChanged();
     void packageIndexChanged();
+    void replayRateChanged();
+    void overviewChanged();
     void totalTimeChanged();
     void elapsedTimeChanged();
+    // Emitted when the position changes without continuity (e.g. seek), old data should be cleared
+    void seeked();
 
 protected:
-    static const QString _timeFormat;
+    /**
+     * @brief Format a duration as hh:mm:ss.zzz, hours are not limited to a day
+     *
+     * @param msecs
+     * @return QString
+     */
+    static QString durationString(qint64 msecs);
+
     LinkConfiguration _linkConfiguration;
 
 private:
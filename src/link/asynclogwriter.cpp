@@ -0,0 +1,135 @@
+#include "asynclogwriter.h"
+#include "logger.h"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+PING_LOGGING_CATEGORY(ASYNCLOGWRITER, "ping.asynclogwriter");
+
+namespace {
+// Around 10 seconds of serial data at 2 Mbps with 4 kB chunks
+const int queueCapacity = 8192;
+// Time waiting for new records when the queue is empty
+const int batchIntervalMs = 10;
+// Records waiting more than this in the queue are late
+const qint64 lateThresholdNs = 500 * 1000000LL;
+}
+
+AsyncLogWriter::AsyncLogWriter()
+    : _queue(queueCapacity)
+{
+    _clock.start();
+}
+
+bool AsyncLogWriter::open(const QString& fileName, qint64 startTime, bool compress, FlushPolicy policy,
+                          int flushIntervalMs)
+{
+    close();
+
+    if(!_writer.open(fileName, startTime, compress)) {
+        return false;
+    }
+
+    _policy = policy;
+    _flushIntervalMs = flushIntervalMs;
+    _droppedPackets = 0;
+    _latePackets = 0;
+    _writtenPackets = 0;
+
+    _running = true;
+    _thread.reset(QThread::create(&AsyncLogWriter::run, this));
+    _thread->setObjectName(QStringLiteral("AsyncLogWriter"));
+    _thread->start(QThread::LowPriority);
+    return true;
+}
+
+bool AsyncLogWriter::append(qint64 timestamp, const QByteArray& data)
+{
+    if(!_thread) {
+        return false;
+    }
+
+    if(!_queue.push({timestamp, _clock.nsecsElapsed(), data})) {
+        // Do not flood the log, warn only when it starts dropping
+        if(_droppedPackets++ == 0) {
+            qCWarning(ASYNCLOGWRITER) << "Log queue is full, dropping packets.";
+        }
+        return false;
+    }
+    return true;
+}
+
+void AsyncLogWriter::run()
+{
+    QElapsedTimer flushTimer;
+    flushTimer.start();
+
+    while(_running) {
+        if(!writeBatch()) {
+            QThread::msleep(batchIntervalMs);
+        }
+
+        if(_policy != FlushOnChunk && flushTimer.elapsed() >= _flushIntervalMs) {
+            flushTimer.restart();
+            flush();
+        }
+    }
+
+    // Records queued before close
+    writeBatch();
+}
+
+int AsyncLogWriter::writeBatch()
+{
+    int written = 0;
+    Record record;
+    while(_queue.pop(record)) {
+        if(_clock.nsecsElapsed() - record.queuedTime > lateThresholdNs) {
+            _latePackets++;
+        }
+        _writer.append(record.timestamp, record.data);
+        written++;
+    }
+    _writtenPackets += written;
+    return written;
+}
+
+void AsyncLogWriter::flush()
+{
+    _writer.flush();
+    if(_policy != SyncPeriodically) {
+        return;
+    }
+
+    const int handle = _writer.file()->handle();
+#ifdef Q_OS_WIN
+    _commit(handle);
+#else
+    fsync(handle);
+#endif
+}
+
+void AsyncLogWriter::close()
+{
+    if(!_thread) {
+        return;
+    }
+
+    _running = false;
+    _thread->wait();
+    _thread.reset();
+    _writer.close();
+
+    if(_droppedPackets || _latePackets) {
+        qCWarning(ASYNCLOGWRITER) << "Log finished with" << _droppedPackets << "dropped and" << _latePackets
+                                  << "late packets.";
+    }
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    close();
+}
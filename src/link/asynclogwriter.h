@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "sensorlogwriter.h"
+#include "spscqueue.h"
+
+/**
+ * @brief Write sensor logs in a background thread
+ *  Records are passed to the writer thread with a lock-free queue and written in batches,
+ *  appending a record never blocks the caller. If the queue is full the record is dropped.
+ *
+ */
+class AsyncLogWriter
+{
+public:
+    /**
+     * @brief When the data is sent to the disk
+     *
+     */
+    enum FlushPolicy {
+        // Chunks are written when full, a crash loses everything since the last full chunk
+        FlushOnChunk = 0,
+        // Pending records are written as a chunk after each flush interval
+        FlushPeriodically,
+        // Same as FlushPeriodically, and the file is synchronized with the disk (fsync)
+        SyncPeriodically,
+    };
+
+    /**
+     * @brief Construct a new Async Log Writer object
+     *
+     */
+    AsyncLogWriter();
+
+    /**
+     * @brief Destroy the Async Log Writer object, pending records are written
+     *
+     */
+    ~AsyncLogWriter();
+
+    /**
+     * @brief Create the log file and start the writer thread
+     *
+     * @param fileName
+     * @param startTime log start in nanoseconds since epoch
+     * @param compress compress chunks
+     * @param policy
+     * @param flushIntervalMs interval used by FlushPeriodically and SyncPeriodically
+     * @return true
+     * @return false
+     */
+    bool open(const QString& fileName, qint64 startTime, bool compress = false,
+              FlushPolicy policy = FlushPeriodically, int flushIntervalMs = 1000);
+
+    /**
+     * @brief Queue a new record, only called by a single thread
+     *
+     * @param timestamp nanoseconds since startTime
+     * @param data
+     * @return true
+     * @return false the queue is full and the record was dropped
+     */
+    bool append(qint64 timestamp, const QByteArray& data);
+
+    /**
+     * @brief Write all queued records, stop the writer thread and close the file
+     *
+     */
+    void close();
+
+    /**
+     * @brief Return true if the log is open
+     *
+     * @return true
+     * @return false
+     */
+    bool isOpen() const { return _thread != nullptr; }
+
+    /**
+     * @brief Return the number of records dropped because the queue was full
+     *
+     * @return quint64
+     */
+    quint64 droppedPackets() const { return _droppedPackets; }
+
+    /**
+     * @brief Return the number of records written later than the late threshold
+     *
+     * @return quint64
+     */
+    quint64 latePackets() const { return _latePackets; }
+
+    /**
+     * @brief Return the number of written records
+     *
+     * @return quint64
+     */
+    quint64 writtenPackets() const { return _writtenPackets; }
+
+private:
+    Q_DISABLE_COPY(AsyncLogWriter)
+
+    struct Record {
+        qint64 timestamp = 0;
+        // Time when the record was queued
+        qint64 queuedTime = 0;
+        QByteArray data;
+    };
+
+    /**
+     * @brief Writer thread loop
+     *
+     */
+    void run();
+
+    /**
+     * @brief Write queued records
+     *
+     * @return int number of written records
+     */
+    int writeBatch();
+
+    /**
+     * @brief Apply flush policy
+     *
+     */
+    void flush();
+
+    FlushPolicy _policy = FlushOnChunk;
+    int _flushIntervalMs = 1000;
+
+    SpscQueue<Record> _queue;
+    SensorLogWriter _writer;
+    QElapsedTimer _clock;
+    std::unique_ptr<QThread> _thread;
+    std::atomic<bool> _running{false};
+
+    std::atomic<quint64> _droppedPackets{0};
+    std::atomic<quint64> _latePackets{0};
+    std::atomic<quint64> _writtenPackets{0};
+};
@@ -1,11 +1,13 @@
 #include <functional>
 
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QLoggingCategory>
 #include <QUrl>
 
 #include "filelink.h"
+#include "settingsmanager.h"
 
 Q_LOGGING_CATEGORY(PING_PROTOCOL_FILELINK, "ping.protocol.filelink")
 
@@ -13,7 +15,6 @@ FileLink::FileLink(QObject* parent)
     : AbstractLink(parent)
     , _openModeFlag(QIODevice::ReadWrite)
     , _timer()
-    , _inout(&_file)
     , _logThread(nullptr)
 {
     _timer.start();
@@ -23,25 +24,25 @@ FileLink::FileLink(QObject* parent)
 
 void FileLink::_writeData(const QByteArray& data)
 {
+    if(_openModeFlag != QIODevice::WriteOnly) {
+        qCWarning(PING_PROTOCOL_FILELINK) << "Something is wrong!";
+        qCDebug(PING_PROTOCOL_FILELINK) << "File is opened as write only:" << (_openModeFlag == QIODevice::WriteOnly);
+        return;
+    }
+
     // Check if we have already opened the file
-    if(!_file.isOpen()) {
+    if(!_logWriter.isOpen()) {
         qCDebug(PING_PROTOCOL_FILELINK) << "File will be opened.";
-        if(!_file.open(QIODevice::ReadWrite)) {
+        const qint64 startTime = QDateTime::currentMSecsSinceEpoch() * 1000000 - _timer.nsecsElapsed();
+        const auto policy = static_cast<AsyncLogWriter::FlushPolicy>(SettingsManager::self()->logFlushPolicy());
+        if(!_logWriter.open(_file.fileName(), startTime, SettingsManager::self()->logCompression(), policy,
+                            SettingsManager::self()->logFlushInterval())) {
             qCDebug(PING_PROTOCOL_FILELINK) << "File was not open.";
             return;
         }
     }
 
-    // This save the data as a structure to deal with the timestamp
-    if(_openModeFlag == QIODevice::WriteOnly && _file.isWritable()) {
-        QString time =  QTime::fromMSecsSinceStartOfDay(_timer.elapsed()).toString(_timeFormat);
-        Pack pack{time, data};
-        _inout << pack.time << pack.data;
-    } else {
-        qCWarning(PING_PROTOCOL_FILELINK) << "Something is wrong!";
-        qCDebug(PING_PROTOCOL_FILELINK) << "File is opened as write only:" << (_openModeFlag == QIODevice::WriteOnly);
-        qCDebug(PING_PROTOCOL_FILELINK) << "File can be writable:" << _file.isWritable();
-    }
+    _logWriter.append(_timer.nsecsElapsed(), data);
 }
 
 bool FileLink::setConfiguration(const LinkConfiguration& linkConfiguration)
@@ -59,7 +60,9 @@ bool FileLink::setConfiguration(const LinkConfiguration& linkConfiguration)
     // This flag does not change how the file will be open (ReadWrite)
     _openModeFlag = linkConfiguration.args()->at(1)[0] == "r" ? QIODevice::ReadOnly : QIODevice::WriteOnly;
 
-    _file.setFileName(linkConfiguration.args()->at(0));
+    // Multiple logs are played as a single session, ordered by time
+    _fileNames = linkConfiguration.args()->at(0).split(';', QString::SkipEmptyParts);
+    _file.setFileName(_fileNames.value(0));
 
     return true;
 }
@@ -75,49 +78,91 @@ bool FileLink::startConnection()
     }
 
     // Everything after this point is to deal with reading data
-    bool ok = _file.open(QIODevice::ReadWrite);
-    if(ok) {
-        Pack pack;
-        if(_logThread) {
-            // Disconnect LogThread
-            disconnect(_logThread.get(), &LogThread::newPackage, this, &FileLink::newData);
-            disconnect(_logThread.get(), &LogThread::packageIndexChanged, this, &FileLink::packageIndexChanged);
-            disconnect(_logThread.get(), &LogThread::packageIndexChanged, this, &FileLink::elapsedTimeChanged);
-        }
-        _logThread.reset(new LogThread());
-        connect(_logThread.get(), &LogThread::newPackage, this, &FileLink::newData);
-        connect(_logThread.get(), &LogThread::packageIndexChanged, this, &FileLink::packageIndexChanged);
-        connect(_logThread.get(), &LogThread::packageIndexChanged, this, &FileLink::elapsedTimeChanged);
-        while(true) {
-            // Get data
-            _inout >> pack.time >> pack.data;
-
-            // Check if we have a new package
-            if(pack.time.isEmpty()) {
-                qCDebug(PING_PROTOCOL_FILELINK) << "No more packages !";
-                break;
-            }
-
-            QTime time = QTime::fromString(pack.time, _timeFormat);
-            _logThread->append(time, pack.data);
-        }
-        _logThread->start();
-        emit elapsedTimeChanged();
-        emit totalTimeChanged();
+    if(_logThread) {
+        // Disconnect LogThread
+        disconnect(_logThread.get(), &LogThread::newPackage, this, &FileLink::newData);
+        disconnect(_logThread.get(), &LogThread::packageIndexChanged, this, &FileLink::packageIndexChanged);
+        disconnect(_logThread.get(), &LogThread::packageIndexChanged, this, &FileLink::elapsedTimeChanged);
+        disconnect(_logThread.get(), &LogThread::seeked, this, &FileLink::seeked);
+    }
+    _logThread.reset(new LogThread());
+
+    // The logs are mapped and indexed in background, packets are decoded while playing
+    _logOverview.reset();
+    _logSession.reset(new SensorLogSession());
+    connect(_logSession.get(), &SensorLogSession::indexUpdated, this, &FileLink::packageSizeChanged);
+    connect(_logSession.get(), &SensorLogSession::indexUpdated, this, &FileLink::totalTimeChanged);
+    if(!_logSession->open(_fileNames)) {
+        return false;
     }
-    return ok;
+
+    _logThread->setSession(_logSession.get());
+    _logThread->setRate(_replayRate);
+
+    // Decimated overview of the whole log, used as minimap of the playback
+    _logOverview.reset(new LogOverview());
+    _logOverview->build(_logSession.get(), _fileNames.size() == 1 ? _fileNames.first() : QString());
+    emit overviewChanged();
+    connect(_logThread.get(), &LogThread::newPackage, this, &FileLink::newData);
+    connect(_logThread.get(), &LogThread::packageIndexChanged, this, &FileLink::packageIndexChanged);
+    connect(_logThread.get(), &LogThread::packageIndexChanged, this, &FileLink::elapsedTimeChanged);
+    connect(_logThread.get(), &LogThread::seeked, this, &FileLink::seeked);
+    _logThread->start();
+    emit byteSizeChanged();
+    emit elapsedTimeChanged();
+    emit totalTimeChanged();
+    return true;
 };
 
+void FileLink::setReplayRate(double rate)
+{
+    rate = rate <= 0 ? 0 : qBound(LogThread::minimumRate, rate, LogThread::maximumRate);
+    if(qFuzzyCompare(rate, _replayRate)) {
+        return;
+    }
+
+    _replayRate = rate;
+    if(_logThread) {
+        _logThread->setRate(_replayRate);
+    }
+    emit replayRateChanged();
+}
+
 bool FileLink::isOpen()
 {
     // If filelink exist to create a log, the file will be only created after receiving the first data
     // To return at least a good answer, we do check the path to see if it's writable
     return (QFileInfo(QFileInfo(_file).canonicalPath()).isWritable() && _openModeFlag == QIODevice::WriteOnly)
-           || _file.isReadable(); // If file is readable it's already opened and working
+           || (_logSession && _logSession->isOpen()); // If log is mapped it's already opened and working
 };
 
+QVariantMap FileLink::statistics()
+{
+    return {
+        {"writtenPackets", _logWriter.writtenPackets()},
+        {"droppedPackets", _logWriter.droppedPackets()},
+        {"latePackets", _logWriter.latePackets()},
+    };
+}
+
 bool FileLink::finishConnection()
 {
+    // Write pending records
+    _logWriter.close();
+
+    // Stop playing before closing the log
+    if(_logThread) {
+        _logThread->stop();
+        _logThread->setSession(nullptr);
+    }
+    // The overview uses the session, it stops without waiting for the logs being indexed
+    if(_logOverview) {
+        _logOverview->cancel();
+    }
+    if(_logSession) {
+        _logSession->close();
+    }
+
     // Only close files that are open
     if(_file.isOpen()) {
         _file.close();
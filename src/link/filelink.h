@@ -1,6 +1,5 @@
 #pragma once
 
-#include <QDataStream>
 #include <QElapsedTimer>
 #include <QFile>
 #include <QTime>
@@ -8,10 +7,14 @@
 #include <memory>
 
 #include "abstractlink.h"
+#include "asynclogwriter.h"
+#include "logoverview.h"
 #include "logthread.h"
+#include "sensorlogsession.h"
 
 /**
  * @brief File connection class
+ *  The first argument is the log, or a list of logs separated by ';' that are played as a single log.
  *
  */
 class FileLink : public AbstractLink
@@ -30,7 +33,21 @@ public:
      *
      * @return qint64
      */
-    qint64 byteSize() final { return _file.bytesAvailable(); };
+    qint64 byteSize() final { return _logSession ? _logSession->byteSize() : _file.bytesAvailable(); };
+
+    /**
+     * @brief Return the number of packets dropped by the log writer
+     *
+     * @return quint64
+     */
+    quint64 droppedPackets() const { return _logWriter.droppedPackets(); }
+
+    /**
+     * @brief Return the number of packets written late by the log writer
+     *
+     * @return quint64
+     */
+    quint64 latePackets() const { return _logWriter.latePackets(); }
 
     /**
      * @brief Return elapsed time of log
@@ -39,6 +56,13 @@ public:
      */
     QTime elapsedTime() final { return _logThread ? _logThread->elapsedTime() : QTime(); };
 
+    /**
+     * @brief Return elapsed time of log in milliseconds
+     *
+     * @return qint64
+     */
+    qint64 elapsedTimeMs() final { return _logThread ? _logThread->elapsedTimeMs() : 0; };
+
     /**
      * @brief Return a human friendly error message
      *
@@ -70,6 +94,13 @@ public:
      */
     bool isWritable() final { return false; };
 
+    /**
+     * @brief Return log overview, built in background when the log is opened
+     *
+     * @return LogOverview*
+     */
+    LogOverview* overview() final { return _logOverview.get(); };
+
     /**
      * @brief Return package index
      *
@@ -90,6 +121,13 @@ public:
      */
     void pause() final { if(_logThread) _logThread->pauseJob(); };
 
+    /**
+     * @brief Return replay rate
+     *
+     * @return double
+     */
+    double replayRate() final { return _replayRate; };
+
     /**
      * @brief Set the configuration object
      *
@@ -106,6 +144,20 @@ public:
      */
     void setPackageIndex(int index) { if(_logThread) _logThread->setPackageIndex(index); }
 
+    /**
+     * @brief Seek to a time of the log
+     *
+     * @param msecs
+     */
+    void seek(qint64 msecs) final { if(_logThread) _logThread->seek(msecs); };
+
+    /**
+     * @brief Set replay rate
+     *
+     * @param rate
+     */
+    void setReplayRate(double rate) final;
+
     /**
      * @brief Start log
      *
@@ -120,6 +172,20 @@ public:
      */
     bool startConnection() final;
 
+    /**
+     * @brief Return link statistics: written, dropped and late packets of the log writer
+     *
+     * @return QVariantMap
+     */
+    QVariantMap statistics() final;
+
+    /**
+     * @brief Pause and move a number of packages
+     *
+     * @param packages
+     */
+    void step(int packages) final { if(_logThread) _logThread->step(packages); };
+
     /**
      * @brief Return log total time
      *
@@ -127,19 +193,27 @@ public:
      */
     QTime totalTime() final { return _logThread ? _logThread->totalTime() : QTime(); };
 
-private:
-    struct Pack {
-        QString time;
-        QByteArray data;
-    };
+    /**
+     * @brief Return log total time in milliseconds
+     *
+     * @return qint64
+     */
+    qint64 totalTimeMs() final { return _logThread ? _logThread->totalTimeMs() : 0; };
 
+private:
     QIODevice::OpenModeFlag _openModeFlag;
     QElapsedTimer _timer;
+    double _replayRate = 10;
 
     QFile _file;
-    QDataStream _inout;
+    AsyncLogWriter _logWriter;
 
     std::unique_ptr<LogThread> _logThread;
+    // Logs of the playback, a single log or the logs of a dive
+    QStringList _fileNames;
+    std::unique_ptr<SensorLogSession> _logSession;
+    // Uses _logSession, should be destroyed first
+    std::unique_ptr<LogOverview> _logOverview;
 
     void _writeData(const QByteArray& data);
 };
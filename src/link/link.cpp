@@ -30,6 +30,9 @@ Link::Link(LinkType linkType, QString name, QObject* parent)
     case LinkType::Udp :
         _abstractLink.reset(new UDPLink());
         break;
+    case LinkType::Tcp :
+        _abstractLink.reset(new TCPLink());
+        break;
     case LinkType::Ping1DSimulation :
         _abstractLink.reset(new Ping1DSimulationLink());
         break;
@@ -59,6 +62,9 @@ Link::Link(const LinkConfiguration& linkConfiguration, QObject* parent)
     case LinkType::Udp :
         _abstractLink.reset(new UDPLink());
         break;
+    case LinkType::Tcp :
+        _abstractLink.reset(new TCPLink());
+        break;
     case LinkType::Ping1DSimulation :
         _abstractLink.reset(new Ping1DSimulationLink());
         break;
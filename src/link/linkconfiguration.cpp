@@ -44,10 +44,14 @@ LinkConfiguration::Error LinkConfiguration::error() const
         return MissingConfiguration;
     }
 
-    // Simulation does not need args
+    // Simulation does not need args, optional ones are key=value pairs
     //TODO: rework this check, check linkconfiguration capabilities or add new ones for this case
-    if((_linkConf.type == LinkType::Ping1DSimulation || _linkConf.type == LinkType::Ping360Simulation)
-            && !_linkConf.args.length()) {
+    if(_linkConf.type == LinkType::Ping1DSimulation || _linkConf.type == LinkType::Ping360Simulation) {
+        for(const auto& arg : _linkConf.args) {
+            if(!arg.contains('=')) {
+                return InvalidArgsNumber;
+            }
+        }
         return NoErrors;
     }
 
@@ -68,7 +72,7 @@ LinkConfiguration::Error LinkConfiguration::error() const
         }
     }
 
-    if(_linkConf.type == LinkType::Udp) {
+    if(_linkConf.type == LinkType::Udp || _linkConf.type == LinkType::Tcp) {
         if(!QUrl(_linkConf.args[0]).isValid()) {
             return InvalidUrl;
         }
@@ -258,6 +258,8 @@ public:
             return QStringLiteral("Serial");
         case LinkType::Udp:
             return QStringLiteral("UDP");
+        case LinkType::Tcp:
+            return QStringLiteral("TCP");
         case LinkType::Ping1DSimulation:
             return QStringLiteral("Ping1D Simulation");
         case LinkType::Ping360Simulation:
@@ -0,0 +1,201 @@
+#include <algorithm>
+
+#include <QDateTime>
+#include <QNetworkDatagram>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+
+#include "linkrelay.h"
+#include "logger.h"
+
+PING_LOGGING_CATEGORY(LINKRELAY, "ping.linkrelay");
+
+LinkRelay::LinkRelay(QObject* parent)
+    : QObject(parent)
+    , _tcpServer(new QTcpServer(this))
+    , _udpSocket(new QUdpSocket(this))
+{
+    connect(_tcpServer, &QTcpServer::newConnection, this, &LinkRelay::newConnections);
+    connect(_udpSocket, &QIODevice::readyRead, this, &LinkRelay::readDatagrams);
+}
+
+bool LinkRelay::listen(const QHostAddress& address, quint16 tcpPort, quint16 udpPort)
+{
+    close();
+
+    bool ok = true;
+    if(tcpPort && !_tcpServer->listen(address, tcpPort)) {
+        qCWarning(LINKRELAY) << "Failed to listen in TCP port" << tcpPort << _tcpServer->errorString();
+        ok = false;
+    }
+    if(udpPort && !_udpSocket->bind(address, udpPort)) {
+        qCWarning(LINKRELAY) << "Failed to bind UDP port" << udpPort << _udpSocket->errorString();
+        ok = false;
+    }
+
+    qCDebug(LINKRELAY) << "Relay in" << address << "TCP:" << this->tcpPort() << "UDP:" << this->udpPort();
+    return ok;
+}
+
+bool LinkRelay::isListening() const
+{
+    return _tcpServer->isListening() || _udpSocket->state() == QAbstractSocket::BoundState;
+}
+
+quint16 LinkRelay::tcpPort() const
+{
+    return _tcpServer->isListening() ? _tcpServer->serverPort() : 0;
+}
+
+quint16 LinkRelay::udpPort() const
+{
+    return _udpSocket->state() == QAbstractSocket::BoundState ? _udpSocket->localPort() : 0;
+}
+
+void LinkRelay::close()
+{
+    const bool hadClients = clients();
+    for(auto socket : _tcpClients.keys()) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+    _tcpClients.clear();
+    _udpClients.clear();
+    _tcpServer->close();
+    _udpSocket->close();
+
+    if(hadClients) {
+        emit clientsChanged();
+    }
+}
+
+void LinkRelay::newConnections()
+{
+    while(_tcpServer->hasPendingConnections()) {
+        QTcpSocket* socket = _tcpServer->nextPendingConnection();
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        _tcpClients.insert(socket, {});
+        qCDebug(LINKRELAY) << "New TCP client:" << socket->peerAddress() << socket->peerPort();
+
+        connect(socket, &QIODevice::readyRead, this, [this, socket] { emit clientData(socket->readAll()); });
+        connect(socket, &QIODevice::bytesWritten, this, [this, socket] { flush(socket); });
+        connect(socket, &QAbstractSocket::disconnected, this, [this, socket] {
+            qCDebug(LINKRELAY) << "TCP client disconnected:" << socket->peerAddress() << socket->peerPort();
+            _tcpClients.remove(socket);
+            socket->deleteLater();
+            emit clientsChanged();
+        });
+        emit clientsChanged();
+    }
+}
+
+void LinkRelay::readDatagrams()
+{
+    while(_udpSocket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagram = _udpSocket->receiveDatagram();
+        if(!datagram.isValid()) {
+            break;
+        }
+
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        auto client = std::find_if(_udpClients.begin(), _udpClients.end(), [&datagram](const UdpClient& item) {
+            return item.address == datagram.senderAddress() && item.port == datagram.senderPort();
+        });
+        if(client != _udpClients.end()) {
+            client->lastSeen = now;
+        } else {
+            // Replace the client that was quiet for longer
+            if(_udpClients.size() >= maximumUdpClients) {
+                auto oldest = std::min_element(_udpClients.begin(), _udpClients.end(),
+                    [](const UdpClient& left, const UdpClient& right) { return left.lastSeen < right.lastSeen; });
+                _udpClients.erase(oldest);
+            }
+            qCDebug(LINKRELAY) << "New UDP client:" << datagram.senderAddress() << datagram.senderPort();
+            _udpClients.append({datagram.senderAddress(), static_cast<quint16>(datagram.senderPort()), now});
+            emit clientsChanged();
+        }
+
+        if(!datagram.data().isEmpty()) {
+            emit clientData(datagram.data());
+        }
+    }
+}
+
+void LinkRelay::send(const QByteArray& data)
+{
+    if(data.isEmpty()) {
+        return;
+    }
+
+    for(auto client = _tcpClients.begin(); client != _tcpClients.end(); ++client) {
+        // Drop the oldest complete buffers of a slow client, the head may be partially sent
+        while(client->queuedBytes + data.size() > maximumClientBytes && client->queue.size() > 1) {
+            const QByteArray dropped = client->queue.takeAt(1);
+            client->queuedBytes -= dropped.size();
+            client->droppedBytes += dropped.size();
+            _droppedBytes += dropped.size();
+        }
+        if(client->queuedBytes + data.size() > maximumClientBytes) {
+            client->droppedBytes += data.size();
+            _droppedBytes += data.size();
+            continue;
+        }
+
+        client->queue.enqueue(data);
+        client->queuedBytes += data.size();
+        flush(client.key());
+    }
+
+    for(auto& client : _udpClients) {
+        for(int offset = 0; offset < data.size(); offset += maximumDatagramSize) {
+            const int size = qMin(maximumDatagramSize, data.size() - offset);
+            if(_udpSocket->writeDatagram(data.constData() + offset, size, client.address, client.port) < 0) {
+                client.droppedBytes += size;
+                _droppedBytes += size;
+                continue;
+            }
+            _sentBytes += size;
+        }
+    }
+}
+
+void LinkRelay::flush(QTcpSocket* socket)
+{
+    auto client = _tcpClients.find(socket);
+    if(client == _tcpClients.end()) {
+        return;
+    }
+
+    while(!client->queue.isEmpty() && socket->bytesToWrite() < socketWriteWatermark) {
+        const QByteArray& head = client->queue.head();
+        const qint64 written = socket->write(head.constData() + client->offset, head.size() - client->offset);
+        if(written <= 0) {
+            return;
+        }
+
+        client->offset += written;
+        client->queuedBytes -= written;
+        _sentBytes += written;
+        if(client->offset == head.size()) {
+            client->queue.dequeue();
+            client->offset = 0;
+        }
+    }
+}
+
+QVariantMap LinkRelay::statistics() const
+{
+    return {
+        {"tcpClients", _tcpClients.size()},
+        {"udpClients", _udpClients.size()},
+        {"sentBytes", _sentBytes},
+        {"droppedBytes", _droppedBytes},
+    };
+}
+
+LinkRelay::~LinkRelay()
+{
+    close();
+}
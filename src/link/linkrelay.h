@@ -0,0 +1,167 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QLoggingCategory>
+#include <QObject>
+#include <QQueue>
+#include <QVariantMap>
+
+Q_DECLARE_LOGGING_CATEGORY(LINKRELAY)
+
+class QTcpServer;
+class QTcpSocket;
+class QUdpSocket;
+
+/**
+ * @brief Serve the raw byte stream of a link to local TCP and UDP clients
+ *  TCP clients connect to the TCP port, UDP clients are registered when a datagram arrives in the UDP port,
+ *  data sent by clients is provided by clientData to be forwarded to the sensor.
+ *  Buffers are implicitly shared between clients, each TCP client has a queue of references and the data is
+ *  moved into the socket only when it drains, a client that falls more than maximumClientBytes behind loses
+ *  its oldest buffers without affecting the others. UDP datagrams that the kernel can't take are dropped.
+ *
+ */
+class LinkRelay : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Construct a new Link Relay object
+     *
+     * @param parent
+     */
+    LinkRelay(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroy the Link Relay object
+     *
+     */
+    ~LinkRelay();
+
+    /**
+     * @brief Return the number of connected TCP clients and registered UDP clients
+     *
+     * @return int
+     */
+    int clients() const { return _tcpClients.size() + _udpClients.size(); };
+
+    /**
+     * @brief Close ports and disconnect all clients
+     *
+     */
+    void close();
+
+    /**
+     * @brief Return true if any port is open
+     *
+     * @return true
+     * @return false
+     */
+    bool isListening() const;
+
+    /**
+     * @brief Open the relay ports, previous ports are closed
+     *
+     * @param address
+     * @param tcpPort 0 to disable TCP
+     * @param udpPort 0 to disable UDP
+     * @return true all requested ports are open
+     * @return false
+     */
+    bool listen(const QHostAddress& address, quint16 tcpPort, quint16 udpPort);
+
+    /**
+     * @brief Send data to all clients
+     *
+     * @param data
+     */
+    void send(const QByteArray& data);
+
+    /**
+     * @brief Return relay statistics: clients, sent and dropped bytes
+     *
+     * @return QVariantMap
+     */
+    Q_INVOKABLE QVariantMap statistics() const;
+
+    /**
+     * @brief Return the TCP port in use
+     *
+     * @return quint16 0 if not listening
+     */
+    quint16 tcpPort() const;
+
+    /**
+     * @brief Return the UDP port in use
+     *
+     * @return quint16 0 if not bound
+     */
+    quint16 udpPort() const;
+
+    // Maximum data waiting for a TCP client
+    static const int maximumClientBytes = 1024 * 1024;
+    // Data is moved into the socket buffer below this mark
+    static const int socketWriteWatermark = 16 * 1024;
+    static const int maximumDatagramSize = 8192;
+    static const int maximumUdpClients = 64;
+
+signals:
+    /**
+     * @brief Emitted when a client sends data
+     *
+     * @param data
+     */
+    void clientData(const QByteArray& data);
+
+    /**
+     * @brief Emitted when a client connects or disconnects
+     *
+     */
+    void clientsChanged();
+
+private:
+    Q_DISABLE_COPY(LinkRelay)
+
+    struct TcpClient {
+        QQueue<QByteArray> queue;
+        // Bytes of the queue head already in the socket
+        int offset = 0;
+        qint64 queuedBytes = 0;
+        quint64 droppedBytes = 0;
+    };
+
+    struct UdpClient {
+        QHostAddress address;
+        quint16 port;
+        qint64 lastSeen;
+        quint64 droppedBytes = 0;
+    };
+
+    /**
+     * @brief Move queued data into the socket while it has room
+     *
+     * @param socket
+     */
+    void flush(QTcpSocket* socket);
+
+    /**
+     * @brief Accept new TCP clients
+     *
+     */
+    void newConnections();
+
+    /**
+     * @brief Read datagrams and register their senders
+     *
+     */
+    void readDatagrams();
+
+    QTcpServer* _tcpServer;
+    QUdpSocket* _udpSocket;
+    QHash<QTcpSocket*, TcpClient> _tcpClients;
+    QList<UdpClient> _udpClients;
+    quint64 _sentBytes = 0;
+    quint64 _droppedBytes = 0;
+};
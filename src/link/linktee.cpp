@@ -0,0 +1,137 @@
+#include <algorithm>
+
+#include <QMutexLocker>
+
+#include "abstractlink.h"
+#include "linktee.h"
+#include "logger.h"
+
+PING_LOGGING_CATEGORY(LINKTEE, "ping.linktee");
+
+LinkTee::LinkTee(QObject* parent)
+    : QObject(parent)
+{
+}
+
+int LinkTee::addSink(const QString& name, QObject* context, Consumer consumer, int capacity, OverflowPolicy policy)
+{
+    auto sink = std::make_shared<Sink>();
+    sink->id = _nextId++;
+    sink->name = name;
+    sink->context = context;
+    sink->consumer = std::move(consumer);
+    sink->capacity = qMax(0, capacity);
+    sink->policy = policy;
+    _sinks.push_back(sink);
+    qCDebug(LINKTEE) << "New sink:" << name << "capacity:" << sink->capacity;
+    return sink->id;
+}
+
+void LinkTee::removeSink(int id)
+{
+    const auto sink = std::find_if(_sinks.begin(), _sinks.end(), [id](const std::shared_ptr<Sink>& item) {
+        return item->id == id;
+    });
+    if(sink == _sinks.end()) {
+        return;
+    }
+
+    // A pending drain may still hold the sink
+    (*sink)->removed = true;
+    {
+        QMutexLocker locker(&(*sink)->mutex);
+        (*sink)->queue.clear();
+    }
+    _sinks.erase(sink);
+}
+
+void LinkTee::setSource(AbstractLink* link)
+{
+    if(_source) {
+        disconnect(_source, &AbstractLink::newData, this, &LinkTee::push);
+    }
+    _source = link;
+    if(_source) {
+        connect(_source, &AbstractLink::newData, this, &LinkTee::push);
+    }
+}
+
+void LinkTee::push(const QByteArray& data)
+{
+    for(const auto& sink : _sinks) {
+        if(!sink->context) {
+            continue;
+        }
+
+        if(!sink->capacity) {
+            sink->consumer(data);
+            sink->delivered++;
+            continue;
+        }
+
+        bool schedule;
+        {
+            QMutexLocker locker(&sink->mutex);
+            if(sink->queue.size() >= sink->capacity) {
+                sink->dropped++;
+                if(sink->policy == DropNewest) {
+                    continue;
+                }
+                sink->queue.dequeue();
+            }
+            sink->queue.enqueue(data);
+            schedule = !sink->scheduled;
+            sink->scheduled = true;
+        }
+
+        if(schedule) {
+            QMetaObject::invokeMethod(sink->context, [sink] { drain(sink); }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void LinkTee::drain(const std::shared_ptr<Sink>& sink)
+{
+    QQueue<QByteArray> queue;
+    while(!sink->removed) {
+        {
+            QMutexLocker locker(&sink->mutex);
+            if(sink->queue.isEmpty()) {
+                sink->scheduled = false;
+                return;
+            }
+            queue.swap(sink->queue);
+        }
+
+        // The lock is not held while consuming, push can add new buffers
+        while(!queue.isEmpty() && !sink->removed) {
+            sink->consumer(queue.dequeue());
+            sink->delivered++;
+        }
+    }
+}
+
+QVariantMap LinkTee::statistics() const
+{
+    QVariantMap statistics;
+    for(const auto& sink : _sinks) {
+        int queued;
+        {
+            QMutexLocker locker(&sink->mutex);
+            queued = sink->queue.size();
+        }
+        statistics[sink->name] = QVariantMap{
+            {"delivered", sink->delivered.load()},
+            {"dropped", sink->dropped.load()},
+            {"queued", queued},
+        };
+    }
+    return statistics;
+}
+
+LinkTee::~LinkTee()
+{
+    for(const auto& sink : _sinks) {
+        sink->removed = true;
+    }
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QByteArray>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QVariantMap>
+
+Q_DECLARE_LOGGING_CATEGORY(LINKTEE)
+
+class AbstractLink;
+
+/**
+ * @brief Deliver the data received by a link to any number of sinks (parser, log, relays, recorders)
+ *  Buffers are implicitly shared, sinks receive the same data without copies.
+ *  Each sink has its own bounded queue and is called in the thread of its context object,
+ *  when a sink falls behind its queue overflows following its policy and the other sinks are not affected.
+ *  Sinks without queue are called directly by push, it should be used only for fast consumers (e.g. the parser).
+ *
+ */
+class LinkTee : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief What to do when a buffer arrives and the queue of a sink is full
+     *
+     */
+    enum OverflowPolicy {
+        // Drop the oldest buffer of the queue, the sink receives the latest data
+        DropOldest,
+        // Drop the new buffer, the sink receives a continuous stream until the overflow
+        DropNewest,
+    };
+
+    using Consumer = std::function<void(const QByteArray&)>;
+
+    /**
+     * @brief Construct a new Link Tee object
+     *
+     * @param parent
+     */
+    LinkTee(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroy the Link Tee object
+     *
+     */
+    ~LinkTee();
+
+    /**
+     * @brief Add a sink
+     *
+     * @param name used in statistics
+     * @param context the consumer is called in the thread of this object, and the sink stops when it's destroyed
+     * @param consumer
+     * @param capacity maximum number of queued buffers, 0 to call the consumer directly
+     * @param policy
+     * @return int sink id
+     */
+    int addSink(const QString& name, QObject* context, Consumer consumer, int capacity = defaultCapacity,
+                OverflowPolicy policy = DropOldest);
+
+    /**
+     * @brief Remove a sink, queued buffers are discarded
+     *
+     * @param id
+     */
+    void removeSink(int id);
+
+    /**
+     * @brief Set the link that provides data, replacing the previous one
+     *
+     * @param link
+     */
+    void setSource(AbstractLink* link);
+
+    /**
+     * @brief Return delivered, dropped and queued buffers of each sink
+     *
+     * @return QVariantMap sink name and its counters
+     */
+    QVariantMap statistics() const;
+
+    /**
+     * @brief Deliver data to all sinks
+     *
+     * @param data
+     */
+    void push(const QByteArray& data);
+
+    static const int defaultCapacity = 256;
+
+private:
+    Q_DISABLE_COPY(LinkTee)
+
+    struct Sink {
+        int id;
+        QString name;
+        QPointer<QObject> context;
+        Consumer consumer;
+        int capacity;
+        OverflowPolicy policy;
+
+        QMutex mutex;
+        QQueue<QByteArray> queue;
+        // A drain is pending in the thread of the context
+        bool scheduled = false;
+        std::atomic<bool> removed{false};
+
+        std::atomic<quint64> delivered{0};
+        std::atomic<quint64> dropped{0};
+    };
+
+    /**
+     * @brief Call the consumer with all queued buffers, runs in the thread of the sink context
+     *
+     * @param sink
+     */
+    static void drain(const std::shared_ptr<Sink>& sink);
+
+    int _nextId = 0;
+    std::vector<std::shared_ptr<Sink>> _sinks;
+    QPointer<AbstractLink> _source;
+};
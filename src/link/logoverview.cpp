@@ -0,0 +1,234 @@
+#include <QDataStream>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThread>
+#include <QtConcurrent>
+
+#include "logger.h"
+#include "logoverview.h"
+#include "parser-ping.h"
+#include "sensorlogsession.h"
+
+PING_LOGGING_CATEGORY(LOGOVERVIEW, "ping.logoverview")
+
+const QByteArray LogOverview::_cacheMagic = QByteArrayLiteral("PINGOVW");
+const quint32 LogOverview::_cacheVersion = 1;
+
+LogOverview::LogOverview(QObject* parent)
+    : QObject(parent)
+    , _messageStatistics{}
+    , _waterfall(columns, rows, QImage::Format_Grayscale8)
+    , _depth(columns, -1)
+{
+    _waterfall.fill(0);
+}
+
+void LogOverview::build(SensorLogSession* session, const QString& fileName)
+{
+    cancel();
+    _session = session;
+    _fileName = fileName;
+
+    if(!_fileName.isEmpty() && loadCache()) {
+        qCDebug(LOGOVERVIEW) << "Overview loaded from cache:" << _fileName;
+        emit updated();
+        return;
+    }
+
+    _abort = false;
+    _building = true;
+    _future = QtConcurrent::run([this] { process(); });
+}
+
+void LogOverview::cancel()
+{
+    _abort = true;
+    _future.waitForFinished();
+    _building = false;
+}
+
+QImage LogOverview::waterfall() const
+{
+    QMutexLocker locker(&_mutex);
+    return _waterfall;
+}
+
+QVector<float> LogOverview::depth() const
+{
+    QMutexLocker locker(&_mutex);
+    return _depth;
+}
+
+float LogOverview::maxDepth() const
+{
+    QMutexLocker locker(&_mutex);
+    return _maxDepth;
+}
+
+void LogOverview::process()
+{
+    // The time interval of each column depends on the duration of the whole session,
+    // the logs are decimated in a second pass after all of them are indexed.
+    // The wait is polled, cancel should not wait for the index of large logs
+    while(_session->isIndexing() && !_abort) {
+        QThread::msleep(indexPollIntervalMs);
+    }
+    const int size = _session->size();
+    if(!size || _abort) {
+        _building = false;
+        return;
+    }
+
+    const qint64 firstTimestamp = _session->timestamp(0);
+    const qint64 duration = qMax<qint64>(1, _session->timestamp(size - 1) - firstTimestamp);
+
+    static constexpr Dispatch dispatch{{
+            &LogOverview::handleDistance,
+            &LogOverview::handleDistanceSimple,
+            &LogOverview::handleProfile,
+            &LogOverview::handlePing360DeviceData,
+        }};
+
+    PingParserExt parser;
+    connect(&parser, &Parser::newMessage, [this](const ping_message& msg) {
+        dispatch.call(this, msg, _messageStatistics);
+    });
+
+    // Notify the interface every few columns
+    static const int updateColumns = 32;
+    int updatedColumn = 0;
+    _column = 0;
+    for(int i = 0; i < size && !_abort; i++) {
+        const int column = qBound<qint64>(0, (_session->timestamp(i) - firstTimestamp) * columns / duration, columns - 1);
+        if(column != _column) {
+            finishColumn();
+            _column = column;
+        }
+        parser.parseBuffer(_session->packet(i));
+
+        if(_column - updatedColumn >= updateColumns) {
+            updatedColumn = _column;
+            emit updated();
+        }
+    }
+    finishColumn();
+
+    if(!_abort && !_fileName.isEmpty()) {
+        saveCache();
+    }
+    _building = false;
+    emit updated();
+}
+
+void LogOverview::addProfile(const uint8_t* data, int length)
+{
+    if(length <= 0) {
+        return;
+    }
+
+    // Keep the maximum intensity of each pixel, targets are not lost with decimation
+    QMutexLocker locker(&_mutex);
+    for(int sample = 0; sample < length; sample++) {
+        uchar* pixel = _waterfall.scanLine(sample * rows / length) + _column;
+        *pixel = qMax(*pixel, data[sample]);
+    }
+}
+
+void LogOverview::addDistance(uint32_t distance)
+{
+    _depthSum += distance;
+    _depthCount++;
+}
+
+void LogOverview::finishColumn()
+{
+    if(!_depthCount) {
+        return;
+    }
+
+    const float columnDepth = _depthSum / _depthCount / 1000;
+    _depthSum = 0;
+    _depthCount = 0;
+
+    QMutexLocker locker(&_mutex);
+    _depth[_column] = columnDepth;
+    _maxDepth = qMax(_maxDepth, columnDepth);
+}
+
+void LogOverview::handleDistance(const ping_message& msg)
+{
+    const ping1d_distance m(msg);
+    addDistance(m.distance());
+}
+
+void LogOverview::handleDistanceSimple(const ping_message& msg)
+{
+    const ping1d_distance_simple m(msg);
+    addDistance(m.distance());
+}
+
+void LogOverview::handleProfile(const ping_message& msg)
+{
+    const ping1d_profile m(msg);
+    addDistance(m.distance());
+    addProfile(m.profile_data(), m.profile_data_length());
+}
+
+void LogOverview::handlePing360DeviceData(const ping_message& msg)
+{
+    const ping360_device_data m(msg);
+    addProfile(m.data(), m.data_length());
+}
+
+bool LogOverview::loadCache()
+{
+    QFile cacheFile(_fileName + ".overview");
+    if(!cacheFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&cacheFile);
+    QByteArray magic;
+    quint32 version;
+    qint64 fileSize;
+    qint64 lastModified;
+    QImage waterfall;
+    QVector<float> depth;
+    float maxDepth;
+    in >> magic >> version >> fileSize >> lastModified >> waterfall >> depth >> maxDepth;
+
+    const QFileInfo logInfo(_fileName);
+    if(in.status() != QDataStream::Ok || magic != _cacheMagic || version != _cacheVersion
+            || fileSize != logInfo.size() || lastModified != logInfo.lastModified().toMSecsSinceEpoch()
+            || waterfall.size() != QSize(columns, rows) || depth.size() != columns) {
+        qCDebug(LOGOVERVIEW) << "Overview cache is invalid:" << cacheFile.fileName();
+        return false;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _waterfall = waterfall.convertToFormat(QImage::Format_Grayscale8);
+    _depth = depth;
+    _maxDepth = maxDepth;
+    return true;
+}
+
+void LogOverview::saveCache() const
+{
+    QSaveFile cacheFile(_fileName + ".overview");
+    if(!cacheFile.open(QIODevice::WriteOnly)) {
+        qCDebug(LOGOVERVIEW) << "Not possible to save overview cache:" << cacheFile.fileName();
+        return;
+    }
+
+    const QFileInfo logInfo(_fileName);
+    QDataStream out(&cacheFile);
+    QMutexLocker locker(&_mutex);
+    out << _cacheMagic << _cacheVersion << logInfo.size() << logInfo.lastModified().toMSecsSinceEpoch()
+        << _waterfall << _depth << _maxDepth;
+    cacheFile.commit();
+}
+
+LogOverview::~LogOverview()
+{
+    cancel();
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+
+#include <QFuture>
+#include <QImage>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+
+#include "messagedispatchtable.h"
+#include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+
+Q_DECLARE_LOGGING_CATEGORY(LOGOVERVIEW)
+
+class SensorLogSession;
+
+/**
+ * @brief Low resolution overview of a sensor log
+ *  The whole log is decimated in background after it's indexed, to a fixed number of columns, each column has
+ *  the maximum intensity of all profiles inside its time interval (waterfall) and the mean distance of the
+ *  Ping1D messages (depth track).
+ *  The overview is cached next to the log file (log name + .overview).
+ *
+ */
+class LogOverview : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Construct a new Log Overview object
+     *
+     * @param parent
+     */
+    LogOverview(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroy the Log Overview object
+     *
+     */
+    ~LogOverview();
+
+    /**
+     * @brief Load overview from cache or build it in background
+     *  The session should be valid until cancel is called or the overview is finished
+     *
+     * @param session
+     * @param fileName log file name used for the cache, empty to disable it (e.g. sessions with multiple logs)
+     */
+    void build(SensorLogSession* session, const QString& fileName);
+
+    /**
+     * @brief Stop building the overview
+     *
+     */
+    void cancel();
+
+    /**
+     * @brief Return true while the overview is being built
+     *
+     * @return true
+     * @return false
+     */
+    bool isBuilding() const { return _building; }
+
+    /**
+     * @brief Return waterfall, Grayscale8 image with columns x rows, time in x and profile samples in y
+     *
+     * @return QImage
+     */
+    QImage waterfall() const;
+
+    /**
+     * @brief Return depth track in meters, one value per column, negative if there is no distance
+     *
+     * @return QVector<float>
+     */
+    QVector<float> depth() const;
+
+    /**
+     * @brief Return maximum value of depth track in meters
+     *
+     * @return float
+     */
+    float maxDepth() const;
+
+    static const int columns = 1024;
+    static const int rows = 64;
+    // Interval used to check if the session index is ready
+    static const int indexPollIntervalMs = 10;
+
+signals:
+    /**
+     * @brief Overview has new data, emitted from the worker thread
+     *
+     */
+    void updated();
+
+private:
+    Q_DISABLE_COPY(LogOverview)
+
+    /**
+     * @brief Decimate log, runs in a worker thread
+     *
+     */
+    void process();
+
+    /**
+     * @brief Add profile samples to the actual column
+     *
+     * @param data
+     * @param length
+     */
+    void addProfile(const uint8_t* data, int length);
+
+    /**
+     * @brief Add distance to the actual column
+     *
+     * @param distance mm
+     */
+    void addDistance(uint32_t distance);
+
+    /**
+     * @brief Update depth track with the distances of the actual column
+     *
+     */
+    void finishColumn();
+
+    bool loadCache();
+    void saveCache() const;
+
+    void handleDistance(const ping_message& msg);
+    void handleDistanceSimple(const ping_message& msg);
+    void handleProfile(const ping_message& msg);
+    void handlePing360DeviceData(const ping_message& msg);
+
+    using Dispatch = MessageDispatchTable<LogOverview,
+          Ping1dId::DISTANCE,
+          Ping1dId::DISTANCE_SIMPLE,
+          Ping1dId::PROFILE,
+          Ping360Id::DEVICE_DATA
+          >;
+    Dispatch::Statistics _messageStatistics;
+
+    SensorLogSession* _session = nullptr;
+    QString _fileName;
+
+    mutable QMutex _mutex;
+    QImage _waterfall;
+    QVector<float> _depth;
+    float _maxDepth = 0;
+
+    // Worker state
+    int _column = 0;
+    double _depthSum = 0;
+    int _depthCount = 0;
+
+    QFuture<void> _future;
+    std::atomic<bool> _building{false};
+    std::atomic<bool> _abort{false};
+
+    static const QByteArray _cacheMagic;
+    static const quint32 _cacheVersion;
+};
@@ -1,68 +1,222 @@
 #include <QDebug>
+#include <QtGlobal>
 
 #include "logger.h"
 #include "logthread.h"
+#include "sensorlogsession.h"
 
 PING_LOGGING_CATEGORY(LOGTHREAD, "ping.logthread");
 
 LogThread::LogThread(QObject *parent)
     :QTimer(parent)
+    ,_session(nullptr)
     ,_logIndex(0)
     ,_playLog(true)
 {
     setSingleShot(true);
+    setTimerType(Qt::PreciseTimer);
     connect(this, &QTimer::timeout, this, &LogThread::processJob);
 }
 
+void LogThread::anchor()
+{
+    _anchorTimestamp = _session->timestamp(_logIndex);
+    _playClock.start();
+    _anchored = true;
+}
+
 void LogThread::processJob()
 {
-    // Check for pause condition and valid log index
-    if(!_playLog) {
+    if(!_session) {
         return;
     }
 
-    static int lastMSecs = 0;
-    QByteArray& data = _log[_logIndex].data;
-    lastMSecs = _log[_logIndex].time.msecsSinceStartOfDay();
-    emit packageIndexChanged(_logIndex);
-    emit newPackage(data);
+    if(_seekPending) {
+        processSeek();
+    }
+
+    // Check for pause condition, the pre-roll of a seek is done even when paused
+    if(!_playLog && _logIndex >= _prerollEnd) {
+        return;
+    }
+
+    // Index is still being built in background, wait for more packets
+    static const int waitIndexMSecs = 50;
+    if(_logIndex >= _session->size()) {
+        if(_session->isIndexing()) {
+            start(waitIndexMSecs);
+        }
+        return;
+    }
+
+    // Return to the event loop after this time, allowing the interface to be updated
+    static const qint64 jobBudgetNSecs = 20 * 1000000;
+    // Playback is re-anchored if it's behind the schedule by more than this time
+    static const qint64 maximumLagNSecs = 1000 * 1000000;
+
+    QElapsedTimer jobTimer;
+    jobTimer.start();
+    const int startIndex = packageIndex();
+    while(_logIndex < _session->size()) {
+        const bool preroll = _logIndex < _prerollEnd;
+
+        // A slot may have paused the playback
+        if(!preroll && !_playLog) {
+            break;
+        }
+
+        if(!preroll && _rate > 0) {
+            const qint64 timestamp = _session->timestamp(_logIndex);
+            if(!_anchored) {
+                anchor();
+            } else if(_logIndex > 0 && timestamp < _session->timestamp(_logIndex - 1)) {
+                qCWarning(LOGTHREAD) << "Sample time is negative from previous sample! Trying to recover..";
+                qCDebug(LOGTHREAD) << "Actual index:" << _logIndex
+                                   << "Time[n-1, n]:" << packageTime(_logIndex - 1) << packageTime(_logIndex);
+                anchor();
+            }
+
+            const qint64 dueNSecs = (timestamp - _anchorTimestamp) / _rate;
+            const qint64 lateNSecs = _playClock.nsecsElapsed() - dueNSecs;
+            if(lateNSecs < 0) {
+                // Round up, the timer is not allowed to fire before the packet is due
+                start((-lateNSecs + 999999) / 1000000);
+                break;
+            }
+            if(lateNSecs > maximumLagNSecs) {
+                qCDebug(LOGTHREAD) << "Playback is late by" << lateNSecs / 1000000 << "ms, moving anchor.";
+                anchor();
+            }
+        }
 
-    // Check if we have data before sending
-    if(_logIndex < _log.size() - 1) {
-        static int diffMSecs;
+        emit newPackage(_session->packet(_logIndex));
         _logIndex++;
-        diffMSecs = _log[_logIndex].time.msecsSinceStartOfDay() - lastMSecs;
-
-        // Something is wrong, we need to go 'back to the future'
-        if(diffMSecs < 0) {
-            qCWarning(LOGTHREAD) << "Sample time is negative from previous sample! Trying to recover..";
-            qCDebug(LOGTHREAD) << "First time:" << _log.constFirst().time;
-            qCDebug(LOGTHREAD) << "Last time:" << _log.constLast().time;
-            qCDebug(LOGTHREAD) << "Actual index:" << _logIndex
-                               << "Time[n-1, n]:" << _log[_logIndex - 1].time << _log[_logIndex].time;
-            processJob();
-            return;
+
+        if(jobTimer.nsecsElapsed() > jobBudgetNSecs) {
+            start(0);
+            break;
         }
-        start(diffMSecs/10);
+    }
+
+    if(_prerollEnd && _logIndex >= _prerollEnd) {
+        _prerollEnd = 0;
+    }
+
+    if(packageIndex() != startIndex) {
+        emit packageIndexChanged(packageIndex());
+    }
+
+    if((_playLog || _prerollEnd) && _logIndex >= _session->size() && _session->isIndexing()) {
+        start(waitIndexMSecs);
     }
 }
 
-QTime LogThread::totalTime()
+void LogThread::processSeek()
 {
-    int totalMSecs = _log.constLast().time.msecsSinceStartOfDay() - _log.constFirst().time.msecsSinceStartOfDay();
-    return QTime::fromMSecsSinceStartOfDay(totalMSecs);
+    _seekPending = false;
+    if(!_session->size()) {
+        return;
+    }
+
+    // Pre-roll duration, enough for a waterfall or a full sector of history
+    static const qint64 prerollNSecs = 30ll * 1000 * 1000000;
+
+    const qint64 target = _session->timestamp(0) + _seekMSecs * 1000000;
+    const int index = qMin(_session->indexAt(target), _session->size() - 1);
+    const int prerollStart = _session->keyframeIndex(qMin(_session->indexAt(target - prerollNSecs), index));
+    qCDebug(LOGTHREAD) << "Seek to" << _seekMSecs << "ms, index:" << index << "pre-roll from:" << prerollStart;
+
+    _logIndex = prerollStart;
+    // The packet in the target is part of the pre-roll, it's displayed even when paused
+    _prerollEnd = index + 1;
+    _anchored = false;
+    emit seeked();
 }
 
-QTime LogThread::elapsedTime()
+void LogThread::seek(qint64 msecs)
+{
+    if(!_session) {
+        return;
+    }
+
+    // The seek is done in the next job, seeks before it replace the target
+    _seekMSecs = qMax<qint64>(0, msecs);
+    _seekPending = true;
+    start(0);
+}
+
+void LogThread::setRate(double rate)
+{
+    _rate = rate <= 0 ? 0 : qBound(minimumRate, rate, maximumRate);
+    _anchored = false;
+    if(_playLog && _session) {
+        start(0);
+    }
+}
+
+void LogThread::step(int packets)
+{
+    pauseJob();
+    if(!_session || !_session->size()) {
+        return;
+    }
+
+    // _logIndex is the next packet to be sent
+    const int index = qBound(0, packageIndex() - 1 + packets, _session->size() - 1);
+    _seekPending = false;
+    _prerollEnd = 0;
+    emit newPackage(_session->packet(index));
+    _logIndex = index + 1;
+    emit packageIndexChanged(_logIndex);
+}
+
+int LogThread::packageSize()
+{
+    return _session ? _session->size() - 1 : 0;
+}
+
+void LogThread::setPackageIndex(int index)
+{
+    if(_session && index >= 0 && index < _session->size()) {
+        _logIndex = index;
+        _prerollEnd = 0;
+        _anchored = false;
+    }
+}
+
+qint64 LogThread::packageTime(int index)
+{
+    if(!_session || !_session->size()) {
+        return 0;
+    }
+    return _session->timestamp(index) - _session->timestamp(0);
+}
+
+qint64 LogThread::totalTimeMs()
+{
+    return _session ? packageTime(_session->size() - 1) / 1000000 : 0;
+}
+
+qint64 LogThread::elapsedTimeMs()
 {
-    if(_logIndex < 0) {
-        return QTime::fromMSecsSinceStartOfDay(0);
-    } else if(_logIndex >= _log.size()) {
-        return totalTime();
+    const int index = packageIndex();
+    if(!_session || index < 0) {
+        return 0;
+    } else if(index >= _session->size()) {
+        return totalTimeMs();
     }
 
-    int elapsedMSecs = _log[_logIndex].time.msecsSinceStartOfDay() - _log.constFirst().time.msecsSinceStartOfDay();
-    return QTime::fromMSecsSinceStartOfDay(elapsedMSecs);
+    return packageTime(index) / 1000000;
+}
+
+QTime LogThread::totalTime()
+{
+    return QTime::fromMSecsSinceStartOfDay(totalTimeMs());
+}
+
+QTime LogThread::elapsedTime()
+{
+    return QTime::fromMSecsSinceStartOfDay(elapsedTimeMs());
 }
 
-LogThread::~LogThread() = default;
\ No newline at end of file
+LogThread::~LogThread() = default;
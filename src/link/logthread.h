@@ -1,15 +1,21 @@
 #pragma once
 
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 #include <QTime>
 #include <QTimer>
-#include <QVector>
 
 Q_DECLARE_LOGGING_CATEGORY(LOGTHREAD)
 
+class SensorLogSession;
+
 /**
  * @brief Play sensor logs
+ *  Packets are scheduled from an anchor: the log timestamp and the clock when the playback (re)started,
+ *  each packet is due when (timestamp - anchor timestamp) / rate has elapsed in the clock.
+ *  Timer jitter does not accumulate since all packets that are due are sent in the same job,
+ *  and the anchor is moved if the playback falls too far behind (e.g. slow consumers).
  *
  */
 class LogThread : public QTimer
@@ -30,12 +36,18 @@ public:
     ~LogThread();
 
     /**
-     * @brief Append new log message
+     * @brief Set the log session, packets are decoded when played
      *
-     * @param time
-     * @param data
+     * @param session
      */
-    void append(QTime time, QByteArray data) { _log.append(Pack{time, data}); };
+    void setSession(SensorLogSession* session)
+    {
+        _session = session;
+        _logIndex = 0;
+        _prerollEnd = 0;
+        _seekPending = false;
+        _anchored = false;
+    }
 
     /**
      * @brief Return log elapsed time
@@ -44,38 +56,77 @@ public:
      */
     QTime elapsedTime();
 
+    /**
+     * @brief Return log elapsed time in milliseconds
+     *
+     * @return qint64
+     */
+    qint64 elapsedTimeMs();
+
     /**
      * @brief Return last package index
      *
      * @return int
      */
-    int packageIndex() { return _logIndex; }
+    int packageIndex() { return _prerollEnd > _logIndex ? _prerollEnd : _logIndex; }
 
     /**
      * @brief Return package size
      *
      * @return int
      */
-    int packageSize() { return _log.size() - 1; };
+    int packageSize();
 
     /**
      * @brief Pause log
      *
      */
-    void pauseJob() { _playLog = false; };
+    void pauseJob() { _playLog = false; stop(); };
+
+    /**
+     * @brief Return replay rate
+     *
+     * @return double 1 for real time, 0 for unthrottled
+     */
+    double rate() const { return _rate; }
 
     /**
      * @brief Set the package index
      *
      * @param index
      */
-    void setPackageIndex(int index) { if(_logIndex < _log.size()) _logIndex = index; }
+    void setPackageIndex(int index);
+
+    /**
+     * @brief Seek to a time of the log
+     *  Consecutive seeks are coalesced and only the last one is done.
+     *  Packets before the target are sent unthrottled from the nearest keyframe (pre-roll),
+     *  allowing sensors and visualizers to rebuild their history.
+     *
+     * @param msecs time from the start of the log
+     */
+    void seek(qint64 msecs);
+
+    /**
+     * @brief Set the replay rate
+     *  Unthrottled playback sends packets as fast as the connected slots process them.
+     *
+     * @param rate between minimumRate and maximumRate, 0 for unthrottled
+     */
+    void setRate(double rate);
 
     /**
      * @brief Start playing log
      *
      */
-    void startJob() { _playLog = true; start();};
+    void startJob() { _playLog = true; _anchored = false; start(0);};
+
+    /**
+     * @brief Pause and send a single packet relative to the last one sent
+     *
+     * @param packets 1 for the next packet, -1 for the previous one
+     */
+    void step(int packets);
 
     /**
      * @brief Return total time of log
@@ -84,19 +135,60 @@ public:
      */
     QTime totalTime();
 
+    /**
+     * @brief Return total time of log in milliseconds
+     *
+     * @return qint64
+     */
+    qint64 totalTimeMs();
+
+    static constexpr double minimumRate = 0.1;
+    static constexpr double maximumRate = 1000;
+
 signals:
     void newPackage(const QByteArray& data);
     void packageIndexChanged(int index);
 
+    /**
+     * @brief Emitted before the pre-roll packets of a seek
+     *
+     */
+    void seeked();
+
 private:
+    /**
+     * @brief Use the actual packet and clock as reference for the next packets
+     *
+     */
+    void anchor();
+
     void processJob();
 
-    struct Pack {
-        QTime time;
-        QByteArray data;
-    };
+    /**
+     * @brief Move to the pending seek target and start the pre-roll
+     *
+     */
+    void processSeek();
 
-    QVector<Pack> _log;
+    /**
+     * @brief Return packet time from the start of the log
+     *
+     * @param index
+     * @return qint64 nanoseconds
+     */
+    qint64 packageTime(int index);
+
+    SensorLogSession* _session;
     int _logIndex;
     bool _playLog;
+
+    double _rate = 10;
+    bool _anchored = false;
+    qint64 _anchorTimestamp = 0;
+    QElapsedTimer _playClock;
+
+    // Pre-roll packets are sent unthrottled until this index
+    int _prerollEnd = 0;
+    bool _seekPending = false;
+    qint64 _seekMSecs = 0;
 };
@@ -2,26 +2,30 @@
 
 #include "ping1dsimulationlink.h"
 #include <ping-message-ping1d.h>
+#include "pingchecksum.h"
 
 Ping1DSimulationLink::Ping1DSimulationLink(QObject* parent)
-    : SimulationLink(parent)
+    : SimulationLink(defaultSamples, parent)
 {
-    connect(&_randomUpdateTimer, &QTimer::timeout, this, &Ping1DSimulationLink::randomUpdate);
-    _randomUpdateTimer.start(50);
 }
 
-void Ping1DSimulationLink::randomUpdate()
+void Ping1DSimulationLink::appendMessage(QByteArray& buffer, uint counter)
 {
-    static uint counter = 1;
-    static const float numPoints = 200;
     static const float maxDepth = 70000;
-    const float stop1 = numPoints / 2.0 - 10 * qSin(counter / 10.0);
-    const float stop2 = 3 * numPoints / 5.0 + 6 * qCos(counter / 5.5);
+    const int numPoints = samples();
+    // Shape is defined for 200 points and scaled to the profile size
+    const float scale = numPoints / 200.0f;
+    const float stop1 = numPoints / 2.0 - 10 * scale * qSin(counter / 10.0);
+    const float stop2 = 3 * numPoints / 5.0 + 6 * scale * qCos(counter / 5.5);
     const float osc =  maxDepth*(1.3 + qCos(counter / 40.0)) / 2.3;
 
-    uint8_t conf = 400 / (stop2 - stop1);
+    uint8_t conf = qMin(100.0f, 400 * scale / (stop2 - stop1));
 
-    static ping1d_profile profile(numPoints);
+    if(!_profile || _messageSamples != numPoints) {
+        _profile.reset(new ping1d_profile(numPoints));
+        _messageSamples = numPoints;
+    }
+    ping1d_profile& profile = *_profile;
 
     profile.set_distance(osc*(stop2+stop1)/(numPoints*2));
     profile.set_confidence(conf);
@@ -32,20 +36,10 @@ void Ping1DSimulationLink::randomUpdate()
     profile.set_gain_setting(4);
     profile.set_profile_data_length(numPoints);
 
-    for (int i = 0; i < numPoints; i++) {
-        float point;
-        if (i < stop1) {
-            point = 0.1 * (qrand()%256);
-        } else if (i < stop2) {
-            point = 255 * ((-4.0 / qPow((stop2-stop1), 2.0)) * qPow((i - stop1 - ((stop2-stop1) / 2.0)), 2.0)  + 1.0);
-        } else {
-            point = 0.45 * (qrand()%256);
-        }
-        profile.set_profile_data_at(i, point);
-    }
-
-    profile.updateChecksum();
-    emit newData(QByteArray(reinterpret_cast<const char*>(profile.msgData), profile.msgDataLength()));
+    fillProfile(profile.profile_data(), numPoints, stop1, stop2);
 
-    counter++;
+    PingChecksum::update(profile);
+    buffer.append(reinterpret_cast<const char*>(profile.msgData), profile.msgDataLength());
 }
+
+Ping1DSimulationLink::~Ping1DSimulationLink() = default;
@@ -1,8 +1,11 @@
 #pragma once
 
-#include <QTimer>
+#include <memory>
+
 #include "simulationlink.h"
 
+class ping1d_profile;
+
 /**
  * @brief Link that simulates Ping sensor behaviour
  *
@@ -18,11 +21,23 @@ public:
     Ping1DSimulationLink(QObject* parent = nullptr);
 
     /**
-     * @brief Generates random data
+     * @brief Destroy the Ping1D Simulation Link object
+     *
+     */
+    ~Ping1DSimulationLink();
+
+    static const int defaultSamples = 200;
+
+protected:
+    /**
+     * @brief Append a simulated profile message
      *
+     * @param buffer
+     * @param counter
      */
-    void randomUpdate();
+    void appendMessage(QByteArray& buffer, uint counter) final;
 
 private:
-    QTimer _randomUpdateTimer;
+    int _messageSamples = 0;
+    std::unique_ptr<ping1d_profile> _profile;
 };
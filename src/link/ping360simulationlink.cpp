@@ -2,24 +2,29 @@
 
 #include "ping360simulationlink.h"
 #include "ping-message-ping360.h"
+#include "pingchecksum.h"
 
 Ping360SimulationLink::Ping360SimulationLink(QObject* parent)
-    : SimulationLink(parent)
+    : SimulationLink(defaultSamples, parent)
 {
-    connect(&_randomUpdateTimer, &QTimer::timeout, this, &Ping360SimulationLink::randomUpdate);
-    _randomUpdateTimer.start(50);
 }
 
-void Ping360SimulationLink::randomUpdate()
+void Ping360SimulationLink::appendMessage(QByteArray& buffer, uint counter)
 {
-    static uint counter = 1;
-    static const float numberOfSamples = 1200;
     static const int angularResolution = 400;
+    const int numberOfSamples = samples();
+    // Shape is defined for 1200 samples and scaled to the profile size
+    const float scale = numberOfSamples / 1200.0f;
 
-    const float stop1 = numberOfSamples / 2.0 - 10 * qSin(counter / 10.0);
-    const float stop2 = 3 * numberOfSamples / 5.0 + 6 * qCos(counter / 5.5);
+    const float stop1 = numberOfSamples / 2.0 - 10 * scale * qSin(counter / 10.0);
+    const float stop2 = 3 * numberOfSamples / 5.0 + 6 * scale * qCos(counter / 5.5);
+
+    if(!_deviceData || _messageSamples != numberOfSamples) {
+        _deviceData.reset(new ping360_device_data(numberOfSamples));
+        _messageSamples = numberOfSamples;
+    }
+    ping360_device_data& deviceData = *_deviceData;
 
-    static ping360_device_data deviceData(numberOfSamples);
     deviceData.set_mode(0);
     deviceData.set_gain_setting(1);
     deviceData.set_angle(counter%angularResolution);
@@ -28,20 +33,10 @@ void Ping360SimulationLink::randomUpdate()
     deviceData.set_number_of_samples(numberOfSamples);
     deviceData.set_data_length(numberOfSamples);
 
-    for (int i = 0; i < numberOfSamples; i++) {
-        float point;
-        if (i < stop1) {
-            point = 0.1 * (qrand()%256);
-        } else if (i < stop2) {
-            point = 255 * ((-4.0 / qPow((stop2-stop1), 2.0)) * qPow((i - stop1 - ((stop2-stop1) / 2.0)), 2.0)  + 1.0);
-        } else {
-            point = 0.45 * (qrand()%256);
-        }
-        deviceData.set_data_at(i, point);
-    }
+    fillProfile(deviceData.data(), numberOfSamples, stop1, stop2);
 
-    deviceData.updateChecksum();
-    emit newData(QByteArray(reinterpret_cast<const char*>(deviceData.msgData), deviceData.msgDataLength()));
-
-    counter++;
+    PingChecksum::update(deviceData);
+    buffer.append(reinterpret_cast<const char*>(deviceData.msgData), deviceData.msgDataLength());
 }
+
+Ping360SimulationLink::~Ping360SimulationLink() = default;
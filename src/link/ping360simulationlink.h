@@ -1,28 +1,43 @@
 #pragma once
 
-#include <QTimer>
+#include <memory>
+
 #include "simulationlink.h"
 
+class ping360_device_data;
+
 /**
- * @brief Link that simulates Ping sensor behaviour
+ * @brief Link that simulates Ping360 sensor behaviour
  *
  */
 class Ping360SimulationLink : public SimulationLink
 {
 public:
     /**
-     * @brief Construct a new Ping1D Simulation Link object
+     * @brief Construct a new Ping360 Simulation Link object
      *
      * @param parent
      */
     Ping360SimulationLink(QObject* parent = nullptr);
 
     /**
-     * @brief Generates random data
+     * @brief Destroy the Ping360 Simulation Link object
+     *
+     */
+    ~Ping360SimulationLink();
+
+    static const int defaultSamples = 1200;
+
+protected:
+    /**
+     * @brief Append a simulated device data message, each message moves the head one gradian
      *
+     * @param buffer
+     * @param counter
      */
-    void randomUpdate();
+    void appendMessage(QByteArray& buffer, uint counter) final;
 
 private:
-    QTimer _randomUpdateTimer;
+    int _messageSamples = 0;
+    std::unique_ptr<ping360_device_data> _deviceData;
 };
@@ -0,0 +1,127 @@
+#include <cstring>
+
+#include <QVector>
+#include <QtEndian>
+
+#include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
+#include "pingchecksum.h"
+#include "profiledeltacodec.h"
+#include "sensorlogformat.h"
+
+namespace {
+// Payload offset of the samples: ping1d_profile after profile_data_length, ping360_device_data after data_length
+const int profileSamplesOffset = 26;
+const int deviceDataSamplesOffset = 14;
+
+/**
+ * @brief Previous samples of each message
+ *
+ */
+struct DeltaState {
+    QByteArray profile;
+    QByteArray deviceData;
+};
+
+/**
+ * @brief Encode or decode frames inside record data
+ *
+ * @param data
+ * @param length
+ * @param state
+ * @param encode
+ */
+void transformRecord(uchar* data, int length, DeltaState& state, bool encode)
+{
+    const int minimumFrameLength = PingChecksum::headerLength + PingChecksum::checksumLength;
+    int index = 0;
+    while(index + minimumFrameLength <= length) {
+        const uchar* start = static_cast<const uchar*>(memchr(data + index, 'B', length - minimumFrameLength + 1 - index));
+        if(!start) {
+            return;
+        }
+        index = start - data;
+        if(data[index + 1] != 'R') {
+            index++;
+            continue;
+        }
+
+        // Only header fields are used to find frames, they are not modified by the encoder
+        const int payloadLength = qFromLittleEndian<quint16>(data + index + 2);
+        const quint16 messageId = qFromLittleEndian<quint16>(data + index + 4);
+        const int frameLength = minimumFrameLength + payloadLength;
+        int samplesOffset;
+        QByteArray* previous;
+        if(messageId == Ping1dId::PROFILE) {
+            samplesOffset = profileSamplesOffset;
+            previous = &state.profile;
+        } else if(messageId == Ping360Id::DEVICE_DATA) {
+            samplesOffset = deviceDataSamplesOffset;
+            previous = &state.deviceData;
+        } else {
+            index++;
+            continue;
+        }
+        if(index + frameLength > length || payloadLength <= samplesOffset) {
+            index++;
+            continue;
+        }
+
+        uchar* samples = data + index + PingChecksum::headerLength + samplesOffset;
+        const int numberOfSamples = payloadLength - samplesOffset;
+        if(previous->size() == numberOfSamples) {
+            uchar* previousSamples = reinterpret_cast<uchar*>(previous->data());
+            if(encode) {
+                for(int i = 0; i < numberOfSamples; i++) {
+                    const uchar sample = samples[i];
+                    samples[i] = sample - previousSamples[i];
+                    previousSamples[i] = sample;
+                }
+            } else {
+                for(int i = 0; i < numberOfSamples; i++) {
+                    samples[i] += previousSamples[i];
+                    previousSamples[i] = samples[i];
+                }
+            }
+        } else {
+            // First message or number of samples changed, samples are kept as reference
+            *previous = QByteArray(reinterpret_cast<const char*>(samples), numberOfSamples);
+        }
+
+        index += frameLength;
+    }
+}
+}
+
+bool ProfileDeltaCodec::encode(QByteArray& payload, quint32 recordCount)
+{
+    return transform(payload, recordCount, true);
+}
+
+bool ProfileDeltaCodec::decode(QByteArray& payload, quint32 recordCount)
+{
+    return transform(payload, recordCount, false);
+}
+
+bool ProfileDeltaCodec::transform(QByteArray& payload, quint32 recordCount, bool encode)
+{
+    const qint64 footer = qint64(payload.size()) - qint64(recordCount) * sizeof(quint32);
+    if(footer < 0) {
+        return false;
+    }
+
+    uchar* raw = reinterpret_cast<uchar*>(payload.data());
+    DeltaState state;
+    for(quint32 record = 0; record < recordCount; record++) {
+        const quint32 offset = qFromLittleEndian<quint32>(raw + footer + record * sizeof(quint32));
+        if(offset + SensorLogFormat::recordHeaderSize > footer) {
+            return false;
+        }
+        const quint32 length = qFromLittleEndian<quint32>(raw + offset + 8);
+        if(offset + SensorLogFormat::recordHeaderSize + length > footer) {
+            return false;
+        }
+        transformRecord(raw + offset + SensorLogFormat::recordHeaderSize, length, state, encode);
+    }
+    return true;
+}
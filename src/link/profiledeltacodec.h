@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QByteArray>
+
+/**
+ * @brief Delta encoding of profile samples inside sensor log chunks
+ *  Ping1D profile and Ping360 device data samples are replaced by the difference (modulo 256) to the samples of the
+ *  previous message with the same id and number of samples. Adjacent profiles are correlated and the differences
+ *  compress better.
+ *
+ *  Only frames fully inside a record are encoded, everything else (headers, other messages, checksums, partial frames)
+ *  is not modified. Frames are found with the header fields only, so the decoder finds the same frames
+ *  in the encoded data. The state is reset for each chunk, chunks can be decoded independently.
+ */
+class ProfileDeltaCodec
+{
+public:
+    ProfileDeltaCodec() = delete;
+    ~ProfileDeltaCodec() = delete;
+
+    /**
+     * @brief Encode all records of an uncompressed chunk payload (SensorLogFormat), in place
+     *
+     * @param payload records followed by the footer index
+     * @param recordCount
+     * @return true
+     * @return false payload is not valid
+     */
+    static bool encode(QByteArray& payload, quint32 recordCount);
+
+    /**
+     * @brief Decode all records of an uncompressed chunk payload, in place
+     *
+     * @param payload
+     * @param recordCount
+     * @return true
+     * @return false payload is not valid
+     */
+    static bool decode(QByteArray& payload, quint32 recordCount);
+
+private:
+    /**
+     * @brief Encode or decode all records of a chunk payload
+     *
+     * @param payload
+     * @param recordCount
+     * @param encode
+     * @return true
+     * @return false
+     */
+    static bool transform(QByteArray& payload, quint32 recordCount, bool encode);
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstring>
+
+#include <QByteArray>
+#include <QtEndian>
+
+/**
+ * @brief Binary sensor log format, version 2
+ *  All values are little endian.
+ *
+ *  File:
+ *      FileHeader
+ *      Chunk...
+ *
+ *  Chunk:
+ *      ChunkHeader
+ *      Payload with storedSize bytes, compressed with qCompress if ChunkCompressed is set.
+ *      Profile samples are delta encoded (ProfileDeltaCodec) if ChunkDeltaEncoded is set.
+ *      The uncompressed payload has rawSize bytes:
+ *          Record...
+ *          Footer index: recordCount x quint32 record offsets inside the payload
+ *
+ *  Record:
+ *      qint64 timestamp in nanoseconds since startTime
+ *      quint32 length
+ *      length bytes of link data
+ *
+ *  Chunks are closed when the payload reaches the chunk size of the file header,
+ *  the header of each chunk has the time of its first and last records, allowing seek without decoding.
+ *
+ *  Version 1 logs are a QDataStream sequence of QString time (hh:mm:ss.zzz) and QByteArray data.
+ */
+namespace SensorLogFormat {
+
+const QByteArray fileMagic = QByteArrayLiteral("PINGLOG2");
+const quint32 chunkMagic = 0x4b4e4843; // CHNK
+const quint32 version = 2;
+const quint32 defaultChunkSize = 1024 * 1024;
+
+/**
+ * @brief Chunk flags
+ *
+ */
+enum ChunkFlag : quint32 {
+    ChunkCompressed = 1 << 0,
+    ChunkDeltaEncoded = 1 << 1,
+};
+
+// Flags supported by this version, chunks with other flags can't be decoded
+const quint32 knownChunkFlags = ChunkCompressed | ChunkDeltaEncoded;
+
+/**
+ * @brief Header in the start of the file
+ *
+ */
+struct FileHeader {
+    static const int size = 32;
+
+    quint32 version = SensorLogFormat::version;
+    quint32 chunkSize = defaultChunkSize;
+    // Start of the log in nanoseconds since epoch (UTC)
+    qint64 startTime = 0;
+
+    /**
+     * @brief Serialize header
+     *
+     * @return QByteArray
+     */
+    QByteArray toByteArray() const
+    {
+        QByteArray data(size, 0);
+        uchar* header = reinterpret_cast<uchar*>(data.data());
+        memcpy(header, fileMagic.constData(), 8);
+        qToLittleEndian<quint32>(version, header + 8);
+        qToLittleEndian<quint32>(chunkSize, header + 12);
+        qToLittleEndian<qint64>(startTime, header + 16);
+        return data;
+    }
+
+    /**
+     * @brief Deserialize header
+     *  The version is not checked, a newer log has the same magic number (check isSupported)
+     *
+     * @param data
+     * @param length
+     * @return true
+     * @return false data is not a chunked log header
+     */
+    bool fromData(const uchar* data, qint64 length)
+    {
+        if(length < size || memcmp(data, fileMagic.constData(), 8) != 0) {
+            return false;
+        }
+        version = qFromLittleEndian<quint32>(data + 8);
+        chunkSize = qFromLittleEndian<quint32>(data + 12);
+        startTime = qFromLittleEndian<qint64>(data + 16);
+        return true;
+    }
+
+    /**
+     * @brief Return true if this version can be read
+     *
+     * @return true
+     * @return false
+     */
+    bool isSupported() const { return version == SensorLogFormat::version; }
+};
+
+/**
+ * @brief Header in the start of each chunk
+ *
+ */
+struct ChunkHeader {
+    static const int size = 40;
+
+    quint32 flags = 0;
+    // Payload size in the file
+    quint32 storedSize = 0;
+    // Payload size after decompression, with the footer index
+    quint32 rawSize = 0;
+    quint32 recordCount = 0;
+    qint64 firstTimestamp = 0;
+    qint64 lastTimestamp = 0;
+
+    /**
+     * @brief Serialize header
+     *
+     * @return QByteArray
+     */
+    QByteArray toByteArray() const
+    {
+        QByteArray data(size, 0);
+        uchar* header = reinterpret_cast<uchar*>(data.data());
+        qToLittleEndian<quint32>(chunkMagic, header);
+        qToLittleEndian<quint32>(flags, header + 4);
+        qToLittleEndian<quint32>(storedSize, header + 8);
+        qToLittleEndian<quint32>(rawSize, header + 12);
+        qToLittleEndian<quint32>(recordCount, header + 16);
+        qToLittleEndian<qint64>(firstTimestamp, header + 24);
+        qToLittleEndian<qint64>(lastTimestamp, header + 32);
+        return data;
+    }
+
+    /**
+     * @brief Deserialize header
+     *
+     * @param data
+     * @param length
+     * @return true
+     * @return false data is not a chunk header
+     */
+    bool fromData(const uchar* data, qint64 length)
+    {
+        if(length < size || qFromLittleEndian<quint32>(data) != chunkMagic) {
+            return false;
+        }
+        flags = qFromLittleEndian<quint32>(data + 4);
+        storedSize = qFromLittleEndian<quint32>(data + 8);
+        rawSize = qFromLittleEndian<quint32>(data + 12);
+        recordCount = qFromLittleEndian<quint32>(data + 16);
+        firstTimestamp = qFromLittleEndian<qint64>(data + 24);
+        lastTimestamp = qFromLittleEndian<qint64>(data + 32);
+        return true;
+    }
+};
+
+// Record header: timestamp and length
+const int recordHeaderSize = 12;
+
+}
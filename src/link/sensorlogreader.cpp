@@ -0,0 +1,576 @@
+#include <algorithm>
+
+#include <QtConcurrent>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QTime>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#endif
+
+#include "logger.h"
+#include "profiledeltacodec.h"
+#include "sensorlogreader.h"
+
+PING_LOGGING_CATEGORY(SENSORLOGREADER, "ping.sensorlogreader");
+
+const QByteArray SensorLogReader::_indexMagic = QByteArrayLiteral("PINGIDX");
+const quint32 SensorLogReader::_indexVersion = 1;
+
+namespace {
+// Number of records indexed between each index update
+const int indexBatchSize = 4096;
+const qint64 nsPerMs = 1000000;
+const qint64 nsPerDay = 24LL * 60 * 60 * 1000 * nsPerMs;
+
+inline quint32 readUInt32BigEndian(const uchar* data)
+{
+    return (quint32(data[0]) << 24) | (quint32(data[1]) << 16) | (quint32(data[2]) << 8) | quint32(data[3]);
+}
+}
+
+SensorLogReader::SensorLogReader(QObject* parent)
+    : QObject(parent)
+{
+}
+
+bool SensorLogReader::open(const QString& fileName)
+{
+    close();
+
+    _file.setFileName(fileName);
+    if(!_file.open(QIODevice::ReadOnly)) {
+        qCWarning(SENSORLOGREADER) << "Not possible to open log:" << fileName << _file.errorString();
+        return false;
+    }
+
+    _mapSize = _file.size();
+    _map = _mapSize ? _file.map(0, _mapSize) : nullptr;
+    if(!_map) {
+        qCWarning(SENSORLOGREADER) << "Not possible to map log:" << fileName << _file.errorString();
+        _mapSize = 0;
+        _file.close();
+        return false;
+    }
+
+#ifdef Q_OS_UNIX
+    // Playback is mostly sequential, let the kernel read ahead
+    madvise(const_cast<uchar*>(_map), _mapSize, MADV_SEQUENTIAL);
+#endif
+
+    SensorLogFormat::FileHeader header;
+    if(header.fromData(_map, _mapSize)) {
+        // Newer logs are not version 1 logs, reading them as one would return garbage
+        if(!header.isSupported()) {
+            qCWarning(SENSORLOGREADER) << "Log version" << header.version << "is not supported:" << fileName;
+            close();
+            return false;
+        }
+        _version = header.version;
+        _startTime = header.startTime;
+    } else {
+        _version = 1;
+        _startTime = 0;
+    }
+
+    if(_version == 1 && loadIndex()) {
+        qCDebug(SENSORLOGREADER) << "Index loaded from cache:" << _index.size() << "packets.";
+        emit indexUpdated();
+        emit indexFinished();
+        return true;
+    }
+
+    _indexing = true;
+    _abortIndexing = false;
+    _indexFuture = QtConcurrent::run(this, &SensorLogReader::buildIndex);
+    return true;
+}
+
+void SensorLogReader::close()
+{
+    _abortIndexing = true;
+    _indexFuture.waitForFinished();
+    _indexing = false;
+
+    {
+        QMutexLocker chunkLocker(&_chunkMutex);
+        for(auto& decodedChunk : _decodedChunks) {
+            decodedChunk = DecodedChunk();
+        }
+    }
+
+    QMutexLocker locker(&_indexMutex);
+    _index.clear();
+    _chunks.clear();
+    _chunkRecords = 0;
+    if(_map) {
+        _file.unmap(const_cast<uchar*>(_map));
+        _map = nullptr;
+    }
+    _mapSize = 0;
+    _file.close();
+}
+
+int SensorLogReader::size() const
+{
+    QMutexLocker locker(&_indexMutex);
+    return _version == 1 ? _index.size() : _chunkRecords;
+}
+
+qint64 SensorLogReader::timestamp(int index) const
+{
+    if(_version != 1) {
+        qint64 time = 0;
+        readChunkRecord(index, &time, nullptr);
+        return time;
+    }
+
+    QMutexLocker locker(&_indexMutex);
+    if(index < 0 || index >= _index.size()) {
+        return 0;
+    }
+    return _index[index].timestamp;
+}
+
+int SensorLogReader::indexAt(qint64 time) const
+{
+    if(_version == 1) {
+        QMutexLocker locker(&_indexMutex);
+        const auto entry = std::lower_bound(_index.cbegin(), _index.cend(), time,
+        [](const IndexEntry& indexEntry, qint64 value) {
+            return indexEntry.timestamp < value;
+        });
+        return std::distance(_index.cbegin(), entry);
+    }
+
+    // First chunk that ends after time, all records before it are older
+    int first;
+    int last;
+    {
+        QMutexLocker locker(&_indexMutex);
+        const auto chunk = std::lower_bound(_chunks.cbegin(), _chunks.cend(), time,
+        [](const ChunkEntry& chunkEntry, qint64 value) {
+            return chunkEntry.header.lastTimestamp < value;
+        });
+        if(chunk == _chunks.cend()) {
+            return _chunkRecords;
+        }
+        first = chunk->firstRecord;
+        last = chunk->firstRecord + chunk->header.recordCount - 1;
+    }
+
+    // Search inside the chunk, it's decoded once and kept in the chunk cache
+    while(first < last) {
+        const int middle = first + (last - first) / 2;
+        if(timestamp(middle) < time) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+int SensorLogReader::keyframeIndex(int index) const
+{
+    QMutexLocker locker(&_indexMutex);
+    if(_version == 1 || index <= 0 || index >= _chunkRecords) {
+        return qMax(index, 0);
+    }
+    return _chunks[chunkOf(index)].firstRecord;
+}
+
+int SensorLogReader::chunkOf(int index) const
+{
+    const auto next = std::upper_bound(_chunks.cbegin(), _chunks.cend(), index,
+    [](int recordIndex, const ChunkEntry& chunkEntry) {
+        return recordIndex < chunkEntry.firstRecord;
+    });
+    return std::distance(_chunks.cbegin(), next) - 1;
+}
+
+QByteArray SensorLogReader::packet(int index) const
+{
+    if(_version != 1) {
+        QByteArray data;
+        readChunkRecord(index, nullptr, &data);
+        return data;
+    }
+
+    qint64 offset;
+    {
+        QMutexLocker locker(&_indexMutex);
+        if(index < 0 || index >= _index.size()) {
+            return {};
+        }
+        offset = _index[index].offset;
+    }
+
+    QByteArray data;
+    readRecord(_map, _mapSize, offset, nullptr, &data);
+    return data;
+}
+
+qint64 SensorLogReader::readRecord(const uchar* map, qint64 mapSize, qint64 offset, qint64* timestamp,
+                                  QByteArray* data)
+{
+    // Version 1 record format, written with QDataStream (big endian):
+    // QString: quint32 length in bytes (0xffffffff if null) + UTF-16 time string (hh:mm:ss.zzz)
+    // QByteArray: quint32 length (0xffffffff if null) + data
+    static const quint32 nullLength = 0xffffffff;
+
+    if(offset + 4 > mapSize) {
+        return -1;
+    }
+    const uchar* record = map + offset;
+    quint32 timeLength = readUInt32BigEndian(record);
+    timeLength = timeLength == nullLength ? 0 : timeLength;
+    if(offset + 4 + timeLength + 4 > mapSize) {
+        return -1;
+    }
+
+    const uchar* dataRecord = record + 4 + timeLength;
+    quint32 dataLength = readUInt32BigEndian(dataRecord);
+    dataLength = dataLength == nullLength ? 0 : dataLength;
+    const qint64 nextOffset = offset + 4 + timeLength + 4 + dataLength;
+    if(nextOffset > mapSize) {
+        return -1;
+    }
+
+    if(timestamp) {
+        // Fast path for hh:mm:ss.zzz, avoids creating a QString for each record
+        const uchar* time = record + 4;
+        static const int timeFormatLength = 12;
+        auto digit = [time](int i) { return time[i * 2] == 0 ? time[i * 2 + 1] - '0' : -1; };
+        bool fast = timeLength == timeFormatLength * 2;
+        int values[timeFormatLength] = {};
+        for(int i = 0; fast && i < timeFormatLength; i++) {
+            if(i == 2 || i == 5 || i == 8) {
+                continue;
+            }
+            values[i] = digit(i);
+            fast = values[i] >= 0 && values[i] <= 9;
+        }
+
+        if(fast) {
+            const qint64 msecs = ((values[0] * 10 + values[1]) * 3600 + (values[3] * 10 + values[4]) * 60
+                                  + values[6] * 10 + values[7]) * 1000LL + values[9] * 100 + values[10] * 10 + values[11];
+            *timestamp = msecs * nsPerMs;
+        } else {
+            // UTF-16 big endian
+            QString timeString;
+            for(quint32 i = 0; i + 1 < timeLength; i += 2) {
+                timeString.append(QChar((time[i] << 8) | time[i + 1]));
+            }
+            *timestamp = QTime::fromString(timeString, "hh:mm:ss.zzz").msecsSinceStartOfDay() * nsPerMs;
+        }
+    }
+
+    if(data) {
+        *data = QByteArray(reinterpret_cast<const char*>(dataRecord + 4), dataLength);
+    }
+
+    return nextOffset;
+}
+
+bool SensorLogReader::firstPacketTime(const QString& fileName, qint64* timestamp, qint64* time)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // Enough for the headers and the first version 1 record
+    static const qint64 probeSize = 64 * 1024;
+    const QByteArray data = file.read(probeSize);
+    const uchar* raw = reinterpret_cast<const uchar*>(data.constData());
+
+    SensorLogFormat::FileHeader fileHeader;
+    if(fileHeader.fromData(raw, data.size())) {
+        if(!fileHeader.isSupported()) {
+            qCWarning(SENSORLOGREADER) << "Log version" << fileHeader.version << "is not supported:" << fileName;
+            return false;
+        }
+        SensorLogFormat::ChunkHeader chunkHeader;
+        if(!chunkHeader.fromData(raw + SensorLogFormat::FileHeader::size, data.size() - SensorLogFormat::FileHeader::size)
+                || !chunkHeader.recordCount) {
+            return false;
+        }
+        *timestamp = chunkHeader.firstTimestamp;
+        *time = fileHeader.startTime + chunkHeader.firstTimestamp;
+        return true;
+    }
+
+    if(readRecord(raw, data.size(), 0, timestamp, nullptr) < 0) {
+        return false;
+    }
+
+    // Version 1 timestamps are the time since the file link was created, not the time of day
+    // Logs recorded by the application have the creation time in the name (same format of FileManager)
+    const QFileInfo fileInfo(file);
+    const QDateTime created = QDateTime::fromString(fileInfo.completeBaseName(), QStringLiteral("yyyyMMdd-hhmmsszzz"));
+    if(created.isValid()) {
+        *time = created.toMSecsSinceEpoch() * nsPerMs + *timestamp;
+        return true;
+    }
+
+    // Otherwise the log ended at its last modification, as in SensorLogWriter::convert
+    // Only the record headers are read to find the last timestamp
+    qint64 lastTimestamp = *timestamp;
+    const uchar* map = file.map(0, file.size());
+    if(map) {
+        qint64 recordTimestamp;
+        qint64 offset = 0;
+        while((offset = readRecord(map, file.size(), offset, &recordTimestamp, nullptr)) > 0) {
+            lastTimestamp = recordTimestamp;
+        }
+        file.unmap(const_cast<uchar*>(map));
+    }
+    *time = fileInfo.lastModified().toMSecsSinceEpoch() * nsPerMs - (lastTimestamp - *timestamp);
+    return true;
+}
+
+bool SensorLogReader::readChunkRecord(int index, qint64* timestamp, QByteArray* data) const
+{
+    ChunkEntry entry;
+    int chunk;
+    {
+        QMutexLocker locker(&_indexMutex);
+        if(index < 0 || index >= _chunkRecords) {
+            return false;
+        }
+        chunk = chunkOf(index);
+        entry = _chunks[chunk];
+    }
+
+    const int recordInChunk = index - entry.firstRecord;
+
+    // The chunk header has the first and last timestamps, no need to decode it
+    if(!data) {
+        if(recordInChunk == 0) {
+            *timestamp = entry.header.firstTimestamp;
+            return true;
+        }
+        if(recordInChunk == static_cast<int>(entry.header.recordCount) - 1) {
+            *timestamp = entry.header.lastTimestamp;
+            return true;
+        }
+    }
+
+    QMutexLocker locker(&_chunkMutex);
+    const QByteArray& payload = decodeChunk(entry, chunk);
+    const qint64 footer = qint64(payload.size()) - qint64(entry.header.recordCount) * sizeof(quint32);
+    if(footer < 0) {
+        return false;
+    }
+
+    const uchar* raw = reinterpret_cast<const uchar*>(payload.constData());
+    const quint32 offset = qFromLittleEndian<quint32>(raw + footer + recordInChunk * sizeof(quint32));
+    if(offset + SensorLogFormat::recordHeaderSize > footer) {
+        qCWarning(SENSORLOGREADER) << "Invalid record offset in chunk" << chunk;
+        return false;
+    }
+    const quint32 length = qFromLittleEndian<quint32>(raw + offset + 8);
+    if(offset + SensorLogFormat::recordHeaderSize + length > footer) {
+        qCWarning(SENSORLOGREADER) << "Invalid record length in chunk" << chunk;
+        return false;
+    }
+
+    if(timestamp) {
+        *timestamp = qFromLittleEndian<qint64>(raw + offset);
+    }
+    if(data) {
+        *data = payload.mid(offset + SensorLogFormat::recordHeaderSize, length);
+    }
+    return true;
+}
+
+const QByteArray& SensorLogReader::decodeChunk(const ChunkEntry& entry, int chunk) const
+{
+    for(const auto& decodedChunk : _decodedChunks) {
+        if(decodedChunk.chunk == chunk) {
+            return decodedChunk.payload;
+        }
+    }
+
+    DecodedChunk& decodedChunk = _decodedChunks[_nextDecodedChunk];
+    _nextDecodedChunk = (_nextDecodedChunk + 1) % _decodedChunkCount;
+
+    const char* stored = reinterpret_cast<const char*>(_map + entry.offset + SensorLogFormat::ChunkHeader::size);
+    decodedChunk.chunk = chunk;
+    if(entry.header.flags & ~SensorLogFormat::knownChunkFlags) {
+        qCWarning(SENSORLOGREADER) << "Chunk" << chunk << "has unsupported flags:" << entry.header.flags;
+        decodedChunk.payload.clear();
+        return decodedChunk.payload;
+    }
+
+    if(entry.header.flags & SensorLogFormat::ChunkCompressed) {
+        decodedChunk.payload = qUncompress(reinterpret_cast<const uchar*>(stored), entry.header.storedSize);
+    } else {
+        // The map is valid while the reader is open
+        decodedChunk.payload = QByteArray::fromRawData(stored, entry.header.storedSize);
+    }
+
+    if(static_cast<quint32>(decodedChunk.payload.size()) != entry.header.rawSize) {
+        qCWarning(SENSORLOGREADER) << "Chunk" << chunk << "is corrupted.";
+        decodedChunk.payload.clear();
+    } else if(entry.header.flags & SensorLogFormat::ChunkDeltaEncoded
+              && !ProfileDeltaCodec::decode(decodedChunk.payload, entry.header.recordCount)) {
+        qCWarning(SENSORLOGREADER) << "Chunk" << chunk << "has invalid records.";
+        decodedChunk.payload.clear();
+    }
+    return decodedChunk.payload;
+}
+
+void SensorLogReader::buildIndex()
+{
+    if(_version == 1) {
+        buildRecordIndex();
+    } else {
+        buildChunkIndex();
+    }
+
+    _indexing = false;
+    emit indexUpdated();
+
+    if(!_abortIndexing) {
+        qCDebug(SENSORLOGREADER) << "Index finished:" << size() << "packets.";
+        if(_version == 1) {
+            saveIndex();
+        }
+        emit indexFinished();
+    }
+}
+
+void SensorLogReader::buildChunkIndex()
+{
+    qint64 offset = SensorLogFormat::FileHeader::size;
+    int chunksSinceUpdate = 0;
+    while(offset < _mapSize && !_abortIndexing) {
+        ChunkEntry entry;
+        entry.offset = offset;
+        if(!entry.header.fromData(_map + offset, _mapSize - offset)
+                || offset + SensorLogFormat::ChunkHeader::size + entry.header.storedSize > _mapSize) {
+            qCWarning(SENSORLOGREADER) << "Log is truncated or corrupted after" << offset << "bytes.";
+            break;
+        }
+        offset += SensorLogFormat::ChunkHeader::size + entry.header.storedSize;
+
+        {
+            QMutexLocker locker(&_indexMutex);
+            entry.firstRecord = _chunkRecords;
+            _chunkRecords += entry.header.recordCount;
+            _chunks.append(entry);
+        }
+
+        // Chunks are big, update less often than version 1 records
+        if(++chunksSinceUpdate == indexBatchSize / 64) {
+            chunksSinceUpdate = 0;
+            emit indexUpdated();
+        }
+    }
+}
+
+void SensorLogReader::buildRecordIndex()
+{
+    QVector<IndexEntry> batch;
+    batch.reserve(indexBatchSize);
+
+    qint64 offset = 0;
+    qint64 dayOffset = 0;
+    qint64 lastTimestamp = 0;
+    while(offset < _mapSize && !_abortIndexing) {
+        qint64 timestamp;
+        const qint64 nextOffset = readRecord(_map, _mapSize, offset, &timestamp, nullptr);
+        if(nextOffset < 0) {
+            qCWarning(SENSORLOGREADER) << "Log is truncated or corrupted after" << offset << "bytes.";
+            break;
+        }
+
+        // Time of day wraps after 24 hours
+        if(timestamp + dayOffset < lastTimestamp - nsPerDay / 2) {
+            dayOffset += nsPerDay;
+        }
+        lastTimestamp = timestamp + dayOffset;
+
+        batch.append({offset, lastTimestamp});
+        offset = nextOffset;
+
+        if(batch.size() == indexBatchSize) {
+            {
+                QMutexLocker locker(&_indexMutex);
+                _index.append(batch);
+            }
+            batch.clear();
+            emit indexUpdated();
+        }
+    }
+
+    QMutexLocker locker(&_indexMutex);
+    _index.append(batch);
+}
+
+bool SensorLogReader::loadIndex()
+{
+    QFile indexFile(_file.fileName() + ".idx");
+    if(!indexFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&indexFile);
+    QByteArray magic;
+    quint32 version;
+    qint64 fileSize;
+    qint64 lastModified;
+    qint64 count;
+    in >> magic >> version >> fileSize >> lastModified >> count;
+
+    const QFileInfo logInfo(_file);
+    if(in.status() != QDataStream::Ok || magic != _indexMagic || version != _indexVersion
+            || fileSize != logInfo.size() || lastModified != logInfo.lastModified().toMSecsSinceEpoch()
+            || count < 0 || count * qint64(sizeof(IndexEntry)) > indexFile.size()) {
+        qCDebug(SENSORLOGREADER) << "Index cache is invalid:" << indexFile.fileName();
+        return false;
+    }
+
+    QMutexLocker locker(&_indexMutex);
+    _index.resize(count);
+    const int length = count * sizeof(IndexEntry);
+    if(in.readRawData(reinterpret_cast<char*>(_index.data()), length) != length) {
+        _index.clear();
+        return false;
+    }
+    return true;
+}
+
+void SensorLogReader::saveIndex() const
+{
+    // Small logs are fast enough to index
+    static const int minimumCacheSize = 10000;
+    QMutexLocker locker(&_indexMutex);
+    if(_index.size() < minimumCacheSize) {
+        return;
+    }
+
+    QSaveFile indexFile(_file.fileName() + ".idx");
+    if(!indexFile.open(QIODevice::WriteOnly)) {
+        qCDebug(SENSORLOGREADER) << "Not possible to save index cache:" << indexFile.fileName();
+        return;
+    }
+
+    const QFileInfo logInfo(_file);
+    QDataStream out(&indexFile);
+    out << _indexMagic << _indexVersion << logInfo.size() << logInfo.lastModified().toMSecsSinceEpoch()
+        << qint64(_index.size());
+    out.writeRawData(reinterpret_cast<const char*>(_index.constData()), _index.size() * sizeof(IndexEntry));
+    indexFile.commit();
+}
+
+SensorLogReader::~SensorLogReader()
+{
+    close();
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <atomic>
+
+#include <QByteArray>
+#include <QFile>
+#include <QFuture>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+
+#include "sensorlogformat.h"
+
+Q_DECLARE_LOGGING_CATEGORY(SENSORLOGREADER)
+
+/**
+ * @brief Streaming reader of sensor logs
+ *  The log file is memory mapped and only a lightweight index is kept in memory, packets are decoded when requested.
+ *  Version 1 logs (SensorLogFormat) have an index of offset and timestamp for each record, that is loaded from
+ *  a cache file next to the log (log name + .idx) or built in background.
+ *  Version 2 logs have an index of chunks, built from the chunk headers, and the last decoded chunks are cached.
+ *  Packets are available while the index is being built.
+ *
+ */
+class SensorLogReader : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Construct a new Sensor Log Reader object
+     *
+     * @param parent
+     */
+    SensorLogReader(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroy the Sensor Log Reader object
+     *
+     */
+    ~SensorLogReader();
+
+    /**
+     * @brief Open and map log file, the index is loaded or built in background
+     *
+     * @param fileName
+     * @return true
+     * @return false
+     */
+    bool open(const QString& fileName);
+
+    /**
+     * @brief Stop indexing and unmap the log file
+     *
+     */
+    void close();
+
+    /**
+     * @brief Return true if the log is open
+     *
+     * @return true
+     * @return false
+     */
+    bool isOpen() const { return _map; }
+
+    /**
+     * @brief Return true if the index is still being built
+     *
+     * @return true
+     * @return false
+     */
+    bool isIndexing() const { return _indexing; }
+
+    /**
+     * @brief Wait until all packets are indexed
+     *
+     */
+    void waitForIndex() { _indexFuture.waitForFinished(); }
+
+    /**
+     * @brief Return log format version, 1 or 2
+     *
+     * @return quint32
+     */
+    quint32 version() const { return _version; }
+
+    /**
+     * @brief Return log start in nanoseconds since epoch, 0 if not available (version 1)
+     *
+     * @return qint64
+     */
+    qint64 startTime() const { return _startTime; }
+
+    /**
+     * @brief Return the number of indexed packets
+     *
+     * @return int
+     */
+    int size() const;
+
+    /**
+     * @brief Return packet timestamp in nanoseconds
+     *  Version 1 timestamps are the time since the log was created, version 2 timestamps are relative to startTime
+     *
+     * @param index
+     * @return qint64
+     */
+    qint64 timestamp(int index) const;
+
+    /**
+     * @brief Return the index of the first packet with timestamp equal or after time
+     *  Uses a binary search over the index, version 2 logs search the chunk headers and then a single chunk.
+     *
+     * @param time in the same reference of timestamp(int)
+     * @return int size() if all packets are before time
+     */
+    int indexAt(qint64 time) const;
+
+    /**
+     * @brief Return the nearest packet before index that can be decoded without previous packets
+     *  Version 2 logs return the first packet of the chunk, version 1 logs have no chunks and return index.
+     *
+     * @param index
+     * @return int
+     */
+    int keyframeIndex(int index) const;
+
+    /**
+     * @brief Decode packet data
+     *
+     * @param index
+     * @return QByteArray empty if index is invalid
+     */
+    QByteArray packet(int index) const;
+
+    /**
+     * @brief Return the log file size in bytes
+     *
+     * @return qint64
+     */
+    qint64 byteSize() const { return _mapSize; }
+
+    /**
+     * @brief Read the time of the first packet without indexing the log
+     *  Version 1 logs only have the time since the log was created, the creation time comes from the file name
+     *  (FileManager format) or from the last modification of the file minus the log duration.
+     *
+     * @param fileName
+     * @param timestamp first packet timestamp, in the same reference of timestamp(int)
+     * @param time first packet time in nanoseconds since epoch
+     * @return true
+     * @return false the file is not a log or has no packets
+     */
+    static bool firstPacketTime(const QString& fileName, qint64* timestamp, qint64* time);
+
+signals:
+    /**
+     * @brief New packets are available, emitted from the indexing thread
+     *
+     */
+    void indexUpdated();
+
+    /**
+     * @brief All packets are indexed, emitted from the indexing thread
+     *
+     */
+    void indexFinished();
+
+private:
+    Q_DISABLE_COPY(SensorLogReader)
+
+    struct IndexEntry {
+        // Offset of the record in the file
+        qint64 offset;
+        // Timestamp in nanoseconds
+        qint64 timestamp;
+    };
+
+    struct ChunkEntry {
+        // Offset of the chunk header in the file
+        qint64 offset;
+        // Index of the first record in the log
+        int firstRecord;
+        SensorLogFormat::ChunkHeader header;
+    };
+
+    struct DecodedChunk {
+        int chunk = -1;
+        QByteArray payload;
+    };
+
+    /**
+     * @brief Build index from the mapped file, runs in a worker thread
+     *
+     */
+    void buildIndex();
+
+    /**
+     * @brief Index each record of a version 1 log
+     *
+     */
+    void buildRecordIndex();
+
+    /**
+     * @brief Index each chunk of a version 2 log
+     *
+     */
+    void buildChunkIndex();
+
+    /**
+     * @brief Load index from cache file
+     *
+     * @return true
+     * @return false the cache does not exist or does not match the log
+     */
+    bool loadIndex();
+
+    /**
+     * @brief Save index in the cache file
+     *
+     */
+    void saveIndex() const;
+
+    /**
+     * @brief Decode the version 1 record in offset
+     *
+     * @param map log data
+     * @param mapSize
+     * @param offset
+     * @param timestamp time of day in nanoseconds, can be nullptr
+     * @param data packet data, can be nullptr
+     * @return qint64 offset of the next record, or -1 if the record is not valid
+     */
+    static qint64 readRecord(const uchar* map, qint64 mapSize, qint64 offset, qint64* timestamp, QByteArray* data);
+
+    /**
+     * @brief Decode a version 2 record
+     *
+     * @param index
+     * @param timestamp can be nullptr
+     * @param data can be nullptr
+     * @return true
+     * @return false
+     */
+    bool readChunkRecord(int index, qint64* timestamp, QByteArray* data) const;
+
+    /**
+     * @brief Return the chunk of a version 2 record, _indexMutex should be locked
+     *
+     * @param index
+     * @return int
+     */
+    int chunkOf(int index) const;
+
+    /**
+     * @brief Return the uncompressed payload of a chunk, _chunkMutex should be locked
+     *
+     * @param entry
+     * @param chunk
+     * @return const QByteArray&
+     */
+    const QByteArray& decodeChunk(const ChunkEntry& entry, int chunk) const;
+
+    QFile _file;
+    const uchar* _map = nullptr;
+    qint64 _mapSize = 0;
+
+    quint32 _version = 1;
+    qint64 _startTime = 0;
+
+    mutable QMutex _indexMutex;
+    QVector<IndexEntry> _index;
+    QVector<ChunkEntry> _chunks;
+    int _chunkRecords = 0;
+
+    // Last decoded chunks, sequential playback decodes each chunk once
+    mutable QMutex _chunkMutex;
+    // Playback and background readers (e.g. LogOverview) keep their own chunks in the cache
+    static const int _decodedChunkCount = 4;
+    mutable DecodedChunk _decodedChunks[_decodedChunkCount];
+    mutable int _nextDecodedChunk = 0;
+
+    QFuture<void> _indexFuture;
+    std::atomic<bool> _indexing{false};
+    std::atomic<bool> _abortIndexing{false};
+
+    static const QByteArray _indexMagic;
+    static const quint32 _indexVersion;
+};
@@ -0,0 +1,335 @@
+#include <algorithm>
+
+#include <QtConcurrent>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include "logger.h"
+#include "sensorlogreader.h"
+#include "sensorlogsession.h"
+
+PING_LOGGING_CATEGORY(SENSORLOGSESSION, "ping.sensorlogsession");
+
+SensorLogSession::SensorLogSession(QObject* parent)
+    : QObject(parent)
+{
+    // The indexing thread and the logs being opened
+    _pool.setMaxThreadCount(_maximumOpenLogs + 1);
+}
+
+bool SensorLogSession::open(const QStringList& fileNames)
+{
+    close();
+
+    // Only the headers and the first packet are read, the logs are indexed in background
+    for(const auto& fileName : fileNames) {
+        File file{fileName, 0, 0};
+        if(!SensorLogReader::firstPacketTime(fileName, &file.firstTimestamp, &file.startTime)) {
+            qCWarning(SENSORLOGSESSION) << "Ignoring log without packets:" << fileName;
+            continue;
+        }
+        _files.append(file);
+        _byteSize += QFileInfo(fileName).size();
+    }
+
+    if(_files.isEmpty()) {
+        qCWarning(SENSORLOGSESSION) << "No valid log in:" << fileNames;
+        _byteSize = 0;
+        return false;
+    }
+
+    std::stable_sort(_files.begin(), _files.end(), [](const File& first, const File& second) {
+        return first.startTime < second.startTime;
+    });
+    qCDebug(SENSORLOGSESSION) << "Session with" << _files.size() << "logs:" << this->fileNames();
+
+    _indexing = true;
+    _abortIndexing = false;
+    _indexFuture = QtConcurrent::run(&_pool, [this] { buildIndex(); });
+    return true;
+}
+
+void SensorLogSession::close()
+{
+    _abortIndexing = true;
+    std::shared_ptr<SensorLogReader> indexingReader;
+    {
+        QMutexLocker locker(&_mutex);
+        indexingReader = _indexingReader;
+    }
+    // Stop indexing the actual log, the indexing thread checks _abortIndexing before the next one
+    if(indexingReader) {
+        indexingReader->close();
+    }
+    _indexFuture.waitForFinished();
+    _indexing = false;
+
+    QVector<OpenLog> openLogs;
+    {
+        QMutexLocker locker(&_mutex);
+        openLogs.swap(_openLogs);
+        _segments.clear();
+        _indexingReader.reset();
+    }
+    for(const auto& openLog : openLogs) {
+        openLog.ready.waitForFinished();
+    }
+    openLogs.clear();
+
+    _files.clear();
+    _byteSize = 0;
+}
+
+QStringList SensorLogSession::fileNames() const
+{
+    QStringList names;
+    for(const auto& file : _files) {
+        names.append(file.fileName);
+    }
+    return names;
+}
+
+int SensorLogSession::size() const
+{
+    QMutexLocker locker(&_mutex);
+    if(_segments.isEmpty()) {
+        return 0;
+    }
+    return _segments.last().firstRecord + segmentSize(_segments.size() - 1);
+}
+
+qint64 SensorLogSession::timestamp(int index) const
+{
+    int segment;
+    int local;
+    if(!locate(index, &segment, &local)) {
+        return 0;
+    }
+
+    const auto log = reader(segment);
+    return log ? sessionTime(segment, log->timestamp(local)) : 0;
+}
+
+int SensorLogSession::indexAt(qint64 time) const
+{
+    int segment;
+    int firstRecord;
+    qint64 localTime;
+    {
+        QMutexLocker locker(&_mutex);
+        if(_segments.isEmpty()) {
+            return 0;
+        }
+
+        // Last segment that starts before time, the result is in it or is the first packet of the next one
+        const auto next = std::upper_bound(_segments.cbegin(), _segments.cend(), time,
+        [](qint64 value, const Segment& segmentEntry) {
+            return value < segmentEntry.sessionOffset;
+        });
+        segment = qMax<int>(0, std::distance(_segments.cbegin(), next) - 1);
+        const Segment& entry = _segments[segment];
+        firstRecord = entry.firstRecord;
+        localTime = time - entry.sessionOffset + _files[entry.file].firstTimestamp;
+    }
+
+    const auto log = reader(segment);
+    return log ? firstRecord + log->indexAt(localTime) : firstRecord;
+}
+
+int SensorLogSession::keyframeIndex(int index) const
+{
+    int segment;
+    int local;
+    if(!locate(index, &segment, &local)) {
+        return qMax(index, 0);
+    }
+
+    const auto log = reader(segment);
+    return log ? index - local + log->keyframeIndex(local) : index;
+}
+
+QByteArray SensorLogSession::packet(int index) const
+{
+    int segment;
+    int local;
+    if(!locate(index, &segment, &local)) {
+        return {};
+    }
+
+    const auto log = reader(segment);
+    return log ? log->packet(local) : QByteArray();
+}
+
+bool SensorLogSession::locate(int index, int* segment, int* local) const
+{
+    QMutexLocker locker(&_mutex);
+    if(index < 0 || _segments.isEmpty()) {
+        return false;
+    }
+
+    const auto next = std::upper_bound(_segments.cbegin(), _segments.cend(), index,
+    [](int recordIndex, const Segment& segmentEntry) {
+        return recordIndex < segmentEntry.firstRecord;
+    });
+    *segment = std::distance(_segments.cbegin(), next) - 1;
+    *local = index - _segments[*segment].firstRecord;
+    return *local < segmentSize(*segment);
+}
+
+qint64 SensorLogSession::sessionTime(int segment, qint64 timestamp) const
+{
+    QMutexLocker locker(&_mutex);
+    if(segment >= _segments.size()) {
+        return 0;
+    }
+    const Segment& entry = _segments[segment];
+    return entry.sessionOffset + timestamp - _files[entry.file].firstTimestamp;
+}
+
+int SensorLogSession::segmentSize(int segment) const
+{
+    // The log being indexed grows until the indexing thread updates the segment
+    if(_indexingReader && segment == _segments.size() - 1) {
+        return _indexingReader->size();
+    }
+    return _segments[segment].count;
+}
+
+std::shared_ptr<SensorLogReader> SensorLogSession::reader(int segment) const
+{
+    OpenLog log;
+    {
+        QMutexLocker locker(&_mutex);
+        if(segment < 0 || segment >= _segments.size()) {
+            return nullptr;
+        }
+
+        log = openLog(segment);
+        // Open the next log before the playback reaches it
+        if(segment + 1 < _segments.size()) {
+            openLog(segment + 1);
+        }
+
+        // Close the least recently used logs, the log being indexed is also used by the indexing thread
+        const int indexingSegment = _indexingReader ? _segments.size() - 1 : -1;
+        while(_openLogs.size() > _maximumOpenLogs) {
+            int oldest = -1;
+            for(int i = 0; i < _openLogs.size(); i++) {
+                const int openSegment = _openLogs[i].segment;
+                if(openSegment == segment || openSegment == segment + 1 || openSegment == indexingSegment) {
+                    continue;
+                }
+                if(oldest < 0 || _openLogs[i].lastUse < _openLogs[oldest].lastUse) {
+                    oldest = i;
+                }
+            }
+            if(oldest < 0) {
+                break;
+            }
+            qCDebug(SENSORLOGSESSION) << "Closing log of segment" << _openLogs[oldest].segment;
+            // Readers in use by other threads are destroyed when released
+            _openLogs.remove(oldest);
+        }
+    }
+
+    log.ready.waitForFinished();
+    return log.reader;
+}
+
+SensorLogSession::OpenLog SensorLogSession::openLog(int segment) const
+{
+    for(auto& log : _openLogs) {
+        if(log.segment == segment) {
+            log.lastUse = ++_useCounter;
+            return log;
+        }
+    }
+
+    OpenLog log;
+    log.segment = segment;
+    log.reader = std::make_shared<SensorLogReader>();
+    log.lastUse = ++_useCounter;
+
+    const QString fileName = _files[_segments[segment].file].fileName;
+    qCDebug(SENSORLOGSESSION) << "Opening log of segment" << segment << fileName;
+    const auto logReader = log.reader;
+    log.ready = QtConcurrent::run(&_pool, [logReader, fileName] {
+        // Logs were indexed by the session, version 1 indexes are usually loaded from the cache
+        if(logReader->open(fileName)) {
+            logReader->waitForIndex();
+        }
+    });
+    _openLogs.append(log);
+    return log;
+}
+
+void SensorLogSession::buildIndex()
+{
+    // Session time of the end of the previous log, and its time since epoch
+    qint64 previousEndOffset = 0;
+    qint64 previousEndTime = 0;
+
+    for(int fileIndex = 0; fileIndex < _files.size() && !_abortIndexing; fileIndex++) {
+        const File& file = _files[fileIndex];
+        auto logReader = std::make_shared<SensorLogReader>();
+        connect(logReader.get(), &SensorLogReader::indexUpdated, this, &SensorLogSession::indexUpdated,
+                Qt::DirectConnection);
+        if(!logReader->open(file.fileName)) {
+            continue;
+        }
+
+        int segment;
+        qint64 sessionOffset = 0;
+        {
+            QMutexLocker locker(&_mutex);
+            // Logs are joined without long pauses between them, overlapping logs are played in sequence
+            if(!_segments.isEmpty()) {
+                sessionOffset = previousEndOffset + qBound<qint64>(0, file.startTime - previousEndTime, maximumGapNSecs);
+            }
+            const int firstRecord = _segments.isEmpty() ? 0 : _segments.last().firstRecord + _segments.last().count;
+            segment = _segments.size();
+            _segments.append({fileIndex, firstRecord, 0, sessionOffset});
+            _indexingReader = logReader;
+            // Playback uses the same reader while the log is indexed
+            _openLogs.append({segment, logReader, QFuture<void>(), ++_useCounter});
+        }
+
+        if(!_abortIndexing) {
+            logReader->waitForIndex();
+        }
+
+        const int count = logReader->size();
+        const qint64 lastTimestamp = count ? logReader->timestamp(count - 1) : file.firstTimestamp;
+        {
+            QMutexLocker locker(&_mutex);
+            _indexingReader.reset();
+            if(count) {
+                _segments[segment].count = count;
+            } else {
+                qCWarning(SENSORLOGSESSION) << "Ignoring log without packets:" << file.fileName;
+                _segments.removeLast();
+                for(int i = 0; i < _openLogs.size(); i++) {
+                    if(_openLogs[i].segment == segment) {
+                        _openLogs.remove(i);
+                        break;
+                    }
+                }
+            }
+        }
+
+        if(count) {
+            previousEndOffset = sessionOffset + lastTimestamp - file.firstTimestamp;
+            previousEndTime = file.startTime + lastTimestamp - file.firstTimestamp;
+            qCDebug(SENSORLOGSESSION) << "Log indexed:" << file.fileName << count << "packets.";
+            emit indexUpdated();
+        }
+    }
+
+    _indexing = false;
+    emit indexFinished();
+}
+
+SensorLogSession::~SensorLogSession()
+{
+    close();
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <QFuture>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+Q_DECLARE_LOGGING_CATEGORY(SENSORLOGSESSION)
+
+class SensorLogReader;
+
+/**
+ * @brief Playback session of one or more sensor logs
+ *  Each connection creates a new log, a session joins the logs of a dive as a single log.
+ *  The logs are ordered by the time of the first packet and indexed sequentially in background,
+ *  the index of the session is a list of segments (one per log) and is available while the logs are indexed.
+ *  Session timestamps start at zero and the gap between logs is limited to maximumGapNSecs.
+ *
+ *  Only a few logs are kept open: the log after the one in use is opened in background
+ *  and the least recently used ones are closed, avoiding stalls when the playback crosses a log boundary.
+ *
+ */
+class SensorLogSession : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Construct a new Sensor Log Session object
+     *
+     * @param parent
+     */
+    SensorLogSession(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroy the Sensor Log Session object
+     *
+     */
+    ~SensorLogSession();
+
+    /**
+     * @brief Open logs, the session index is built in background
+     *
+     * @param fileNames
+     * @return true
+     * @return false none of the files is a valid log
+     */
+    bool open(const QStringList& fileNames);
+
+    /**
+     * @brief Stop indexing and close all logs
+     *
+     */
+    void close();
+
+    /**
+     * @brief Return true if the session is open
+     *
+     * @return true
+     * @return false
+     */
+    bool isOpen() const { return !_files.isEmpty(); }
+
+    /**
+     * @brief Return true if the index is still being built
+     *
+     * @return true
+     * @return false
+     */
+    bool isIndexing() const { return _indexing; }
+
+    /**
+     * @brief Wait until all logs are indexed
+     *
+     */
+    void waitForIndex() { _indexFuture.waitForFinished(); }
+
+    /**
+     * @brief Return the logs of the session, ordered by time
+     *
+     * @return QStringList
+     */
+    QStringList fileNames() const;
+
+    /**
+     * @brief Return session start in nanoseconds since epoch
+     *
+     * @return qint64
+     */
+    qint64 startTime() const { return _files.isEmpty() ? 0 : _files.first().startTime; }
+
+    /**
+     * @brief Return the number of indexed packets of all logs
+     *
+     * @return int
+     */
+    int size() const;
+
+    /**
+     * @brief Return packet timestamp in nanoseconds since the start of the session
+     *
+     * @param index
+     * @return qint64
+     */
+    qint64 timestamp(int index) const;
+
+    /**
+     * @brief Return the index of the first packet with timestamp equal or after time
+     *
+     * @param time
+     * @return int size() if all packets are before time
+     */
+    int indexAt(qint64 time) const;
+
+    /**
+     * @brief Return the nearest packet before index that can be decoded without previous packets
+     *
+     * @param index
+     * @return int
+     */
+    int keyframeIndex(int index) const;
+
+    /**
+     * @brief Decode packet data
+     *
+     * @param index
+     * @return QByteArray empty if index is invalid
+     */
+    QByteArray packet(int index) const;
+
+    /**
+     * @brief Return the size in bytes of all logs
+     *
+     * @return qint64
+     */
+    qint64 byteSize() const { return _byteSize; }
+
+    // Maximum time between the end of a log and the start of the next one
+    static const qint64 maximumGapNSecs = 1000 * 1000000LL;
+
+signals:
+    /**
+     * @brief New packets are available, emitted from the indexing threads
+     *
+     */
+    void indexUpdated();
+
+    /**
+     * @brief All logs are indexed, emitted from the indexing thread
+     *
+     */
+    void indexFinished();
+
+private:
+    Q_DISABLE_COPY(SensorLogSession)
+
+    struct File {
+        QString fileName;
+        // First packet timestamp, in the reference of the log
+        qint64 firstTimestamp;
+        // First packet time in nanoseconds since epoch
+        qint64 startTime;
+    };
+
+    struct Segment {
+        // Position in _files
+        int file;
+        // Index of the first packet in the session
+        int firstRecord;
+        // Number of packets, the last segment grows while it's indexed
+        int count;
+        // Session time of the first packet
+        qint64 sessionOffset;
+    };
+
+    struct OpenLog {
+        int segment;
+        std::shared_ptr<SensorLogReader> reader;
+        // Open and index the log in background
+        QFuture<void> ready;
+        quint64 lastUse;
+    };
+
+    /**
+     * @brief Index all logs sequentially, runs in a worker thread
+     *
+     */
+    void buildIndex();
+
+    /**
+     * @brief Find the segment of a packet
+     *
+     * @param index packet in the session
+     * @param segment
+     * @param local packet in the log of the segment
+     * @return true
+     * @return false index is invalid
+     */
+    bool locate(int index, int* segment, int* local) const;
+
+    /**
+     * @brief Convert a timestamp of the log of a segment to session time
+     *
+     * @param segment
+     * @param timestamp
+     * @return qint64
+     */
+    qint64 sessionTime(int segment, qint64 timestamp) const;
+
+    /**
+     * @brief Return the reader of a segment, opening it if necessary
+     *  The next segment is opened in background and the least recently used logs are closed.
+     *
+     * @param segment
+     * @return std::shared_ptr<SensorLogReader> valid while the caller holds it, even if the log is closed
+     */
+    std::shared_ptr<SensorLogReader> reader(int segment) const;
+
+    /**
+     * @brief Return the open log of a segment or start opening it, _mutex should be locked
+     *
+     * @param segment
+     * @return OpenLog
+     */
+    OpenLog openLog(int segment) const;
+
+    /**
+     * @brief Return the number of packets of a segment, _mutex should be locked
+     *
+     * @param segment
+     * @return int
+     */
+    int segmentSize(int segment) const;
+
+    QVector<File> _files;
+    qint64 _byteSize = 0;
+
+    mutable QMutex _mutex;
+    QVector<Segment> _segments;
+    // Reader of the segment being indexed, it's also in _openLogs
+    std::shared_ptr<SensorLogReader> _indexingReader;
+
+    // Playback, background readers (e.g. LogOverview) and the prefetched log
+    static const int _maximumOpenLogs = 4;
+    mutable QVector<OpenLog> _openLogs;
+    mutable quint64 _useCounter = 0;
+
+    // Indexing and opening logs, readers index in the global pool
+    mutable QThreadPool _pool;
+    QFuture<void> _indexFuture;
+    std::atomic<bool> _indexing{false};
+    std::atomic<bool> _abortIndexing{false};
+};
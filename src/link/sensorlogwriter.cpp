@@ -0,0 +1,157 @@
+#include <QFileInfo>
+
+#include "logger.h"
+#include "profiledeltacodec.h"
+#include "sensorlogreader.h"
+#include "sensorlogwriter.h"
+
+PING_LOGGING_CATEGORY(SENSORLOGWRITER, "ping.sensorlogwriter");
+
+SensorLogWriter::SensorLogWriter() = default;
+
+bool SensorLogWriter::open(const QString& fileName, qint64 startTime, bool compress, quint32 chunkSize)
+{
+    close();
+
+    _compress = compress;
+    _header.startTime = startTime;
+    _header.chunkSize = chunkSize;
+    _payload.clear();
+    _payload.reserve(chunkSize);
+    _recordOffsets.clear();
+
+    _file.setFileName(fileName);
+    if(!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(SENSORLOGWRITER) << "Not possible to create log:" << fileName << _file.errorString();
+        return false;
+    }
+
+    const QByteArray header = _header.toByteArray();
+    return _file.write(header) == header.size();
+}
+
+bool SensorLogWriter::append(qint64 timestamp, const QByteArray& data)
+{
+    if(!_file.isOpen()) {
+        return false;
+    }
+
+    if(_recordOffsets.isEmpty()) {
+        _chunk.firstTimestamp = timestamp;
+    }
+    _chunk.lastTimestamp = timestamp;
+    _recordOffsets.append(_payload.size());
+
+    uchar recordHeader[SensorLogFormat::recordHeaderSize];
+    qToLittleEndian<qint64>(timestamp, recordHeader);
+    qToLittleEndian<quint32>(data.size(), recordHeader + 8);
+    _payload.append(reinterpret_cast<const char*>(recordHeader), sizeof(recordHeader));
+    _payload.append(data);
+
+    if(static_cast<quint32>(_payload.size()) >= _header.chunkSize) {
+        return flush();
+    }
+    return true;
+}
+
+bool SensorLogWriter::flush()
+{
+    if(!_file.isOpen() || _recordOffsets.isEmpty()) {
+        return true;
+    }
+
+    // Footer index
+    for(const quint32 offset : _recordOffsets) {
+        uchar littleEndianOffset[sizeof(quint32)];
+        qToLittleEndian<quint32>(offset, littleEndianOffset);
+        _payload.append(reinterpret_cast<const char*>(littleEndianOffset), sizeof(littleEndianOffset));
+    }
+
+    _chunk.flags = 0;
+    _chunk.rawSize = _payload.size();
+    _chunk.recordCount = _recordOffsets.size();
+
+    QByteArray payload;
+    if(_compress) {
+        // Adjacent profiles are correlated, the difference between them compresses better
+        QByteArray encoded = _payload;
+        const bool deltaEncoded = ProfileDeltaCodec::encode(encoded, _recordOffsets.size());
+        payload = qCompress(deltaEncoded ? encoded : _payload);
+        // Random data can be bigger after compression
+        if(payload.size() < _payload.size()) {
+            _chunk.flags |= SensorLogFormat::ChunkCompressed;
+            if(deltaEncoded) {
+                _chunk.flags |= SensorLogFormat::ChunkDeltaEncoded;
+            }
+        } else {
+            payload = _payload;
+        }
+    } else {
+        payload = _payload;
+    }
+    _chunk.storedSize = payload.size();
+
+    const QByteArray chunkHeader = _chunk.toByteArray();
+    const bool ok = _file.write(chunkHeader) == chunkHeader.size() && _file.write(payload) == payload.size();
+    if(!ok) {
+        qCWarning(SENSORLOGWRITER) << "Failed to write chunk:" << _file.errorString();
+    }
+
+    // Keep the allocated memory for the next chunk
+    _payload.resize(0);
+    _recordOffsets.resize(0);
+    _file.flush();
+    return ok;
+}
+
+void SensorLogWriter::close()
+{
+    if(!_file.isOpen()) {
+        return;
+    }
+    flush();
+    _file.close();
+}
+
+bool SensorLogWriter::convert(const QString& input, const QString& output, bool compress)
+{
+    SensorLogReader reader;
+    if(!reader.open(input)) {
+        return false;
+    }
+    reader.waitForIndex();
+
+    if(!reader.size()) {
+        qCWarning(SENSORLOGWRITER) << "No packets to convert in:" << input;
+        return false;
+    }
+
+    // Version 1 logs only have the time since the log started,
+    // the modification date is the time of the last packet
+    const qint64 firstTimestamp = reader.timestamp(0);
+    qint64 startTime = reader.startTime();
+    if(!startTime) {
+        const qint64 duration = reader.timestamp(reader.size() - 1) - firstTimestamp;
+        startTime = QFileInfo(input).lastModified().toMSecsSinceEpoch() * 1000000 - duration;
+    }
+
+    SensorLogWriter writer;
+    if(!writer.open(output, startTime, compress)) {
+        return false;
+    }
+
+    for(int i = 0; i < reader.size(); i++) {
+        if(!writer.append(reader.timestamp(i) - firstTimestamp, reader.packet(i))) {
+            return false;
+        }
+    }
+    writer.close();
+
+    qCInfo(SENSORLOGWRITER) << "Converted" << reader.size() << "packets from" << input << "to" << output;
+    return true;
+}
+
+SensorLogWriter::~SensorLogWriter()
+{
+    close();
+}
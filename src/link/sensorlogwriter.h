@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QVector>
+
+#include "sensorlogformat.h"
+
+Q_DECLARE_LOGGING_CATEGORY(SENSORLOGWRITER)
+
+/**
+ * @brief Write sensor logs in the version 2 format (SensorLogFormat)
+ *  Records are accumulated in memory and written as a chunk when the chunk size is reached
+ *  or when flush is called.
+ *
+ */
+class SensorLogWriter
+{
+public:
+    /**
+     * @brief Construct a new Sensor Log Writer object
+     *
+     */
+    SensorLogWriter();
+
+    /**
+     * @brief Destroy the Sensor Log Writer object, pending records are written
+     *
+     */
+    ~SensorLogWriter();
+
+    /**
+     * @brief Create the log file and write the file header
+     *
+     * @param fileName
+     * @param startTime log start in nanoseconds since epoch
+     * @param compress compress chunks with qCompress
+     * @param chunkSize
+     * @return true
+     * @return false
+     */
+    bool open(const QString& fileName, qint64 startTime, bool compress = false,
+              quint32 chunkSize = SensorLogFormat::defaultChunkSize);
+
+    /**
+     * @brief Append a new record
+     *
+     * @param timestamp nanoseconds since startTime
+     * @param data
+     * @return true
+     * @return false chunk could not be written
+     */
+    bool append(qint64 timestamp, const QByteArray& data);
+
+    /**
+     * @brief Write pending records as a chunk
+     *
+     * @return true
+     * @return false
+     */
+    bool flush();
+
+    /**
+     * @brief Write pending records and close the file
+     *
+     */
+    void close();
+
+    /**
+     * @brief Return true if the log is open
+     *
+     * @return true
+     * @return false
+     */
+    bool isOpen() const { return _file.isOpen(); }
+
+    /**
+     * @brief Return the underlying file, E.g: to sync it with the disk
+     *
+     * @return QFile*
+     */
+    QFile* file() { return &_file; }
+
+    /**
+     * @brief Convert any log readable by SensorLogReader to the version 2 format
+     *
+     * @param input
+     * @param output
+     * @param compress
+     * @return true
+     * @return false
+     */
+    static bool convert(const QString& input, const QString& output, bool compress = true);
+
+private:
+    Q_DISABLE_COPY(SensorLogWriter)
+
+    bool _compress = false;
+    SensorLogFormat::FileHeader _header;
+    QFile _file;
+
+    // Chunk being written
+    SensorLogFormat::ChunkHeader _chunk;
+    QByteArray _payload;
+    QVector<quint32> _recordOffsets;
+};
@@ -1,10 +1,15 @@
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 #include <QSerialPortInfo>
-#include <QThread>
-#include <QTimer>
+
+#ifdef Q_OS_LINUX
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#endif
 
 #include "seriallink.h"
+#include "settingsmanager.h"
 
 Q_LOGGING_CATEGORY(PING_PROTOCOL_SERIALLINK, "ping.protocol.seriallink")
 
@@ -13,23 +18,37 @@ SerialLink::SerialLink(QObject* parent)
 {
     setType(LinkType::Serial);
 
-    connect(&_port, &QIODevice::readyRead, this, [this]() {
-        emit newData(_port.readAll());
-    });
+    _stateTimer.setSingleShot(true);
+    // The automatic baud rate sequence has steps of a few milliseconds
+    _stateTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_stateTimer, &QTimer::timeout, this, &SerialLink::advance);
 
-    connect(this, &AbstractLink::sendData, this, [this](const QByteArray& data) {
-        _port.write(data);
+    connect(&_port, &QIODevice::readyRead, this, &SerialLink::readData);
+
+    connect(this, &AbstractLink::sendData, this, &SerialLink::writeData);
+
+    // Settings are applied to the open port, they don't wait for a reconnection
+    connect(SettingsManager::self(), &SettingsManager::serialLowLatencyChanged, this, [this] {
+        if(_port.isOpen()) {
+            setLowLatency(SettingsManager::self()->serialLowLatency());
+        }
+    });
+    connect(SettingsManager::self(), &SettingsManager::serialReadBufferSizeChanged, this, [this] {
+        _port.setReadBufferSize(qMax(0, SettingsManager::self()->serialReadBufferSize()));
     });
 
     connect(&_port, &QSerialPort::errorOccurred, this, [this](QSerialPort::SerialPortError error) {
-        switch(error) {
-        case QSerialPort::NoError:
-            break;
-        default:
-            qCWarning(PING_PROTOCOL_SERIALLINK) << "Error is critical ! Port need to be closed.";
-            qCWarning(PING_PROTOCOL_SERIALLINK) << "Error:" << error;
+        // Failed reopen attempts are handled by advance
+        if(error == QSerialPort::NoError || _state == State::Reconnecting) {
+            return;
+        }
+
+        qCWarning(PING_PROTOCOL_SERIALLINK) << "Error is critical ! Port need to be closed.";
+        qCWarning(PING_PROTOCOL_SERIALLINK) << "Error:" << error;
+        if(_active) {
+            scheduleReconnect();
+        } else {
             finishConnection();
-            break;
         }
     });
 }
@@ -64,6 +83,13 @@ bool SerialLink::startConnection()
         return false;
     }
 
+    _active = true;
+    _reconnectMSecs = minimumReconnectMSecs;
+    _chunks = 0;
+    _chunkBytes = 0;
+    _handlingNSecs = 0;
+    _maximumHandlingNSecs = 0;
+    configurePort();
     forceSensorAutomaticBaudRateDetection();
 
     return true;
@@ -71,7 +97,12 @@ bool SerialLink::startConnection()
 
 bool SerialLink::finishConnection()
 {
+    _active = false;
+    _state = State::Closed;
+    _stateTimer.stop();
+    _pendingData.clear();
     if(_port.isOpen()) {
+        restoreSerialFlags();
         _port.close();
         qCDebug(PING_PROTOCOL_SERIALLINK) << "Port closed.";
     }
@@ -104,18 +135,188 @@ void SerialLink::setBaudRate(int baudRate)
 
 void SerialLink::forceSensorAutomaticBaudRateDetection()
 {
+    if(!_port.isOpen()) {
+        return;
+    }
+
     /** ABR fluxogram
      * 1. Use break to force a 0 logical state for an entire frame
      * 2. Send U (0b01010101) to allow an automatic baud rate detection
      * 3. Force a write condition in the serial using the `flush` command
+     * Each step waits in the event loop, see advance
      */
     _port.setBreakEnabled(true);
-    QThread::usleep(500);
-    _port.setBreakEnabled(false);
-    QThread::msleep(11);
-    _port.write("UUU");
-    _port.flush();
-    QThread::msleep(11);
+    _state = State::Break;
+    _stateTimer.start(1);
+}
+
+void SerialLink::advance()
+{
+    // Time between each state of the automatic baud rate sequence
+    static const int syncMSecs = 11;
+
+    switch(_state) {
+    case State::Break:
+        _port.setBreakEnabled(false);
+        _state = State::BreakReleased;
+        _stateTimer.start(syncMSecs);
+        break;
+
+    case State::BreakReleased:
+        _port.write("UUU");
+        _port.flush();
+        _state = State::Sync;
+        _stateTimer.start(syncMSecs);
+        break;
+
+    case State::Sync:
+        _state = State::Ready;
+        if(!_pendingData.isEmpty()) {
+            _port.write(_pendingData);
+            _pendingData.clear();
+        }
+        break;
+
+    case State::Reconnecting:
+        if(!_port.open(QIODevice::ReadWrite)) {
+            qCDebug(PING_PROTOCOL_SERIALLINK) << "Fail to reopen serial port:" << _port.errorString();
+            _reconnectMSecs = qMin(_reconnectMSecs * 2, maximumReconnectMSecs);
+            _stateTimer.start(_reconnectMSecs);
+            break;
+        }
+        qCDebug(PING_PROTOCOL_SERIALLINK) << "Serial port reopened.";
+        _reconnectMSecs = minimumReconnectMSecs;
+        configurePort();
+        forceSensorAutomaticBaudRateDetection();
+        break;
+
+    case State::Closed:
+    case State::Ready:
+        break;
+    }
+}
+
+void SerialLink::configurePort()
+{
+    _port.setReadBufferSize(qMax(0, SettingsManager::self()->serialReadBufferSize()));
+
+#ifdef Q_OS_LINUX
+    // The flags are restored when the port is closed, the kernel keeps them after the port is closed
+    struct serial_struct serial;
+    _originalSerialFlags = ioctl(_port.handle(), TIOCGSERIAL, &serial) < 0 ? -1 : serial.flags;
+#endif
+
+    // The setting is applied even if it's disabled, clearing any flag that was not restored (e.g. after a crash)
+    if(_originalSerialFlags >= 0) {
+        setLowLatency(SettingsManager::self()->serialLowLatency());
+    }
+}
+
+void SerialLink::restoreSerialFlags()
+{
+#ifdef Q_OS_LINUX
+    struct serial_struct serial;
+    if(_originalSerialFlags < 0 || ioctl(_port.handle(), TIOCGSERIAL, &serial) < 0) {
+        return;
+    }
+
+    serial.flags = _originalSerialFlags;
+    if(ioctl(_port.handle(), TIOCSSERIAL, &serial) < 0) {
+        qCWarning(PING_PROTOCOL_SERIALLINK) << "Not possible to restore serial flags.";
+    }
+#endif
+    _originalSerialFlags = -1;
+}
+
+bool SerialLink::setLowLatency(bool enabled)
+{
+#ifdef Q_OS_LINUX
+    struct serial_struct serial;
+    if(!_port.isOpen() || ioctl(_port.handle(), TIOCGSERIAL, &serial) < 0) {
+        qCWarning(PING_PROTOCOL_SERIALLINK) << "Low latency mode is not supported by the port.";
+        return false;
+    }
+
+    if(enabled) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+    } else {
+        serial.flags &= ~ASYNC_LOW_LATENCY;
+    }
+    if(ioctl(_port.handle(), TIOCSSERIAL, &serial) < 0) {
+        qCWarning(PING_PROTOCOL_SERIALLINK) << "Not possible to change low latency mode.";
+        return false;
+    }
+
+    qCDebug(PING_PROTOCOL_SERIALLINK) << "Low latency mode:" << enabled;
+    return true;
+#else
+    Q_UNUSED(enabled)
+    qCDebug(PING_PROTOCOL_SERIALLINK) << "Low latency mode is only available in Linux.";
+    return false;
+#endif
+}
+
+bool SerialLink::isLowLatency() const
+{
+#ifdef Q_OS_LINUX
+    struct serial_struct serial;
+    return _port.isOpen() && ioctl(_port.handle(), TIOCGSERIAL, &serial) == 0 && (serial.flags & ASYNC_LOW_LATENCY);
+#else
+    return false;
+#endif
+}
+
+void SerialLink::readData()
+{
+    QElapsedTimer handlingTimer;
+    handlingTimer.start();
+    const QByteArray data = _port.readAll();
+    if(data.isEmpty()) {
+        return;
+    }
+    emit newData(data);
+
+    const qint64 handlingTime = handlingTimer.nsecsElapsed();
+    _chunks++;
+    _chunkBytes += data.size();
+    _handlingNSecs += handlingTime;
+    _maximumHandlingNSecs = qMax(_maximumHandlingNSecs, handlingTime);
+}
+
+QVariantMap SerialLink::statistics()
+{
+    return {
+        {"lowLatency", isLowLatency()},
+        {"chunks", _chunks},
+        {"bytesPerChunk", _chunks ? double(_chunkBytes) / _chunks : 0.0},
+        {"meanHandlingUs", _chunks ? _handlingNSecs / 1000.0 / _chunks : 0.0},
+        {"maximumHandlingUs", _maximumHandlingNSecs / 1000.0},
+    };
+}
+
+void SerialLink::scheduleReconnect()
+{
+    if(_port.isOpen()) {
+        restoreSerialFlags();
+        _port.close();
+    }
+    qCDebug(PING_PROTOCOL_SERIALLINK) << "Reopening serial port in" << _reconnectMSecs << "ms.";
+    _state = State::Reconnecting;
+    _stateTimer.start(_reconnectMSecs);
+}
+
+void SerialLink::writeData(const QByteArray& data)
+{
+    if(_state == State::Ready) {
+        _port.write(data);
+        return;
+    }
+
+    if(_state == State::Closed || _pendingData.size() + data.size() > _maximumPendingData) {
+        qCDebug(PING_PROTOCOL_SERIALLINK) << "Port is not ready, dropping" << data.size() << "bytes.";
+        return;
+    }
+    _pendingData.append(data);
 }
 
 SerialLink::~SerialLink()
@@ -1,11 +1,18 @@
 #pragma once
 
 #include <QSerialPort>
+#include <QTimer>
 
 #include "abstractlink.h"
 
 /**
  * @brief Serial Link connection class
+ *  The automatic baud rate sequence (break, "UUU") and reconnections are driven by a timer,
+ *  nothing blocks the calling thread. Data sent while the sequence runs is written after it.
+ *  If the port fails (e.g. USB adapter removed) it's reopened with an exponential backoff until finishConnection.
+ *  The optional low latency mode (SettingsManager::serialLowLatency) sets ASYNC_LOW_LATENCY in Linux,
+ *  reducing the time that FTDI and CDC adapters keep bytes before reporting them.
+ *  The setting is applied while the port is open, the original serial flags are restored when it's closed.
  *
  */
 class SerialLink : public AbstractLink
@@ -47,6 +54,14 @@ public:
      */
     bool isOpen() final { return _port.isWritable() && _port.isReadable(); };
 
+    /**
+     * @brief Return true if the port is open and the automatic baud rate sequence is done
+     *
+     * @return true
+     * @return false
+     */
+    bool isReady() const { return _state == State::Ready; };
+
     /**
      * @brief Return a list of all available connections
      *
@@ -79,6 +94,32 @@ public:
      */
     bool startConnection() final override;
 
+    /**
+     * @brief Enable or disable the low latency mode of the open port
+     *
+     * @param enabled
+     * @return true
+     * @return false not supported by the port or the system
+     */
+    bool setLowLatency(bool enabled);
+
+    /**
+     * @brief Return true if the low latency mode is enabled in the open port, read from the port flags
+     *
+     * @return true
+     * @return false
+     */
+    bool isLowLatency() const;
+
+    /**
+     * @brief Return link statistics: chunks, bytes per chunk and handling time of each chunk
+     *  The handling time is measured from readyRead to the end of newData, parsers are connected directly.
+     *  It does not include the time that bytes wait in the adapter and driver, reduced by the low latency mode.
+     *
+     * @return QVariantMap
+     */
+    QVariantMap statistics() final;
+
     /**
      * @brief Set a valid baudrate
      *
@@ -88,10 +129,80 @@ public:
 
     /**
      * @brief Force sensor to do automatic baud rate detection
+     *  The sequence is asynchronous, data sent before it finishes is kept and written after it.
      *
      */
     void forceSensorAutomaticBaudRateDetection();
 
+    static const int minimumReconnectMSecs = 500;
+    static const int maximumReconnectMSecs = 5000;
+
 private:
+    enum class State {
+        Closed,
+        // Break enabled, forces a 0 logical state for an entire frame
+        Break,
+        // Idle line after the break
+        BreakReleased,
+        // "UUU" written, waiting the sensor to detect the baud rate
+        Sync,
+        Ready,
+        // Port failed, waiting to reopen it
+        Reconnecting,
+    };
+
+    /**
+     * @brief Save the serial flags and apply low latency mode and read buffer size after opening the port
+     *
+     */
+    void configurePort();
+
+    /**
+     * @brief Restore the serial flags saved by configurePort, before closing the port
+     *
+     */
+    void restoreSerialFlags();
+
+    /**
+     * @brief Move to the next state of the automatic baud rate sequence or reconnect
+     *
+     */
+    void advance();
+
+    /**
+     * @brief Read available data and measure the time to handle it
+     *
+     */
+    void readData();
+
+    /**
+     * @brief Close the port and schedule a reconnection
+     *
+     */
+    void scheduleReconnect();
+
+    /**
+     * @brief Write data, or keep it until the port is ready
+     *
+     * @param data
+     */
+    void writeData(const QByteArray& data);
+
+    // Data sent while the port is not ready, limited to avoid growing while disconnected
+    static const int _maximumPendingData = 64 * 1024;
+    QByteArray _pendingData;
+
+    // Statistics of readData
+    quint64 _chunks = 0;
+    quint64 _chunkBytes = 0;
+    qint64 _handlingNSecs = 0;
+    qint64 _maximumHandlingNSecs = 0;
+
+    bool _active = false;
+    // Serial flags (Linux TIOCGSERIAL) when the port was opened, -1 if not available
+    int _originalSerialFlags = -1;
+    int _reconnectMSecs = minimumReconnectMSecs;
+    State _state = State::Closed;
+    QTimer _stateTimer;
     QSerialPort _port;
 };
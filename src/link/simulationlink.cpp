@@ -1,6 +1,181 @@
+#include <QLoggingCategory>
+#include <QtMath>
+
 #include "simulationlink.h"
 
-SimulationLink::SimulationLink(QObject* parent)
+Q_LOGGING_CATEGORY(PING_PROTOCOL_SIMULATIONLINK, "ping.protocol.simulationlink")
+
+SimulationLink::SimulationLink(int defaultSamples, QObject* parent)
     : AbstractLink(parent)
+    , _samples(defaultSamples)
+{
+    _updateTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_updateTimer, &QTimer::timeout, this, &SimulationLink::update);
+}
+
+bool SimulationLink::setConfiguration(const LinkConfiguration& linkConfiguration)
+{
+    _linkConfiguration = linkConfiguration;
+    setName(linkConfiguration.name());
+
+    for(const auto& arg : *linkConfiguration.args()) {
+        const QString key = arg.section('=', 0, 0).trimmed();
+        const QString value = arg.section('=', 1).trimmed();
+        bool ok = true;
+        if(key == QLatin1String("rate")) {
+            _rate = value.toDouble(&ok);
+            ok = ok && _rate > 0 && _rate <= maximumRate;
+        } else if(key == QLatin1String("samples")) {
+            _samples = value.toInt(&ok);
+            ok = ok && _samples > 0 && _samples <= 0xffff;
+        } else if(key == QLatin1String("noise")) {
+            static const QStringList models = {"none", "uniform", "gaussian"};
+            ok = models.contains(value);
+            _noiseModel = static_cast<NoiseModel>(models.indexOf(value));
+        } else if(key == QLatin1String("noiseLevel")) {
+            _noiseLevel = value.toFloat(&ok);
+            ok = ok && _noiseLevel >= 0;
+        } else if(key == QLatin1String("seed")) {
+            _seed = value.toUInt(&ok);
+        } else if(key == QLatin1String("burst")) {
+            bool okOff;
+            _burstOnMs = value.section(':', 0, 0).toInt(&ok);
+            _burstOffMs = value.section(':', 1, 1).toInt(&okOff);
+            ok = ok && okOff && _burstOnMs > 0 && _burstOffMs >= 0;
+        } else {
+            ok = false;
+        }
+
+        if(!ok) {
+            qCWarning(PING_PROTOCOL_SIMULATIONLINK) << "Invalid simulation argument:" << arg;
+            return false;
+        }
+    }
+
+    qCDebug(PING_PROTOCOL_SIMULATIONLINK) << "Simulation with" << _rate << "messages/s," << _samples << "samples,"
+                                          << "noise" << _noiseModel << _noiseLevel << "seed" << _seed
+                                          << "burst" << _burstOnMs << _burstOffMs;
+    return true;
+}
+
+bool SimulationLink::startConnection()
+{
+    _counter = 0;
+    _messages = 0;
+    _bytes = 0;
+    _skipped = 0;
+    _elapsedTimer.start();
+
+    // Slow rates use one tick per message, fast rates deliver all due messages every millisecond
+    _updateTimer.start(qBound(1, qRound(1000 / _rate), 1000));
+    return true;
+}
+
+bool SimulationLink::finishConnection()
+{
+    _updateTimer.stop();
+    return true;
+}
+
+quint64 SimulationLink::dueMessages(qint64 elapsedMs) const
+{
+    qint64 activeMs = elapsedMs;
+    if(_burstOnMs && _burstOffMs) {
+        const qint64 period = _burstOnMs + _burstOffMs;
+        activeMs = elapsedMs / period * _burstOnMs + qMin<qint64>(elapsedMs % period, _burstOnMs);
+    }
+    // The first message is generated when the simulation starts
+    return static_cast<quint64>(activeMs * _rate / 1000) + 1;
+}
+
+void SimulationLink::update()
+{
+    const quint64 due = dueMessages(_elapsedTimer.elapsed());
+    if(due <= _counter) {
+        return;
+    }
+
+    quint64 count = due - _counter;
+    const quint64 maximumCount = qMax<quint64>(1, _rate * maximumDelayMs / 1000);
+    if(count > maximumCount) {
+        // Skipped messages keep their numbers, the stream continues as it would without the delay
+        _skipped += count - maximumCount;
+        _counter += count - maximumCount;
+        count = maximumCount;
+    }
+
+    QByteArray buffer;
+    for(quint64 i = 0; i < count; i++) {
+        _counter++;
+        // Each message has its own random sequence, it depends only on the seed and the message number
+        quint32 state = _seed ^ (_counter * 0x9e3779b9u);
+        state = (state ^ (state >> 16)) * 0x85ebca6bu;
+        state = (state ^ (state >> 13)) * 0xc2b2ae35u;
+        state ^= state >> 16;
+        _randomState = state ? state : 1;
+
+        appendMessage(buffer, _counter);
+    }
+
+    _messages += count;
+    _bytes += buffer.size();
+    emit newData(buffer);
+}
+
+quint32 SimulationLink::random()
+{
+    // xorshift32, the same sequence in all platforms
+    _randomState ^= _randomState << 13;
+    _randomState ^= _randomState >> 17;
+    _randomState ^= _randomState << 5;
+    return _randomState;
+}
+
+float SimulationLink::noise(float amplitude)
+{
+    switch(_noiseModel) {
+    case UniformNoise:
+        return _noiseLevel * amplitude * (random() & 0xff);
+    case GaussianNoise: {
+        // Irwin-Hall approximation, mean 128 and standard deviation 42
+        float sum = 0;
+        for(int i = 0; i < 4; i++) {
+            sum += (random() & 0xffff) / 65536.0f;
+        }
+        const float value = 128 + 42 * (sum - 2) * 1.7320508f;
+        return _noiseLevel * amplitude * qBound(0.0f, value, 255.0f);
+    }
+    case NoNoise:
+    default:
+        return 0;
+    }
+}
+
+void SimulationLink::fillProfile(uint8_t* samples, int size, float stop1, float stop2)
+{
+    const float width = stop2 - stop1;
+    const float center = stop1 + width / 2;
+    const float factor = -4 / (width * width);
+    for(int i = 0; i < size; i++) {
+        float point;
+        if(i < stop1) {
+            point = noise(0.1);
+        } else if(i < stop2) {
+            const float distance = i - center;
+            point = 255 * (factor * distance * distance + 1);
+        } else {
+            point = noise(0.45);
+        }
+        samples[i] = static_cast<uint8_t>(qBound(0.0f, point, 255.0f));
+    }
+}
+
+QVariantMap SimulationLink::statistics()
 {
-}
\ No newline at end of file
+    return {
+        {"messages", _messages},
+        {"bytes", _bytes},
+        {"skipped", _skipped},
+        {"rate", _rate},
+    };
+}
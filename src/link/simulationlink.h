@@ -1,21 +1,56 @@
 #pragma once
 
+#include <QElapsedTimer>
+#include <QTimer>
+
 #include "abstractlink.h"
 #include "parser-ping.h"
 
 /**
  * @brief Simulation connection class
+ *  Messages are generated at a configurable rate, the link configuration arguments are key=value pairs:
+ *   rate=<messages per second>, samples=<profile size>, noise=<none|uniform|gaussian>, noiseLevel=<scale>,
+ *   seed=<integer> and burst=<on ms>:<off ms>, messages are only generated during the on part of each burst period.
+ *  The content of the messages only depends on the seed and the message number, a simulation with the same
+ *  configuration generates the same stream. Messages that are due in the same timer tick are delivered
+ *  together in one newData, this allows rates of thousands of messages per second.
  *
  */
 class SimulationLink : public AbstractLink
 {
 public:
+    /**
+     * @brief Noise added to the simulated profiles
+     *
+     */
+    enum NoiseModel {
+        NoNoise,
+        UniformNoise,
+        GaussianNoise,
+    };
+
     /**
      * @brief Construct a new Simulation Link object
      *
+     * @param defaultSamples profile size if not configured
      * @param parent
      */
-    SimulationLink(QObject* parent = nullptr);
+    SimulationLink(int defaultSamples, QObject* parent = nullptr);
+
+    /**
+     * @brief Stop generating messages
+     *
+     * @return true
+     */
+    bool finishConnection() final;
+
+    /**
+     * @brief Check if messages are being generated
+     *
+     * @return true
+     * @return false
+     */
+    bool isOpen() final { return _updateTimer.isActive(); };
 
     /**
      * @brief Check if connection is writable
@@ -24,4 +59,111 @@ public:
      * @return false
      */
     bool isWritable() final { return false; };
+
+    /**
+     * @brief Return the number of generated messages
+     *
+     * @return quint64
+     */
+    quint64 messages() const { return _messages; };
+
+    /**
+     * @brief Set the configuration object
+     *
+     * @param linkConfiguration
+     * @return true
+     * @return false invalid argument
+     */
+    bool setConfiguration(const LinkConfiguration& linkConfiguration) final;
+
+    /**
+     * @brief Start generating messages, the stream starts from the seed again
+     *
+     * @return true
+     */
+    bool startConnection() final;
+
+    /**
+     * @brief Return link statistics: messages, bytes and configured rate
+     *
+     * @return QVariantMap
+     */
+    QVariantMap statistics() final;
+
+    static const int defaultRate = 20;
+    static const int maximumRate = 100000;
+    // Messages that are late by more than this are skipped, e.g. after the event loop was blocked
+    static const int maximumDelayMs = 100;
+
+protected:
+    /**
+     * @brief Append a new message
+     *
+     * @param buffer
+     * @param counter message number, starts with 1
+     */
+    virtual void appendMessage(QByteArray& buffer, uint counter) = 0;
+
+    /**
+     * @brief Fill profile samples with the simulated bottom between stop1 and stop2 and noise elsewhere
+     *
+     * @param samples
+     * @param size
+     * @param stop1
+     * @param stop2
+     */
+    void fillProfile(uint8_t* samples, int size, float stop1, float stop2);
+
+    /**
+     * @brief Return a deterministic pseudo random number
+     *
+     * @return quint32
+     */
+    quint32 random();
+
+    /**
+     * @brief Return a noise sample in [0, 255 * amplitude] following the noise model
+     *
+     * @param amplitude
+     * @return float
+     */
+    float noise(float amplitude);
+
+    /**
+     * @brief Return the number of samples of each profile
+     *
+     * @return int
+     */
+    int samples() const { return _samples; };
+
+private:
+    /**
+     * @brief Generate all messages that are due
+     *
+     */
+    void update();
+
+    /**
+     * @brief Return the number of messages that should have been generated after elapsedMs
+     *
+     * @param elapsedMs
+     * @return quint64
+     */
+    quint64 dueMessages(qint64 elapsedMs) const;
+
+    int _burstOffMs = 0;
+    int _burstOnMs = 0;
+    quint64 _bytes = 0;
+    uint _counter = 0;
+    QElapsedTimer _elapsedTimer;
+    quint64 _messages = 0;
+    NoiseModel _noiseModel = UniformNoise;
+    float _noiseLevel = 1;
+    double _rate = defaultRate;
+    quint32 _randomState = 1;
+    int _samples;
+    quint32 _seed = 1;
+    // Messages skipped by maximumDelayMs, they are not generated
+    quint64 _skipped = 0;
+    QTimer _updateTimer;
 };
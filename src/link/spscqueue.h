@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Lock-free bounded queue for a single producer and a single consumer thread
+ *  The capacity is rounded up to a power of two.
+ *
+ * @tparam T
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    /**
+     * @brief Construct a new Spsc Queue object
+     *
+     * @param capacity maximum number of items
+     */
+    explicit SpscQueue(size_t capacity)
+        : _buffer(roundUpToPowerOfTwo(capacity))
+        , _mask(_buffer.size() - 1)
+    {
+    }
+
+    /**
+     * @brief Add an item, only called by the producer thread
+     *
+     * @param item
+     * @return true
+     * @return false the queue is full
+     */
+    bool push(T&& item)
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if(tail - _head.load(std::memory_order_acquire) == _buffer.size()) {
+            return false;
+        }
+        _buffer[tail & _mask] = std::move(item);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest item, only called by the consumer thread
+     *
+     * @param item
+     * @return true
+     * @return false the queue is empty
+     */
+    bool pop(T& item)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if(head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = std::move(_buffer[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Return the number of items, it's only a snapshot if called while the other thread is running
+     *
+     * @return size_t
+     */
+    size_t size() const { return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Return true if the queue is empty
+     *
+     * @return true
+     * @return false
+     */
+    bool isEmpty() const { return size() == 0; }
+
+    /**
+     * @brief Return the maximum number of items
+     *
+     * @return size_t
+     */
+    size_t capacity() const { return _buffer.size(); }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t power = 1;
+        while(power < value) {
+            power <<= 1;
+        }
+        return power;
+    }
+
+    std::vector<T> _buffer;
+    const size_t _mask;
+
+    // Producer and consumer indexes in different cache lines
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<size_t> _tail{0};
+};
@@ -1,10 +1,136 @@
 #include <QDebug>
+#include <QLoggingCategory>
 
 #include "tcplink.h"
 
+Q_LOGGING_CATEGORY(PING_PROTOCOL_TCPLINK, "ping.protocol.tcplink")
+
 TCPLink::TCPLink(QObject* parent)
     : AbstractLink(parent)
+    , _tcpSocket(new QTcpSocket(this))
+{
+    setType(LinkType::Tcp);
+
+    _reconnectTimer.setSingleShot(true);
+    connect(&_reconnectTimer, &QTimer::timeout, this, &TCPLink::connectToHost);
+
+    connect(_tcpSocket, &QAbstractSocket::connected, this, [this] {
+        qCDebug(PING_PROTOCOL_TCPLINK) << "Connected to" << _hostAddress << _port;
+        configureSocket();
+        _reconnectMSecs = minimumReconnectMSecs;
+    });
+
+    // Failed connections and drops end in the unconnected state
+    connect(_tcpSocket, &QAbstractSocket::stateChanged, this, [this](QAbstractSocket::SocketState state) {
+        if(state == QAbstractSocket::UnconnectedState) {
+            scheduleReconnect();
+        }
+    });
+
+    connect(_tcpSocket, &QIODevice::readyRead, this, &TCPLink::readData);
+    connect(this, &AbstractLink::sendData, this, &TCPLink::writeData);
+}
+
+bool TCPLink::setConfiguration(const LinkConfiguration& linkConfiguration)
+{
+    _linkConfiguration = linkConfiguration;
+    qCDebug(PING_PROTOCOL_TCPLINK) << linkConfiguration;
+    if(!linkConfiguration.isValid()) {
+        qCDebug(PING_PROTOCOL_TCPLINK) << LinkConfiguration::errorToString(linkConfiguration.error());
+        return false;
+    }
+
+    setName(linkConfiguration.name());
+
+    _hostAddress = linkConfiguration.args()->at(0);
+    _port = linkConfiguration.args()->at(1).toUShort();
+    return true;
+}
+
+void TCPLink::setSocketBufferSizes(int receiveBufferSize, int sendBufferSize)
+{
+    _receiveBufferSize = qMax(0, receiveBufferSize);
+    _sendBufferSize = qMax(0, sendBufferSize);
+    if(isConnected()) {
+        configureSocket();
+    }
+}
+
+bool TCPLink::startConnection()
+{
+    if(_hostAddress.isEmpty() || !_port) {
+        qCWarning(PING_PROTOCOL_TCPLINK) << "Invalid host or port:" << _hostAddress << _port;
+        return false;
+    }
+
+    _active = true;
+    _reconnectMSecs = minimumReconnectMSecs;
+    _reconnections = 0;
+    connectToHost();
+    return true;
+}
+
+void TCPLink::connectToHost()
+{
+    if(!_active || _tcpSocket->state() != QAbstractSocket::UnconnectedState) {
+        return;
+    }
+
+    qCDebug(PING_PROTOCOL_TCPLINK) << "Connecting to" << _hostAddress << _port;
+    _tcpSocket->connectToHost(_hostAddress, _port);
+}
+
+void TCPLink::configureSocket()
+{
+    // Ping messages are small, don't wait to fill a segment
+    _tcpSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    if(_receiveBufferSize) {
+        _tcpSocket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, _receiveBufferSize);
+    }
+    if(_sendBufferSize) {
+        _tcpSocket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, _sendBufferSize);
+    }
+}
+
+void TCPLink::scheduleReconnect()
+{
+    if(!_active || _reconnectTimer.isActive()) {
+        return;
+    }
+
+    qCDebug(PING_PROTOCOL_TCPLINK) << "Not connected:" << _tcpSocket->errorString()
+                                   << "- reconnecting in" << _reconnectMSecs << "ms.";
+    _reconnections++;
+    _reconnectTimer.start(_reconnectMSecs);
+    _reconnectMSecs = qMin(_reconnectMSecs * 2, maximumReconnectMSecs);
+}
+
+void TCPLink::readData()
+{
+    const QByteArray data = _tcpSocket->readAll();
+    if(!data.isEmpty()) {
+        emit newData(data);
+    }
+}
+
+void TCPLink::writeData(const QByteArray& data)
+{
+    if(!isConnected()) {
+        qCDebug(PING_PROTOCOL_TCPLINK) << "Not connected, dropping" << data.size() << "bytes.";
+        return;
+    }
+
+    _tcpSocket->write(data);
+    // Write now instead of waiting for the event loop
+    _tcpSocket->flush();
+}
+
+bool TCPLink::finishConnection()
 {
+    _active = false;
+    _reconnectTimer.stop();
+    _tcpSocket->abort();
+    return true;
 }
 
 TCPLink::~TCPLink()
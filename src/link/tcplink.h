@@ -1,9 +1,16 @@
 #pragma once
 
+#include <QTcpSocket>
+#include <QTimer>
+
 #include "abstractlink.h"
 
 /**
  * @brief TCP connection class
+ *  The socket is configured for low latency (TCP_NODELAY) and all bytes available are delivered
+ *  in a single newData, the parser deals with partial and multiple messages.
+ *  Connections are done without blocking, if the connection fails or drops the link keeps trying
+ *  to reconnect with an exponential backoff until finishConnection is called.
  *
  */
 class TCPLink : public AbstractLink
@@ -21,4 +28,128 @@ public:
      *
      */
     ~TCPLink();
+
+    /**
+     * @brief Return a human friendly error message
+     *
+     * @return QString
+     */
+    QString errorString() final { return _tcpSocket->errorString(); };
+
+    /**
+     * @brief Finish connection and stop reconnecting
+     *
+     * @return true
+     * @return false
+     */
+    bool finishConnection() final;
+
+    /**
+     * @brief Check if the link is active, the socket may be reconnecting
+     *
+     * @return true
+     * @return false
+     */
+    bool isOpen() final { return _active; };
+
+    /**
+     * @brief Return true if the socket is connected
+     *
+     * @return true
+     * @return false
+     */
+    bool isConnected() const { return _tcpSocket->state() == QAbstractSocket::ConnectedState; };
+
+    /**
+     * @brief Return the number of reconnections after the first connection attempt
+     *
+     * @return int
+     */
+    int reconnections() const { return _reconnections; };
+
+    /**
+     * @brief Set the configuration object
+     *
+     * @param linkConfiguration
+     * @return true
+     * @return false
+     */
+    bool setConfiguration(const LinkConfiguration& linkConfiguration) final;
+
+    /**
+     * @brief Set kernel socket buffer sizes, applied in the next connection
+     *
+     * @param receiveBufferSize in bytes, 0 for the system default
+     * @param sendBufferSize in bytes, 0 for the system default
+     */
+    void setSocketBufferSizes(int receiveBufferSize, int sendBufferSize);
+
+    /**
+     * @brief Start connection, the socket connects in background
+     *
+     * @return true
+     * @return false the configuration is not valid
+     */
+    bool startConnection() final;
+
+    /**
+     * @brief Return link statistics: reconnections
+     *
+     * @return QVariantMap
+     */
+    QVariantMap statistics() final { return {{"reconnections", _reconnections}}; };
+
+    /**
+     * @brief Return QTcpSocket pointer
+     *
+     * @return QTcpSocket*
+     */
+    QTcpSocket* tcpSocket() { return _tcpSocket; };
+
+    static const int defaultReceiveBufferSize = 256 * 1024;
+    static const int defaultSendBufferSize = 64 * 1024;
+    static const int minimumReconnectMSecs = 100;
+    static const int maximumReconnectMSecs = 5000;
+
+private:
+    /**
+     * @brief Set socket options after connection
+     *
+     */
+    void configureSocket();
+
+    /**
+     * @brief Start a connection attempt
+     *
+     */
+    void connectToHost();
+
+    /**
+     * @brief Deliver all available bytes
+     *
+     */
+    void readData();
+
+    /**
+     * @brief Schedule the next connection attempt, the interval doubles after each failure
+     *
+     */
+    void scheduleReconnect();
+
+    /**
+     * @brief Write data if connected, data sent while disconnected is dropped
+     *
+     * @param data
+     */
+    void writeData(const QByteArray& data);
+
+    bool _active = false;
+    QString _hostAddress;
+    quint16 _port = 0;
+    int _receiveBufferSize = defaultReceiveBufferSize;
+    int _sendBufferSize = defaultSendBufferSize;
+    int _reconnectMSecs = minimumReconnectMSecs;
+    int _reconnections = 0;
+    QTimer _reconnectTimer;
+    QTcpSocket* _tcpSocket;
 };
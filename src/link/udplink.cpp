@@ -1,22 +1,41 @@
 #include <QDebug>
+#include <QFile>
 #include <QLoggingCategory>
-#include <QNetworkDatagram>
+#include <QtEndian>
 
+#include "ping-message-ping1d.h"
+#include "pingchecksum.h"
 #include "udplink.h"
 
 Q_LOGGING_CATEGORY(PING_PROTOCOL_UDPLINK, "ping.protocol.udplink")
 
+namespace {
+// Payload offset of ping_number in ping1d_distance and ping1d_profile
+const int pingNumberOffset = 8;
+// Larger steps back are sensor restarts, not reordered datagrams
+const quint32 maximumReorderDistance = 1000;
+}
+
 UDPLink::UDPLink(QObject* parent)
     : AbstractLink(parent)
-    , _udpSocket(new QUdpSocket(parent))
+    , _udpSocket(new QUdpSocket(this))
 {
     setType(LinkType::Udp);
 
-    connect(_udpSocket, &QIODevice::readyRead, this, [this]() {
-        emit newData(_udpSocket->readAll());
+    connect(_udpSocket, &QAbstractSocket::connected, this, [this] {
+        qCDebug(PING_PROTOCOL_UDPLINK) << "Connected to" << _hostAddress << _port;
+        if(_receiveBufferSize) {
+            _udpSocket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, _receiveBufferSize);
+        }
     });
 
+    connect(_udpSocket, &QIODevice::readyRead, this, &UDPLink::readDatagrams);
+
     connect(this, &AbstractLink::sendData, this, [this](const QByteArray& data) {
+        if(_udpSocket->state() != QAbstractSocket::ConnectedState) {
+            qCDebug(PING_PROTOCOL_UDPLINK) << "Not connected, dropping" << data.size() << "bytes.";
+            return;
+        }
         _udpSocket->write(data);
     });
 }
@@ -33,32 +52,114 @@ bool UDPLink::setConfiguration(const LinkConfiguration& linkConfiguration)
     setName(linkConfiguration.name());
 
     _hostAddress = linkConfiguration.args()->at(0);
-    _port = linkConfiguration.args()->at(1).toInt();
+    _port = linkConfiguration.args()->at(1).toUShort();
+    return true;
+}
 
-    // Check protocol detector comments and documentation about correct connect procedure
+bool UDPLink::startConnection()
+{
+    if(_hostAddress.isEmpty() || !_port) {
+        qCWarning(PING_PROTOCOL_UDPLINK) << "Invalid host or port:" << _hostAddress << _port;
+        return false;
+    }
 
-    // Connect with server
+    // Check protocol detector comments and documentation about correct connect procedure
+    // Addresses connect immediately, host names are resolved without blocking
+    _datagrams = 0;
+    _reorders = 0;
+    _hasPingNumber = false;
     _udpSocket->connectToHost(_hostAddress, _port);
+    return isOpen();
+}
+
+void UDPLink::readDatagrams()
+{
+    // Drain the socket, the parser receives all datagrams of this wakeup at once
+    QByteArray batch;
+    while(_udpSocket->hasPendingDatagrams()) {
+        const qint64 size = _udpSocket->pendingDatagramSize();
+        if(size < 0) {
+            break;
+        }
 
-    // Give the socket a second to connect to the other side otherwise error out
-    int socketAttemps = 0;
-    while(!_udpSocket->waitForConnected(100) && socketAttemps < 10 ) {
-        // Increases socketAttemps here to avoid empty loop optimization
-        socketAttemps++;
+        const int offset = batch.size();
+        batch.resize(offset + size);
+        const qint64 length = _udpSocket->readDatagram(batch.data() + offset, size);
+        if(length < 0) {
+            batch.resize(offset);
+            break;
+        }
+        batch.resize(offset + length);
+
+        _datagrams++;
+        checkOrder(batch.constData() + offset, length);
     }
-    if(_udpSocket->state() != QUdpSocket::ConnectedState) {
-        qCWarning(PING_PROTOCOL_UDPLINK) << "Socket is not in connected state.";
-        QString errorMessage = QStringLiteral("Error (%1): %2.").arg(_udpSocket->state()).arg(_udpSocket->errorString());
-        qCWarning(PING_PROTOCOL_UDPLINK) << errorMessage;
-        return false;
+
+    if(!batch.isEmpty()) {
+        emit newData(batch);
     }
+}
 
-    return true;
+void UDPLink::checkOrder(const char* datagram, qint64 size)
+{
+    // Ping1D distance and profile messages have a ping number in the start of the payload
+    if(size < PingChecksum::headerLength + pingNumberOffset + 4 || datagram[0] != 'B' || datagram[1] != 'R') {
+        return;
+    }
+
+    const uchar* data = reinterpret_cast<const uchar*>(datagram);
+    const quint16 messageId = qFromLittleEndian<quint16>(data + 4);
+    if(messageId != Ping1dId::DISTANCE && messageId != Ping1dId::PROFILE) {
+        return;
+    }
+
+    const quint32 pingNumber = qFromLittleEndian<quint32>(data + PingChecksum::headerLength + pingNumberOffset);
+    if(_hasPingNumber && pingNumber < _lastPingNumber && _lastPingNumber - pingNumber < maximumReorderDistance) {
+        _reorders++;
+        return;
+    }
+    _hasPingNumber = true;
+    _lastPingNumber = pingNumber;
+}
+
+qint64 UDPLink::kernelDrops() const
+{
+#ifdef Q_OS_LINUX
+    if(_udpSocket->state() == QAbstractSocket::UnconnectedState) {
+        return -1;
+    }
+
+    // sl local_address rem_address st tx_queue:rx_queue tr:tm->when retrnsmt uid timeout inode ref pointer drops
+    const QString localPort = QStringLiteral(":%1").arg(_udpSocket->localPort(), 4, 16, QLatin1Char('0')).toUpper();
+    for(const auto& fileName : {QStringLiteral("/proc/net/udp"), QStringLiteral("/proc/net/udp6")}) {
+        QFile file(fileName);
+        if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            continue;
+        }
+        file.readLine();
+        while(!file.atEnd()) {
+            const QList<QByteArray> fields = file.readLine().simplified().split(' ');
+            if(fields.size() > 12 && fields[1].endsWith(localPort.toLatin1())) {
+                return fields.last().toLongLong();
+            }
+        }
+    }
+#endif
+    return -1;
+}
+
+QVariantMap UDPLink::statistics()
+{
+    return {
+        {"datagrams", _datagrams},
+        {"kernelDrops", kernelDrops()},
+        {"reorders", _reorders},
+    };
 }
 
 bool UDPLink::finishConnection()
 {
-    _udpSocket->close();
+    _udpSocket->abort();
     return true;
 }
 
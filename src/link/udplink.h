@@ -6,6 +6,8 @@
 
 /**
  * @brief UDP connection class
+ *  All pending datagrams are read in each wakeup and delivered in a single newData,
+ *  the kernel receive buffer is enlarged to absorb bursts while the interface is busy.
  *
  */
 class UDPLink : public AbstractLink
@@ -24,6 +26,13 @@ public:
      */
     ~UDPLink();
 
+    /**
+     * @brief Return the number of received datagrams
+     *
+     * @return quint64
+     */
+    quint64 datagrams() const { return _datagrams; };
+
     /**
      * @brief Return a human friendly error message
      *
@@ -40,12 +49,27 @@ public:
     bool finishConnection() final;
 
     /**
-     * @brief Check if UDP connection is open
+     * @brief Check if UDP connection is open or connecting
      *
      * @return true
      * @return false
      */
-    bool isOpen() final { return _udpSocket->isWritable() && _udpSocket->isReadable(); };
+    bool isOpen() final { return _udpSocket->state() != QAbstractSocket::UnconnectedState; };
+
+    /**
+     * @brief Return the number of datagrams dropped by the kernel for this socket
+     *  Only available in Linux, reads /proc/net/udp.
+     *
+     * @return qint64 -1 if not available
+     */
+    qint64 kernelDrops() const;
+
+    /**
+     * @brief Return the number of Ping1D messages received with a ping number before the previous one
+     *
+     * @return quint64
+     */
+    quint64 reorders() const { return _reorders; };
 
     /**
      * @brief Set the configuration object
@@ -57,12 +81,26 @@ public:
     bool setConfiguration(const LinkConfiguration& linkConfiguration) final;
 
     /**
-     * @brief Start connection
+     * @brief Set the kernel receive buffer size, applied in the next connection
+     *
+     * @param size in bytes, 0 for the system default
+     */
+    void setReceiveBufferSize(int size) { _receiveBufferSize = qMax(0, size); };
+
+    /**
+     * @brief Start connection, host names are resolved in background
      *
      * @return true
      * @return false
      */
-    bool startConnection() final { return _udpSocket->open(QIODevice::ReadWrite); };
+    bool startConnection() final;
+
+    /**
+     * @brief Return link statistics: datagrams, kernel drops and reorders
+     *
+     * @return QVariantMap
+     */
+    QVariantMap statistics() final;
 
     /**
      * @brief Return QUdpSocket pointer
@@ -71,8 +109,31 @@ public:
      */
     QUdpSocket* udpSocket() { return _udpSocket; };
 
+    // Linux limits it to net.core.rmem_max
+    static const int defaultReceiveBufferSize = 4 * 1024 * 1024;
+
 private:
+    /**
+     * @brief Check the ping number of Ping1D messages for reordered datagrams
+     *
+     * @param datagram
+     * @param size
+     */
+    void checkOrder(const char* datagram, qint64 size);
+
+    /**
+     * @brief Read all pending datagrams
+     *
+     */
+    void readDatagrams();
+
     QString _hostAddress;
     QUdpSocket* _udpSocket;
-    uint _port;
+    quint16 _port = 0;
+    int _receiveBufferSize = defaultReceiveBufferSize;
+
+    quint64 _datagrams = 0;
+    quint64 _reorders = 0;
+    bool _hasPingNumber = false;
+    quint32 _lastPingNumber = 0;
 };
@@ -11,15 +11,20 @@
 #endif
 
 #include "abstractlink.h"
+#include "batchprocessor.h"
 #include "devicemanager.h"
 #include "filemanager.h"
 #include "flasher.h"
 #include "linkconfiguration.h"
 #include "logger.h"
+#include "logrenderer.h"
 #include "notificationmanager.h"
+#include "overviewplot.h"
 #include "ping.h"
 #include "ping360.h"
 #include "polarplot.h"
+#include "profiledata.h"
+#include "sensorlogwriter.h"
 #include "settingsmanager.h"
 #include "stylemanager.h"
 #include "util.h"
@@ -38,12 +43,38 @@ int main(int argc, char *argv[])
     QCoreApplication::setOrganizationDomain("bluerobotics.com");
     QCoreApplication::setApplicationName("Ping Viewer");
 
+    // Commands that run without loading the GUI
+    const QString command = argc > 1 ? QString(argv[1]) : QString();
+
+    // Convert sensor logs to the last format
+    // E.g: pingviewer --convert-log old_log.bin new_log.bin
+    if(argc == 4 && command == QStringLiteral("--convert-log")) {
+        QCoreApplication app(argc, argv);
+        return SensorLogWriter::convert(argv[2], argv[3]) ? 0 : 1;
+    }
+
+    // Process sensor logs in parallel and export depth time series
+    // E.g: pingviewer --batch --output results Sensor_Log/
+    if(command == QStringLiteral("--batch")) {
+        QCoreApplication app(argc, argv);
+        return BatchProcessor::run(app.arguments());
+    }
+
+    // Render sensor logs to tiled images with full resolution
+    // E.g: pingviewer --render --pixels-per-meter 200 --output render log.bin
+    if(command == QStringLiteral("--render")) {
+        QCoreApplication app(argc, argv);
+        return LogRenderer::run(app.arguments());
+    }
+
     QQuickStyle::setStyle("Material");
 
     // Singleton register
     qRegisterMetaType<AbstractLinkNamespace::LinkType>();
     qRegisterMetaType<PingEnumNamespace::PingDeviceType>();
     qRegisterMetaType<PingEnumNamespace::PingMessageId>();
+    qRegisterMetaType<LogOverview*>();
+    qRegisterMetaType<ProfileData*>();
 
     qmlRegisterSingletonType<DeviceManager>("DeviceManager", 1, 0, "DeviceManager",
                                             DeviceManager::qmlSingletonRegister);
@@ -60,9 +91,12 @@ int main(int argc, char *argv[])
     qmlRegisterType<AbstractLink>("AbstractLink", 1, 0, "AbstractLink");
     qmlRegisterType<Flasher>("Flasher", 1, 0, "Flasher");
     qmlRegisterType<LinkConfiguration>("LinkConfiguration", 1, 0, "LinkConfiguration");
+    qmlRegisterUncreatableType<LogOverview>("LogOverview", 1, 0, "LogOverview", "Overviews are provided by links.");
+    qmlRegisterType<OverviewPlot>("OverviewPlot", 1, 0, "OverviewPlot");
     qmlRegisterType<Ping>("Ping", 1, 0, "Ping");
     qmlRegisterType<Ping360>("Ping360", 1, 0, "Ping360");
     qmlRegisterType<PolarPlot>("PolarPlot", 1, 0, "PolarPlot");
+    qmlRegisterUncreatableType<ProfileData>("ProfileData", 1, 0, "ProfileData", "Profiles are provided by sensors.");
     qmlRegisterType<WaterfallPlot>("WaterfallPlot", 1, 0, "WaterfallPlot");
 
     qmlRegisterUncreatableMetaObject(
@@ -26,7 +26,7 @@ bool HexValidator::check(const QByteArray& bytes)
     };
 
     // Check if start with :
-    if(bytes[0] != ':') {
+    if(bytes.isEmpty() || bytes[0] != ':') {
         return error("No valid start key.");
     }
 
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <QDebug>
+
+#include "ping-message.h"
+
+/**
+ * @brief Statistics of a single message id
+ *
+ */
+struct MessageStatistics {
+    // Number of received messages
+    int received = 0;
+    // Requested and acknowledge
+    int ack = 0;
+    // Requested and not acknowledge
+    int nack = 0;
+    // Number of waiting replies
+    int waiting = 0;
+    // Message frequency in Hz
+    float frequency = 0;
+    int lastElapsedTime = 0;
+    // LPF IIR alpha coefficient
+    static constexpr float alpha = 0.8f;
+
+    /**
+     * @brief Update frequency with the time of the last received message
+     *
+     * @param timeMs elapsed time in milliseconds, zero will reset the frequency calculation
+     */
+    void setElapsed(int timeMs)
+    {
+        if(lastElapsedTime == 0 || timeMs == 0 || timeMs == lastElapsedTime) {
+            lastElapsedTime = timeMs;
+            return;
+        }
+        float elapsedMs = (timeMs - lastElapsedTime)*0.001;
+        frequency = (1.0f - alpha)/elapsedMs + alpha*frequency;
+        lastElapsedTime = timeMs;
+    }
+};
+
+/**
+ * @brief Print message statistics
+ *
+ * @param d
+ * @param other
+ * @return QDebug
+ */
+inline QDebug operator<<(QDebug d, const MessageStatistics& other)
+{
+    return d << "received:" << other.received << ", waiting: " << other.waiting << ", ack: " << other.ack
+           << ", nack: " << other.nack << ", frequency:" << other.frequency;
+}
+
+/**
+ * @brief Compile time dispatch table of ping protocol messages
+ *  Each message id in Ids has a slot, the slot of an id is found with a single lookup in a constexpr array
+ *  indexed by the message id. Handlers and statistics are flat arrays indexed by slot.
+ *
+ *  E.g:
+ *      using Dispatch = MessageDispatchTable<Ping360, Ping360Id::DEVICE_DATA, CommonId::NACK>;
+ *      static constexpr Dispatch dispatch{{&Ping360::handleDeviceData, &Ping360::handleNack}};
+ *      Dispatch::Statistics statistics;
+ *      dispatch.call(this, msg, statistics);
+ *
+ * @tparam Owner class that owns the handlers
+ * @tparam Ids handled message ids, the handlers follow the same order
+ */
+template<typename Owner, uint16_t... Ids>
+class MessageDispatchTable
+{
+public:
+    using Handler = void (Owner::*)(const ping_message&);
+
+    // Number of handled messages
+    static constexpr int size = sizeof...(Ids);
+    // Slot used by messages without handler
+    static constexpr int unhandledSlot = size;
+
+    static_assert(size > 0 && size < 255, "Dispatch table should have between 1 and 254 messages.");
+
+    /**
+     * @brief Statistics of all handled messages and a last slot for unhandled messages
+     *
+     */
+    using Statistics = std::array<MessageStatistics, size + 1>;
+
+    /**
+     * @brief Construct a new Message Dispatch Table object
+     *
+     * @param handlers handlers in the same order of Ids
+     */
+    constexpr MessageDispatchTable(const std::array<Handler, size>& handlers)
+        : _handlers(handlers)
+    {
+    }
+
+    /**
+     * @brief Return the slot of a message id
+     *
+     * @param id
+     * @return constexpr int unhandledSlot if id is not in the table
+     */
+    static constexpr int slot(uint16_t id)
+    {
+        return id <= _maxId && _slots[id] != _invalidSlot ? _slots[id] : unhandledSlot;
+    }
+
+    /**
+     * @brief Return the slot of a message id known at compile time
+     *
+     * @tparam Id
+     * @return constexpr int
+     */
+    template<uint16_t Id>
+    static constexpr int slotOf()
+    {
+        static_assert(Id <= _maxId && _slots[Id] != _invalidSlot, "Message id is not in the dispatch table.");
+        return _slots[Id];
+    }
+
+    /**
+     * @brief Update statistics of the message and call its handler
+     *
+     * @param owner
+     * @param msg
+     * @param statistics
+     * @return true the message has a handler
+     * @return false
+     */
+    bool call(Owner* owner, const ping_message& msg, Statistics& statistics) const
+    {
+        const int index = slot(msg.message_id());
+        MessageStatistics& messageStatistics = statistics[index];
+        messageStatistics.received++;
+        if(messageStatistics.waiting) {
+            messageStatistics.waiting--;
+            messageStatistics.ack++;
+        }
+
+        if(index == unhandledSlot) {
+            return false;
+        }
+        (owner->*_handlers[index])(msg);
+        return true;
+    }
+
+private:
+    static constexpr uint16_t _maxId = std::max({Ids...});
+    static constexpr uint8_t _invalidSlot = 0xff;
+
+    /**
+     * @brief Build the id to slot array
+     *
+     * @return constexpr std::array<uint8_t, _maxId + 1>
+     */
+    static constexpr std::array<uint8_t, _maxId + 1> buildSlots()
+    {
+        std::array<uint8_t, _maxId + 1> table{};
+        for(auto& item : table) {
+            item = _invalidSlot;
+        }
+        const uint16_t ids[] = {Ids...};
+        for(int i = 0; i < size; i++) {
+            table[ids[i]] = i;
+        }
+        return table;
+    }
+
+    static constexpr std::array<uint8_t, _maxId + 1> _slots = buildSlots();
+    std::array<Handler, size> _handlers;
+};
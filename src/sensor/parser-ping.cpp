@@ -1,19 +1,54 @@
 #include "parser-ping.h"
+#include "pingchecksum.h"
 
 void PingParserExt::clearBuffer()
 {
     _parser.reset();
+    _idle = true;
+}
+
+int PingParserExt::parseFrame(const uint8_t* data, int length)
+{
+    if(length < PingChecksum::headerLength + PingChecksum::checksumLength || data[0] != 'B' || data[1] != 'R') {
+        return 0;
+    }
+
+    const int payloadLength = data[2] | (data[3] << 8);
+    const int messageLength = PingChecksum::headerLength + payloadLength + PingChecksum::checksumLength;
+    if(messageLength > length || messageLength > _maxMessageLength
+            || !PingChecksum::validate(data, messageLength)) {
+        return 0;
+    }
+
+    _rxMessage = ping_message(data, messageLength);
+    return messageLength;
 }
 
 void PingParserExt::parseBuffer(const QByteArray& data)
 {
-    for(int i = 0; i < data.length(); i++) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.constData());
+    for(int i = 0; i < data.length();) {
+        // Whole messages inside the buffer are validated in bulk
+        if(_idle) {
+            const int messageLength = parseFrame(bytes + i, data.length() - i);
+            if(messageLength) {
+                i += messageLength;
+                parsed++;
+                emit newMessage(_rxMessage);
+                continue;
+            }
+        }
+
         PingParser::ParseState state = _parser.parseByte(data.at(i));
+        i++;
+        _idle = state == PingParser::ParseState::WAIT_START;
         if (state == PingParser::ParseState::NEW_MESSAGE) {
+            _idle = true;
             parsed++;
             _rxMessage = _parser.rxMessage;
             emit newMessage(_rxMessage);
         } else if (state == PingParser::ParseState::ERROR) {
+            _idle = true;
             errors++;
             emit parseError();
         }
@@ -23,6 +58,8 @@ void PingParserExt::parseBuffer(const QByteArray& data)
 Parser::ParserState PingParserExt::parseByte(const char byte)
 {
     PingParser::ParseState state = _parser.parseByte(byte);
+    _idle = state == PingParser::ParseState::WAIT_START || state == PingParser::ParseState::NEW_MESSAGE
+            || state == PingParser::ParseState::ERROR;
     if (state == PingParser::ParseState::NEW_MESSAGE) {
         _rxMessage = _parser.rxMessage;
         return Parser::ParserState::NEW_MESSAGE;
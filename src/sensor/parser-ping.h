@@ -13,7 +13,7 @@ public:
     /**
      * @brief Any messages parsed must be shorter than the buffer length
      */
-    PingParserExt() : _parser(10240) {}
+    PingParserExt() : _parser(_maxMessageLength) {}
 
     /**
      * @brief clear parse state
@@ -34,5 +34,18 @@ public:
     ParserState parseByte(const char byte) override final;
 
 private:
+    /**
+     * @brief Parse a complete message from data without the byte by byte state machine
+     *  Used only when the parser is waiting for a new message, the checksum is validated with PingChecksum
+     *
+     * @param data
+     * @param length available bytes
+     * @return int message length, or 0 if data does not start with a complete and valid message
+     */
+    int parseFrame(const uint8_t* data, int length);
+
+    static const int _maxMessageLength = 10240;
+    // The inner parser is waiting for the start of a message
+    bool _idle = true;
     PingParser _parser;
 };
@@ -11,7 +11,6 @@
 #include <QSerialPort>
 #include <QSerialPortInfo>
 #include <QStringList>
-#include <QThread>
 #include <QUrl>
 
 #include "hexvalidator.h"
@@ -24,13 +23,20 @@
 Q_LOGGING_CATEGORY(PING_PROTOCOL_PING, "ping.protocol.ping")
 
 const int Ping::_pingMaxFrequency = 50;
+// Close to a 60Hz display refresh rate
+const int Ping::_frameIntervalMs = 16;
 
 Ping::Ping()
     :PingSensor()
-    ,_points(_num_points, 0)
+    ,_profile(_num_points)
 {
     setControlPanel({"qrc:/Ping1DControlPanel.qml"});
     setSensorVisualizer({"qrc:/Ping1DVisualizer.qml"});
+    setSharedFrameBufferName(QStringLiteral("/ping-viewer-ping1d"));
+
+    _frameTimer.setSingleShot(true);
+    _frameTimer.setInterval(_frameIntervalMs);
+    connect(&_frameTimer, &QTimer::timeout, this, &Ping::flushFrame);
 
     _periodicRequestTimer.setInterval(1000);
     connect(&_periodicRequestTimer, &QTimer::timeout, this, [this] {
@@ -50,9 +56,9 @@ Ping::Ping()
 
         // Update lost messages count
         _lostMessages = 0;
-        for(const auto& requestedId : requestedIds)
+        for(const auto& statistics : _messageStatistics)
         {
-            _lostMessages += requestedId.waiting;
+            _lostMessages += statistics.waiting;
         }
         emit lostMessagesUpdate();
 
@@ -152,165 +158,230 @@ void Ping::handleMessage(const ping_message& msg)
 {
     qCDebug(PING_PROTOCOL_PING) << "Handling Message:" << msg.message_id();
 
-    auto& requestedId = requestedIds[msg.message_id()];
-    if(requestedId.waiting) {
-        requestedId.waiting--;
-        requestedId.ack++;
+    static constexpr Dispatch dispatch{{
+            &Ping::handleDeviceId,
+            &Ping::handleDistance,
+            &Ping::handleDistanceSimple,
+            &Ping::handleProfile,
+            &Ping::handleModeAuto,
+            &Ping::handlePingEnable,
+            &Ping::handlePingInterval,
+            &Ping::handleRange,
+            &Ping::handleGeneralInfo,
+            &Ping::handleGainSetting,
+            &Ping::handleSpeedOfSound,
+            &Ping::handleProcessorTemperature,
+            &Ping::handlePcbTemperature,
+            &Ping::handleVoltage5,
+        }};
+
+    if(!dispatch.call(this, msg, _messageStatistics)) {
+        qWarning(PING_PROTOCOL_PING) << "UNHANDLED MESSAGE ID:" << msg.message_id();
     }
 
-    switch (msg.message_id()) {
+    emit parsedMsgsUpdate();
+}
 
+void Ping::handleDeviceId(const ping_message& msg)
+{
     // This message is deprecated, it provides no added information because
     // the device id is already supplied in every message header
-    case Ping1dId::DEVICE_ID: {
-        ping1d_device_id m(msg);
-        _srcId = m.source_device_id();
+    ping1d_device_id m(msg);
+    _srcId = m.source_device_id();
 
-        emit srcIdUpdate();
-    }
-    break;
-
-    case Ping1dId::DISTANCE: {
-        ping1d_distance m(msg);
-        _distance = m.distance();
-        _confidence = m.confidence();
-        _transmit_duration = m.transmit_duration();
-        _ping_number = m.ping_number();
-        _scan_start = m.scan_start();
-        _scan_length = m.scan_length();
-        _gain_setting = m.gain_setting();
-
-        // TODO: change to distMsgUpdate() or similar
-        emit distanceUpdate();
-        emit pingNumberUpdate();
-        emit confidenceUpdate();
-        emit transmitDurationUpdate();
-        emit scanStartUpdate();
-        emit scanLengthUpdate();
-        emit gainSettingUpdate();
-    }
-    break;
+    emit srcIdUpdate();
+}
 
-    case Ping1dId::DISTANCE_SIMPLE: {
-        ping1d_distance_simple m(msg);
-        _distance = m.distance();
-        _confidence = m.confidence();
+void Ping::handleDistance(const ping_message& msg)
+{
+    ping1d_distance m(msg);
+    _distance = m.distance();
+    _confidence = m.confidence();
+    _transmit_duration = m.transmit_duration();
+    _ping_number = m.ping_number();
+    _scan_start = m.scan_start();
+    _scan_length = m.scan_length();
+    _gain_setting = m.gain_setting();
+
+    markFrameDirty(DistanceProperty | PingNumberProperty | ConfidenceProperty | TransmitDurationProperty
+                   | ScanStartProperty | ScanLengthProperty | GainSettingProperty);
+}
 
-        emit distanceUpdate();
-        emit confidenceUpdate();
-    }
-    break;
-
-    case Ping1dId::PROFILE: {
-        ping1d_profile m(msg);
-        _distance = m.distance();
-        _confidence = m.confidence();
-        _transmit_duration = m.transmit_duration();
-        _ping_number = m.ping_number();
-        _scan_start = m.scan_start();
-        _scan_length = m.scan_length();
-        _gain_setting = m.gain_setting();
-//        _num_points = m.profile_data_length(); // const for now
-//        memcpy(_points.data(), m.data(), _num_points); // careful with constant
-
-        // This is necessary to convert <uint8_t> to <int>
-        // QProperty only supports vector<int>, otherwise, we could use memcpy, like the two lines above
-        for (int i = 0; i < m.profile_data_length(); i++) {
-            _points.replace(i, m.profile_data()[i] / 255.0);
-        }
+void Ping::handleDistanceSimple(const ping_message& msg)
+{
+    ping1d_distance_simple m(msg);
+    _distance = m.distance();
+    _confidence = m.confidence();
 
-        // TODO: change to distMsgUpdate() or similar
-        emit distanceUpdate();
-        emit pingNumberUpdate();
-        emit confidenceUpdate();
-        emit transmitDurationUpdate();
-        emit scanStartUpdate();
-        emit scanLengthUpdate();
-        emit gainSettingUpdate();
-        emit pointsUpdate();
-    }
-    break;
+    markFrameDirty(DistanceProperty | ConfidenceProperty);
+}
 
-    case Ping1dId::MODE_AUTO: {
-        ping1d_mode_auto m(msg);
-        if(_mode_auto != static_cast<bool>(m.mode_auto())) {
-            _mode_auto = m.mode_auto();
-            emit modeAutoUpdate();
-        }
-    }
-    break;
+void Ping::handleProfile(const ping_message& msg)
+{
+    ping1d_profile m(msg);
+    _distance = m.distance();
+    _confidence = m.confidence();
+    _transmit_duration = m.transmit_duration();
+    _ping_number = m.ping_number();
+    _scan_start = m.scan_start();
+    _scan_length = m.scan_length();
+    _gain_setting = m.gain_setting();
+    _profile.setSamples(m.profile_data(), m.profile_data_length());
+
+    if(_sharedFrameBuffer.isOpen()) {
+        PingShm::FrameHeader frame{};
+        frame.sensorType = PingShm::Ping1D;
+        frame.gainSetting = _gain_setting;
+        frame.pingNumber = _ping_number;
+        frame.distance = _distance;
+        frame.confidence = _confidence;
+        frame.scanStart = _scan_start;
+        frame.scanLength = _scan_length;
+        frame.transmitDuration = _transmit_duration;
+        _sharedFrameBuffer.publish(frame, m.profile_data(), m.profile_data_length());
+    }
+
+    // Each profile is a waterfall column, it's delivered now even when profiles arrive faster than the frame rate
+    // (e.g. fast log replay or seek pre-roll), the property signals are still coalesced in the frame
+    emit profileReceived(_confidence, _scan_start, _scan_length, _distance);
+
+    markFrameDirty(DistanceProperty | PingNumberProperty | ConfidenceProperty | TransmitDurationProperty
+                   | ScanStartProperty | ScanLengthProperty | GainSettingProperty | PointsProperty);
+}
 
-    case  Ping1dId::PING_ENABLE: {
-        ping1d_ping_enable m(msg);
-        _ping_enable = m.ping_enabled();
-        emit pingEnableUpdate();
+void Ping::handleModeAuto(const ping_message& msg)
+{
+    ping1d_mode_auto m(msg);
+    if(_mode_auto != static_cast<bool>(m.mode_auto())) {
+        _mode_auto = m.mode_auto();
+        markFrameDirty(ModeAutoProperty);
     }
-    break;
+}
 
-    case Ping1dId::PING_INTERVAL: {
-        ping1d_ping_interval m(msg);
-        _ping_interval = m.ping_interval();
-        emit pingIntervalUpdate();
-    }
-    break;
-
-    case Ping1dId::RANGE: {
-        ping1d_range m(msg);
-        _scan_start = m.scan_start();
-        _scan_length = m.scan_length();
-        emit scanLengthUpdate();
-        emit scanStartUpdate();
-    }
-    break;
+void Ping::handlePingEnable(const ping_message& msg)
+{
+    ping1d_ping_enable m(msg);
+    _ping_enable = m.ping_enabled();
+    markFrameDirty(PingEnableProperty);
+}
 
-    case Ping1dId::GENERAL_INFO: {
-        ping1d_general_info m(msg);
-        _gain_setting = m.gain_setting();
-        emit gainSettingUpdate();
-    }
-    break;
+void Ping::handlePingInterval(const ping_message& msg)
+{
+    ping1d_ping_interval m(msg);
+    _ping_interval = m.ping_interval();
+    markFrameDirty(PingIntervalProperty);
+}
 
-    case Ping1dId::GAIN_SETTING: {
-        ping1d_gain_setting m(msg);
-        _gain_setting = m.gain_setting();
-        emit gainSettingUpdate();
-    }
-    break;
+void Ping::handleRange(const ping_message& msg)
+{
+    ping1d_range m(msg);
+    _scan_start = m.scan_start();
+    _scan_length = m.scan_length();
+    markFrameDirty(ScanStartProperty | ScanLengthProperty);
+}
 
-    case Ping1dId::SPEED_OF_SOUND: {
-        ping1d_speed_of_sound m(msg);
-        _speed_of_sound = m.speed_of_sound();
-        emit speedOfSoundUpdate();
-    }
-    break;
+void Ping::handleGeneralInfo(const ping_message& msg)
+{
+    ping1d_general_info m(msg);
+    _gain_setting = m.gain_setting();
+    markFrameDirty(GainSettingProperty);
+}
 
-    case Ping1dId::PROCESSOR_TEMPERATURE: {
-        ping1d_processor_temperature m(msg);
-        _processor_temperature = m.processor_temperature();
-        emit processorTemperatureUpdate();
-        break;
-    }
+void Ping::handleGainSetting(const ping_message& msg)
+{
+    ping1d_gain_setting m(msg);
+    _gain_setting = m.gain_setting();
+    markFrameDirty(GainSettingProperty);
+}
 
-    case Ping1dId::PCB_TEMPERATURE: {
-        ping1d_pcb_temperature m(msg);
-        _pcb_temperature = m.pcb_temperature();
-        emit pcbTemperatureUpdate();
-        break;
-    }
+void Ping::handleSpeedOfSound(const ping_message& msg)
+{
+    ping1d_speed_of_sound m(msg);
+    _speed_of_sound = m.speed_of_sound();
+    markFrameDirty(SpeedOfSoundProperty);
+}
+
+void Ping::handleProcessorTemperature(const ping_message& msg)
+{
+    ping1d_processor_temperature m(msg);
+    _processor_temperature = m.processor_temperature();
+    markFrameDirty(ProcessorTemperatureProperty);
+}
+
+void Ping::handlePcbTemperature(const ping_message& msg)
+{
+    ping1d_pcb_temperature m(msg);
+    _pcb_temperature = m.pcb_temperature();
+    markFrameDirty(PcbTemperatureProperty);
+}
 
-    case Ping1dId::VOLTAGE_5: {
-        ping1d_voltage_5 m(msg);
-        _board_voltage = m.voltage_5(); // millivolts
-        emit boardVoltageUpdate();
-        break;
+void Ping::handleVoltage5(const ping_message& msg)
+{
+    ping1d_voltage_5 m(msg);
+    _board_voltage = m.voltage_5(); // millivolts
+    markFrameDirty(BoardVoltageProperty);
+}
+
+void Ping::markFrameDirty(uint32_t properties)
+{
+    _dirtyFrameProperties |= properties;
+    if(!_frameTimer.isActive()) {
+        _frameTimer.start();
     }
+}
 
-    default:
-        qWarning(PING_PROTOCOL_PING) << "UNHANDLED MESSAGE ID:" << msg.message_id();
-        break;
+void Ping::flushFrame()
+{
+    static const QVector<QPair<uint32_t, void(Ping::*)()>> frameSignals {
+        {DistanceProperty, &Ping::distanceUpdate},
+        {PingNumberProperty, &Ping::pingNumberUpdate},
+        {ConfidenceProperty, &Ping::confidenceUpdate},
+        {TransmitDurationProperty, &Ping::transmitDurationUpdate},
+        {ScanStartProperty, &Ping::scanStartUpdate},
+        {ScanLengthProperty, &Ping::scanLengthUpdate},
+        {GainSettingProperty, &Ping::gainSettingUpdate},
+        {PointsProperty, &Ping::pointsUpdate},
+        {ModeAutoProperty, &Ping::modeAutoUpdate},
+        {PingEnableProperty, &Ping::pingEnableUpdate},
+        {PingIntervalProperty, &Ping::pingIntervalUpdate},
+        {SpeedOfSoundProperty, &Ping::speedOfSoundUpdate},
+        {BoardVoltageProperty, &Ping::boardVoltageUpdate},
+        {PcbTemperatureProperty, &Ping::pcbTemperatureUpdate},
+        {ProcessorTemperatureProperty, &Ping::processorTemperatureUpdate},
+    };
+
+    if(!_dirtyFrameProperties) {
+        return;
     }
 
-    emit parsedMsgsUpdate();
+    // Clear the flags before emitting, handlers may trigger new changes for the next frame
+    const uint32_t dirtyProperties = _dirtyFrameProperties;
+    _dirtyFrameProperties = 0;
+
+    _frame = {
+        {"distance", _distance},
+        {"ping_number", _ping_number},
+        {"confidence", _confidence},
+        {"transmit_duration", _transmit_duration},
+        {"start_mm", _scan_start},
+        {"length_mm", _scan_length},
+        {"gain_setting", _gain_setting},
+        {"mode_auto", _mode_auto},
+        {"pingEnable", _ping_enable},
+        {"ping_interval", _ping_interval},
+        {"speed_of_sound", _speed_of_sound},
+        {"board_voltage", _board_voltage},
+        {"pcb_temperature", _pcb_temperature},
+        {"processor_temperature", _processor_temperature},
+        {"pointsUpdated", static_cast<bool>(dirtyProperties & PointsProperty)},
+    };
+
+    for(const auto& frameSignal : frameSignals) {
+        if(dirtyProperties & frameSignal.first) {
+            emit (this->*frameSignal.second)();
+        }
+    }
+    emit frameUpdate();
 }
 
 void Ping::firmwareUpdate(QString fileUrl, bool sendPingGotoBootloader, int baud, bool verify)
@@ -362,43 +433,36 @@ void Ping::flash(const QString& fileUrl, bool sendPingGotoBootloader, int baud,
         writeMessage(m);
     }
 
-    // Wait for bytes to be written before finishing the connection
-    while (serialLink->port()->bytesToWrite()) {
-        qCDebug(PING_PROTOCOL_PING) << "Waiting for bytes to be written...";
-        // We are not changing the connection structure, only waiting for bytes to be written
-        const_cast<QSerialPort*>(serialLink->port())->waitForBytesWritten();
-        qCDebug(PING_PROTOCOL_PING) << "Done !";
-    }
-
-    qCDebug(PING_PROTOCOL_PING) << "Finish connection.";
-    // TODO: Move thread delay to something more.. correct.
-    QThread::msleep(1000);
-    link()->finishConnection();
+    // The bootloader message is written by the event loop, wait for it and for the sensor to reboot
+    // before closing the connection, without blocking the interface
+    static const int bootloaderMSecs = 1000;
+    QTimer::singleShot(bootloaderMSecs, this, [this, fileUrl, baud, verify] {
+        qCDebug(PING_PROTOCOL_PING) << "Finish connection.";
+        link()->finishConnection();
 
-    QSerialPortInfo pInfo(serialLink->port()->portName());
-    QString portLocation = pInfo.systemLocation();
+        qCDebug(PING_PROTOCOL_PING) << "Save sensor configuration.";
+        updatePingConfigurationSettings();
 
-    qCDebug(PING_PROTOCOL_PING) << "Save sensor configuration.";
-    updatePingConfigurationSettings();
-
-    qCDebug(PING_PROTOCOL_PING) << "Start flash.";
-    QThread::msleep(1000);
-
-    flasher()->setBaudRate(baud);
-    flasher()->setFirmwarePath(fileUrl);
-    flasher()->setLink(link()->configuration()[0]);
-    flasher()->setVerify(verify);
-    flasher()->flash();
+        QTimer::singleShot(bootloaderMSecs, this, [this, fileUrl, baud, verify] {
+            qCDebug(PING_PROTOCOL_PING) << "Start flash.";
+            flasher()->setBaudRate(baud);
+            flasher()->setFirmwarePath(fileUrl);
+            flasher()->setLink(link()->configuration()[0]);
+            flasher()->setVerify(verify);
+            flasher()->flash();
+        });
+    });
 
-    QThread::msleep(500);
     // Clear last configuration src ID to detect device as a new one
     connect(&_flasher, &Flasher::stateChanged, this, [this] {
         if(flasher()->state() == Flasher::States::FlashFinished)
         {
-            QThread::msleep(500);
-            // Clear last configuration src ID to detect device as a new one
-            resetSensorLocalVariables();
-            Sensor::connectLink(*link()->configuration());
+            // Wait for the new firmware to boot
+            QTimer::singleShot(500, this, [this] {
+                // Clear last configuration src ID to detect device as a new one
+                resetSensorLocalVariables();
+                Sensor::connectLink(*link()->configuration());
+            });
         }
 
     });
@@ -490,7 +554,7 @@ void Ping::printSensorInformation() const
     qCDebug(PING_PROTOCOL_PING) << "\t- gain_setting:" << _gain_setting;
     qCDebug(PING_PROTOCOL_PING) << "\t- mode_auto:" << _mode_auto;
     qCDebug(PING_PROTOCOL_PING) << "\t- ping_interval:" << _ping_interval;
-    qCDebug(PING_PROTOCOL_PING) << "\t- points:" << QByteArray((const char*)_points.data(), _num_points).toHex(',');
+    qCDebug(PING_PROTOCOL_PING) << "\t- points:" << QByteArray(reinterpret_cast<const char*>(_profile.constData()), _profile.size()).toHex(',');
 }
 
 void Ping::checkNewFirmwareInGitHubPayload(const QJsonDocument& jsonDocument)
@@ -560,8 +624,3 @@ Ping::~Ping()
 {
     updatePingConfigurationSettings();
 }
-
-QDebug operator<<(QDebug d, const Ping::messageStatus& other)
-{
-    return d << "waiting: " << other.waiting << ", ack: " << other.ack << ", nack: " << other.nack;
-}
@@ -9,8 +9,9 @@
 #include <ping-message.h>
 #include <ping-message-common.h>
 #include <ping-message-ping1d.h>
-#include "protocoldetector.h"
 #include "pingsensor.h"
+#include "profiledata.h"
+#include "protocoldetector.h"
 
 /**
  * @brief Define ping sensor
@@ -163,12 +164,14 @@ public:
     Q_PROPERTY(int gain_setting READ gain_setting WRITE set_gain_setting NOTIFY gainSettingUpdate)
 
     /**
-     * @brief Return last array of points
+     * @brief Return last profile received from the sensor
+     *  The pointer is constant during the sensor lifetime, profileReceived is emitted for each new profile
+     *  and pointsUpdate once per display frame
      *
-     * @return QVector<double>
+     * @return ProfileData*
      */
-    QVector<double> points() { return _points; }
-    Q_PROPERTY(QVector<double> points READ points NOTIFY pointsUpdate)
+    ProfileData* profile() { return &_profile; }
+    Q_PROPERTY(ProfileData* profile READ profile CONSTANT)
 
     /**
      * @brief Get auto mode status
@@ -334,6 +337,15 @@ public:
      */
     Q_INVOKABLE void emitPing() const { request(Ping1dId::PROFILE); }
 
+    /**
+     * @brief Return a snapshot of the sensor properties in the last display frame
+     *  All property changes from the messages received inside a single frame are delivered together
+     *
+     * @return QVariantMap
+     */
+    QVariantMap frame() const { return _frame; }
+    Q_PROPERTY(QVariantMap frame READ frame NOTIFY frameUpdate)
+
 signals:
     /**
      * @brief emitted when property changes
@@ -358,6 +370,22 @@ signals:
     void processorTemperatureUpdate();
 ///@}
 
+    /**
+     * @brief Emitted once per display frame with all property changes since the last one
+     */
+    void frameUpdate();
+
+    /**
+     * @brief Emitted for each received profile, profile() has its samples
+     *  Profiles can arrive faster than the display frames, plots queue each one (check FrameQueue)
+     *
+     * @param confidence
+     * @param start_mm
+     * @param length_mm
+     * @param distance in mm
+     */
+    void profileReceived(int confidence, int start_mm, int length_mm, int distance);
+
 private:
     Q_DISABLE_COPY(Ping)
     /**
@@ -381,10 +409,7 @@ private:
 
     static const uint16_t _num_points = 200;
 
-    // TODO: maybe use vector or uint8_t[] here
-    // QVector is only required if points need to be exposed to qml
-    //QVector<int> _points;
-    QVector<double> _points;
+    ProfileData _profile;
 
     bool _mode_auto = 0;
     uint16_t _ping_interval = 0;
@@ -392,6 +417,26 @@ private:
 
     void handleMessage(const ping_message& msg) final; // handle incoming message
 
+    /**
+     * @brief Ping1D message handlers, called by handleMessage
+     *
+     * @param msg
+     */
+    void handleDeviceId(const ping_message& msg);
+    void handleDistance(const ping_message& msg);
+    void handleDistanceSimple(const ping_message& msg);
+    void handleProfile(const ping_message& msg);
+    void handleModeAuto(const ping_message& msg);
+    void handlePingEnable(const ping_message& msg);
+    void handlePingInterval(const ping_message& msg);
+    void handleRange(const ping_message& msg);
+    void handleGeneralInfo(const ping_message& msg);
+    void handleGainSetting(const ping_message& msg);
+    void handleSpeedOfSound(const ping_message& msg);
+    void handleProcessorTemperature(const ping_message& msg);
+    void handlePcbTemperature(const ping_message& msg);
+    void handleVoltage5(const ping_message& msg);
+
     void loadLastPingConfigurationSettings();
     void updatePingConfigurationSettings();
     void setLastPingConfiguration();
@@ -440,6 +485,47 @@ private:
     // For automatic periodic updates (board voltage and temperature)
     QTimer _periodicRequestTimer;
 
+    /**
+     * @brief Properties that are coalesced in a single frame update
+     */
+    enum FrameProperty : uint32_t {
+        DistanceProperty = 1 << 0,
+        PingNumberProperty = 1 << 1,
+        ConfidenceProperty = 1 << 2,
+        TransmitDurationProperty = 1 << 3,
+        ScanStartProperty = 1 << 4,
+        ScanLengthProperty = 1 << 5,
+        GainSettingProperty = 1 << 6,
+        PointsProperty = 1 << 7,
+        ModeAutoProperty = 1 << 8,
+        PingEnableProperty = 1 << 9,
+        PingIntervalProperty = 1 << 10,
+        SpeedOfSoundProperty = 1 << 11,
+        BoardVoltageProperty = 1 << 12,
+        PcbTemperatureProperty = 1 << 13,
+        ProcessorTemperatureProperty = 1 << 14,
+    };
+
+    /**
+     * @brief Mark properties as changed, they will be notified in the next frame
+     *
+     * @param properties FrameProperty flags
+     */
+    void markFrameDirty(uint32_t properties);
+
+    /**
+     * @brief Update frame snapshot and notify all properties that changed since the last frame
+     *
+     */
+    void flushFrame();
+
+    // Properties that changed since the last frame
+    uint32_t _dirtyFrameProperties = 0;
+    QVariantMap _frame;
+    // Single shot timer used to coalesce property changes inside a display frame
+    QTimer _frameTimer;
+    static const int _frameIntervalMs;
+
     QSharedPointer<QProcess> _firmwareProcess;
 
     struct settingsConfiguration {
@@ -511,14 +597,22 @@ private:
         },
     };
 
-    struct messageStatus {
-        // Requested and acknowledge
-        int ack = 0;
-        // Requested and not acknowledge
-        int nack = 0;
-        // Number of waiting replies
-        int waiting = 0;
-    };
-    friend QDebug operator<<(QDebug d, const Ping::messageStatus& other);
-    QHash<uint16_t, messageStatus> requestedIds;
+    using Dispatch = MessageDispatchTable<Ping,
+          Ping1dId::DEVICE_ID,
+          Ping1dId::DISTANCE,
+          Ping1dId::DISTANCE_SIMPLE,
+          Ping1dId::PROFILE,
+          Ping1dId::MODE_AUTO,
+          Ping1dId::PING_ENABLE,
+          Ping1dId::PING_INTERVAL,
+          Ping1dId::RANGE,
+          Ping1dId::GENERAL_INFO,
+          Ping1dId::GAIN_SETTING,
+          Ping1dId::SPEED_OF_SOUND,
+          Ping1dId::PROCESSOR_TEMPERATURE,
+          Ping1dId::PCB_TEMPERATURE,
+          Ping1dId::VOLTAGE_5
+          >;
+    // Requested, acknowledged and received messages, indexed by Dispatch slot
+    Dispatch::Statistics _messageStatistics;
 };
@@ -12,7 +12,6 @@
 #include <QSerialPort>
 #include <QSerialPortInfo>
 #include <QStringList>
-#include <QThread>
 #include <QUrl>
 
 #include "hexvalidator.h"
@@ -43,12 +42,11 @@ const uint16_t Ping360::_viewerDefaultNumberOfSamples = _firmwareMaxNumberOfPoin
 
 Ping360::Ping360()
     :PingSensor()
+    ,_profile(_maxNumberOfPoints)
 {
-    // QVector crashs when constructed in initialization list
-    _data = QVector<double>(_maxNumberOfPoints, 0);
-
     setControlPanel({"qrc:/Ping360ControlPanel.qml"});
     setSensorVisualizer({"qrc:/Ping360Visualizer.qml"});
+    setSharedFrameBufferName(QStringLiteral("/ping-viewer-ping360"));
 
     connect(this, &Sensor::connectionOpen, this, &Ping360::startPreConfigurationProcess);
 
@@ -146,96 +144,109 @@ void Ping360::handleMessage(const ping_message& msg)
 {
     qCDebug(PING_PROTOCOL_PING360) << "Handling Message:" << msg.message_id();
 
+    static constexpr Dispatch dispatch{{
+            &Ping360::handleDeviceInformation,
+            &Ping360::handleDeviceData,
+            &Ping360::handleNack,
+        }};
+
     // Update frequency for each
-    messageFrequencies[msg.message_id()].setElapsed(_messageElapsedTimer.elapsed());
+    _messageStatistics[Dispatch::slot(msg.message_id())].setElapsed(_messageElapsedTimer.elapsed());
     // Since we don't have a huge number of messages and this variable is pretty simple,
     // we can use a single signal to update someone about the frequency update
     emit messageFrequencyChanged();
 
-    switch (msg.message_id()) {
+    if(!dispatch.call(this, msg, _messageStatistics)) {
+        qWarning(PING_PROTOCOL_PING360) << "UNHANDLED MESSAGE ID:" << msg.message_id();
+    }
+    emit parsedMsgsUpdate();
+}
 
-    case CommonId::DEVICE_INFORMATION: {
-        if(_configuring) {
-            _baudrateConfigurationTimer.start();
-            checkBaudrateProcess();
-            return;
-        } else {
-            _baudrateConfigurationTimer.stop();
-            _timeoutProfileMessage.start();
-            requestNextProfile();
-            return;
-        }
+void Ping360::handleDeviceInformation(const ping_message& msg)
+{
+    Q_UNUSED(msg)
+    if(_configuring) {
+        _baudrateConfigurationTimer.start();
+        checkBaudrateProcess();
+    } else {
+        _baudrateConfigurationTimer.stop();
+        _timeoutProfileMessage.start();
+        requestNextProfile();
+    }
+}
+
+void Ping360::handleDeviceData(const ping_message& msg)
+{
+    // Parse message
+    const ping360_device_data deviceData(msg);
+
+    _angle = deviceData.angle();
+
+    _profile.setSamples(deviceData.data(), deviceData.data_length());
+
+    if(_sharedFrameBuffer.isOpen()) {
+        PingShm::FrameHeader frame{};
+        frame.sensorType = PingShm::Ping360;
+        frame.gainSetting = deviceData.gain_setting();
+        frame.pingNumber = _ping_number;
+        frame.angle = deviceData.angle();
+        frame.samplePeriod = deviceData.sample_period();
+        frame.transmitFrequency = deviceData.transmit_frequency();
+        frame.transmitDuration = deviceData.transmit_duration();
+        _sharedFrameBuffer.publish(frame, deviceData.data(), deviceData.data_length());
     }
 
-    case Ping360Id::DEVICE_DATA: {
-        // Parse message
-        const ping360_device_data deviceData(msg);
+    // TODO: doublecheck what we are getting and what we want
+    // some parameter combinations are not valid and the sensor will automatically adjust
+    // in order to detect this, we will have to track our last commanded values separately
+    // from our presently commanded values
+    emit angleChanged();
 
-        _angle = deviceData.angle();
+    // Only emit data changed when inside sector range
+    if(_profile.size()) {
+        // Update total number of pings
+        _ping_number++;
 
-        _data.resize(deviceData.data_length());
-        for (int i = 0; i < deviceData.data_length(); i++) {
-            _data.replace(i, deviceData.data()[i] / 255.0);
+        if (_sectorSize == 400
+                || (angle() >= _angularResolutionGrad - _sectorSize/2) || (angle() <= _sectorSize/2)) {
+            emit dataChanged();
         }
+    }
 
-        // TODO: doublecheck what we are getting and what we want
-        // some parameter combinations are not valid and the sensor will automatically adjust
-        // in order to detect this, we will have to track our last commanded values separately
-        // from our presently commanded values
-        emit angleChanged();
+    // request another transmission
+    requestNextProfile();
 
-        // Only emit data changed when inside sector range
-        if(_data.size()) {
-            // Update total number of pings
-            _ping_number++;
+    // Restart timer
+    _timeoutProfileMessage.start();
+}
 
-            if (_sectorSize == 400
-                    || (angle() >= _angularResolutionGrad - _sectorSize/2) || (angle() <= _sectorSize/2)) {
-                emit dataChanged();
-            }
-        }
+void Ping360::handleNack(const ping_message& msg)
+{
+    const common_nack nack(msg);
+    if (nack.nacked_id() != Ping360Id::TRANSDUCER) {
+        return;
+    }
 
-        // request another transmission
-        requestNextProfile();
+    qCWarning(PING_PROTOCOL_PING360) << "transducer control was NACKED, reverting to default settings";
 
-        // Restart timer
-        _timeoutProfileMessage.start();
+    _gain_setting = _firmwareDefaultGainSetting;
+    _transmit_duration = _firmwareDefaultTransmitDuration;
+    _sample_period = _firmwareDefaultSamplePeriod;
+    _transmit_frequency = _viewerDefaultTransmitFrequency;
+    _num_points = _viewerDefaultNumberOfSamples;
 
-        break;
-    }
+    // request another transmission
+    requestNextProfile();
 
-    case CommonId::NACK: {
-        const common_nack nack(msg);
-        if (nack.nacked_id() == Ping360Id::TRANSDUCER) {
-            qCWarning(PING_PROTOCOL_PING360) << "transducer control was NACKED, reverting to default settings";
-
-            _gain_setting = _firmwareDefaultGainSetting;
-            _transmit_duration = _firmwareDefaultTransmitDuration;
-            _sample_period = _firmwareDefaultSamplePeriod;
-            _transmit_frequency = _viewerDefaultTransmitFrequency;
-            _num_points = _viewerDefaultNumberOfSamples;
-
-            // request another transmission
-            requestNextProfile();
-
-            // restart timer
-            _timeoutProfileMessage.start();
-
-            emit gainSettingChanged();
-            emit transmitDurationChanged();
-            emit samplePeriodChanged();
-            emit transmitFrequencyChanged();
-            emit numberOfPointsChanged();
-            emit rangeChanged();
-        }
-        break;
-    }
+    // restart timer
+    _timeoutProfileMessage.start();
 
-    default:
-        qWarning(PING_PROTOCOL_PING360) << "UNHANDLED MESSAGE ID:" << msg.message_id();
-        break;
-    }
-    emit parsedMsgsUpdate();
+    emit gainSettingChanged();
+    emit transmitDurationChanged();
+    emit samplePeriodChanged();
+    emit transmitFrequencyChanged();
+    emit numberOfPointsChanged();
+    emit rangeChanged();
 }
 
 void Ping360::firmwareUpdate(QString fileUrl, bool sendPingGotoBootloader, int baud, bool verify)
@@ -318,7 +329,7 @@ void Ping360::setBaudRate(int baudRate)
 void Ping360::setBaudRateAndRequestProfile(int baudRate)
 {
     setBaudRate(baudRate);
-    QThread::usleep(100);
+    // The serial link writes the request after the automatic baud rate sequence
     requestNextProfile();
 }
 
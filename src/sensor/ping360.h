@@ -13,8 +13,9 @@
 #include "parser-ping.h"
 #include "ping-message-common.h"
 #include "ping-message-ping360.h"
-#include "protocoldetector.h"
 #include "pingsensor.h"
+#include "profiledata.h"
+#include "protocoldetector.h"
 
 /**
  * @brief Define Ping360 sensor
@@ -199,12 +200,13 @@ public:
     Q_PROPERTY(int gain_setting READ gain_setting WRITE set_gain_setting NOTIFY gainSettingChanged)
 
     /**
-     * @brief Return last array of points
+     * @brief Return last profile received from the sensor
+     *  The pointer is constant during the sensor lifetime, dataChanged is emitted when samples change
      *
-     * @return QVector<double>
+     * @return ProfileData*
      */
-    QVector<double> data() { return _data; }
-    Q_PROPERTY(QVector<double> data READ data NOTIFY dataChanged)
+    ProfileData* profile() { return &_profile; }
+    Q_PROPERTY(ProfileData* profile READ profile CONSTANT)
 
     /**
      * @brief Get the speed of sound (mm/s) used for calculating the distance from time-of-flight
@@ -347,7 +349,7 @@ public:
      */
     float profileFrequency()
     {
-        return messageFrequencies[Ping360Id::DEVICE_DATA].frequency;
+        return _messageStatistics[Dispatch::slotOf<Ping360Id::DEVICE_DATA>()].frequency;
     }
 
     Q_PROPERTY(float profileFrequency READ profileFrequency NOTIFY messageFrequencyChanged)
@@ -525,7 +527,7 @@ private:
     uint16_t _num_points = _viewerDefaultNumberOfSamples;
     uint16_t _sample_period = _firmwareDefaultSamplePeriod;
     uint16_t _transmit_frequency = _viewerDefaultTransmitFrequency;
-    QVector<double> _data;
+    ProfileData _profile;
 ///@}
 
     // Number of messages to check for best baud rate
@@ -552,7 +554,7 @@ private:
     float _motorSpeedGradMs = 4000/_angularResolutionGrad;
     // Right now the max value is 1200 for ping360
     // We are saving 2k of the memory for future proof modifications
-    int _maxNumberOfPoints = 2048;
+    static const int _maxNumberOfPoints = 2048;
     // The sensor can take 4s to answer, we are also using an extra 200ms for latency
     int _sensorTimeout = 4200;
 
@@ -570,30 +572,25 @@ private:
      */
     QTimer _baudrateConfigurationTimer;
 
-    // Helper structure to hold frequency information for each message
-    struct MessageFrequencyHelper {
-        float frequency = 0;
-        int lastElapsedTime = 0;
-        // LPF IIR alpha coefficient
-        float alpha = 0.8f;
-        void setElapsed(int timeMs)
-        {
-            // If timeMs is zero, reset structure.
-            // Otherwise start it
-            if(lastElapsedTime == 0 || timeMs == 0) {
-                lastElapsedTime = timeMs;
-                return;
-            }
-            float elapsedMs = (timeMs - lastElapsedTime)*0.001;
-            frequency = (1.0f - alpha)/elapsedMs + alpha*frequency;
-            lastElapsedTime = timeMs;
-        }
-    };
-
-    QHash<uint16_t, MessageFrequencyHelper> messageFrequencies;
+    using Dispatch = MessageDispatchTable<Ping360,
+          CommonId::DEVICE_INFORMATION,
+          Ping360Id::DEVICE_DATA,
+          CommonId::NACK
+          >;
+    // Frequency information for each message, indexed by Dispatch slot
+    Dispatch::Statistics _messageStatistics;
 
     void handleMessage(const ping_message& msg) final; // handle incoming message
 
+    /**
+     * @brief Ping360 message handlers, called by handleMessage
+     *
+     * @param msg
+     */
+    void handleDeviceInformation(const ping_message& msg);
+    void handleDeviceData(const ping_message& msg);
+    void handleNack(const ping_message& msg);
+
     void loadLastSensorConfigurationSettings();
     void updateSensorConfigurationSettings();
     void setLastSensorConfiguration();
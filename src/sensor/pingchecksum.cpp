@@ -0,0 +1,76 @@
+#include <ping-message.h>
+
+#include "pingchecksum.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PING_CHECKSUM_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PING_CHECKSUM_NEON
+#endif
+
+uint16_t PingChecksum::calculateScalar(const uint8_t* data, int length)
+{
+    uint16_t checksum = 0;
+    for(int i = 0; i < length; i++) {
+        checksum += data[i];
+    }
+    return checksum;
+}
+
+uint16_t PingChecksum::calculate(const uint8_t* data, int length)
+{
+    uint32_t checksum = 0;
+    int i = 0;
+
+#if defined(PING_CHECKSUM_SSE2)
+    // Sum of absolute differences against zero adds each 8 bytes in a 64 bits lane
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = _mm_setzero_si128();
+    for(; i + 16 <= length; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(bytes, zero));
+    }
+    checksum = _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+#elif defined(PING_CHECKSUM_NEON)
+    // Pairwise widening add, 16 x u8 -> 8 x u16 -> 4 x u32
+    uint32x4_t sum = vdupq_n_u32(0);
+    for(; i + 16 <= length; i += 16) {
+        sum = vpadalq_u16(sum, vpaddlq_u8(vld1q_u8(data + i)));
+    }
+    checksum = vgetq_lane_u32(sum, 0) + vgetq_lane_u32(sum, 1) + vgetq_lane_u32(sum, 2) + vgetq_lane_u32(sum, 3);
+#endif
+
+    return static_cast<uint16_t>(checksum + calculateScalar(data + i, length - i));
+}
+
+bool PingChecksum::validate(const uint8_t* frame, int length)
+{
+    if(length < headerLength + checksumLength) {
+        return false;
+    }
+
+    const int checksumIndex = length - checksumLength;
+    const uint16_t checksum = frame[checksumIndex] | (frame[checksumIndex + 1] << 8);
+    return calculate(frame, checksumIndex) == checksum;
+}
+
+void PingChecksum::update(ping_message& message)
+{
+    const int checksumIndex = message.msgDataLength() - checksumLength;
+    const uint16_t checksum = calculate(message.msgData, checksumIndex);
+    message.msgData[checksumIndex] = checksum & 0xff;
+    message.msgData[checksumIndex + 1] = checksum >> 8;
+}
+
+const char* PingChecksum::implementation()
+{
+#if defined(PING_CHECKSUM_SSE2)
+    return "sse2";
+#elif defined(PING_CHECKSUM_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
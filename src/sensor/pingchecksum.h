@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+class ping_message;
+
+/**
+ * @brief Ping protocol checksum computation
+ *  The checksum is the sum of all header and payload bytes, truncated to 16 bits.
+ *  Large messages (E.g: Ping360 device data with 1200 samples) are summed 16 bytes at a time
+ *  with SSE2 or NEON, other architectures use the scalar version.
+ *
+ */
+class PingChecksum
+{
+public:
+    PingChecksum() = delete;
+    ~PingChecksum() = delete;
+
+    /**
+     * @brief Calculate the checksum of data
+     *
+     * @param data
+     * @param length
+     * @return uint16_t
+     */
+    static uint16_t calculate(const uint8_t* data, int length);
+
+    /**
+     * @brief Scalar version of calculate, used as reference and for small buffers
+     *
+     * @param data
+     * @param length
+     * @return uint16_t
+     */
+    static uint16_t calculateScalar(const uint8_t* data, int length);
+
+    /**
+     * @brief Check if a complete frame (header, payload and checksum) is valid
+     *
+     * @param frame
+     * @param length frame length, with checksum
+     * @return true
+     * @return false
+     */
+    static bool validate(const uint8_t* frame, int length);
+
+    /**
+     * @brief Update message checksum, it should be used instead of ping_message::updateChecksum
+     *
+     * @param message
+     */
+    static void update(ping_message& message);
+
+    /**
+     * @brief Return the name of the implementation in use, E.g: sse2
+     *
+     * @return const char*
+     */
+    static const char* implementation();
+
+    // Header (start bytes, payload length, message id, src and dst id) and checksum size
+    static const int headerLength = 8;
+    static const int checksumLength = 2;
+};
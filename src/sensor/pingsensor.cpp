@@ -2,6 +2,7 @@
 #include "pingsensor.h"
 #include "ping-message-common.h"
 #include "ping-message-ping1d.h"
+#include "settingsmanager.h"
 
 PING_LOGGING_CATEGORY(PING_PROTOCOL_PINGSENSOR, "ping.protocol.pingsensor")
 
@@ -12,6 +13,26 @@ PingSensor::PingSensor()
     _parser = new PingParserExt();
     connect(dynamic_cast<PingParserExt*>(_parser), &PingParserExt::newMessage, this, &PingSensor::handleMessagePrivate);
     connect(dynamic_cast<PingParserExt*>(_parser), &PingParserExt::parseError, this, &PingSensor::parserErrorsUpdate);
+    connect(SettingsManager::self(), &SettingsManager::sharedMemoryOutputChanged, this,
+            &PingSensor::updateSharedFrameBuffer);
+}
+
+void PingSensor::setSharedFrameBufferName(const QString& name)
+{
+    _sharedFrameBufferName = name;
+    updateSharedFrameBuffer();
+}
+
+void PingSensor::updateSharedFrameBuffer()
+{
+    if(!SettingsManager::self()->sharedMemoryOutput() || _sharedFrameBufferName.isEmpty()) {
+        _sharedFrameBuffer.close();
+        return;
+    }
+
+    if(_sharedFrameBuffer.name() != _sharedFrameBufferName) {
+        _sharedFrameBuffer.open(_sharedFrameBufferName);
+    }
 }
 
 
@@ -51,83 +72,86 @@ void PingSensor::handleMessagePrivate(const ping_message& msg)
         emit srcIdUpdate();
     }
 
-    switch (msg.message_id()) {
+    static constexpr CommonDispatch dispatch{{
+            &PingSensor::handleAck,
+            &PingSensor::handleNack,
+            &PingSensor::handleAsciiText,
+            &PingSensor::handleDeviceInformation,
+            &PingSensor::handleProtocolVersion,
+            &PingSensor::handleFirmwareVersion,
+        }};
+    // Not a common message if there is no handler
+    dispatch.call(this, msg, _commonStatistics);
 
-    case CommonId::ACK: {
-        common_ack ackMessage{msg};
-        qCDebug(PING_PROTOCOL_PINGSENSOR) << "ACK message:" << ackMessage.acked_id();
-        break;
-    }
+    handleMessage(msg);
+}
 
-    case CommonId::NACK: {
-        common_nack nackMessage{msg};
-        qCCritical(PING_PROTOCOL_PINGSENSOR) << "Sensor NACK!";
-        _nack_msg = QString("%1: %2").arg(nackMessage.nack_message()).arg(nackMessage.nacked_id());
-        qCDebug(PING_PROTOCOL_PINGSENSOR) << "NACK message:" << _nack_msg;
-        emit nackMsgUpdate();
-        break;
-    }
+void PingSensor::handleAck(const ping_message& msg)
+{
+    common_ack ackMessage{msg};
+    qCDebug(PING_PROTOCOL_PINGSENSOR) << "ACK message:" << ackMessage.acked_id();
+}
 
+void PingSensor::handleNack(const ping_message& msg)
+{
+    common_nack nackMessage{msg};
+    qCCritical(PING_PROTOCOL_PINGSENSOR) << "Sensor NACK!";
+    _nack_msg = QString("%1: %2").arg(nackMessage.nack_message()).arg(nackMessage.nacked_id());
+    qCDebug(PING_PROTOCOL_PINGSENSOR) << "NACK message:" << _nack_msg;
+    emit nackMsgUpdate();
+}
+
+void PingSensor::handleAsciiText(const ping_message& msg)
+{
     // needs dynamic-payload patch
-    case CommonId::ASCII_TEXT: {
-        _ascii_text = common_ascii_text(msg).ascii_message();
-        qCInfo(PING_PROTOCOL_PINGSENSOR) << "Sensor status:" << _ascii_text;
-        emit asciiTextUpdate();
-        break;
-    }
+    _ascii_text = common_ascii_text(msg).ascii_message();
+    qCInfo(PING_PROTOCOL_PINGSENSOR) << "Sensor status:" << _ascii_text;
+    emit asciiTextUpdate();
+}
 
-    case CommonId::DEVICE_INFORMATION: {
-        common_device_information m(msg);
-
-        _device_type = m.device_type();
-        _device_revision = m.device_revision();
-        _firmware_version_major = m.firmware_version_major();
-        _firmware_version_minor = m.firmware_version_minor();
-        _firmware_version_patch = m.firmware_version_patch();
-
-        emit deviceTypeUpdate();
-        emit deviceRevisionUpdate();
-        emit firmwareVersionMajorUpdate();
-        emit firmwareVersionMinorUpdate();
-        emit firmwareVersionPatchUpdate();
-        break;
-    }
+void PingSensor::handleDeviceInformation(const ping_message& msg)
+{
+    common_device_information m(msg);
+
+    _device_type = m.device_type();
+    _device_revision = m.device_revision();
+    _firmware_version_major = m.firmware_version_major();
+    _firmware_version_minor = m.firmware_version_minor();
+    _firmware_version_patch = m.firmware_version_patch();
+
+    emit deviceTypeUpdate();
+    emit deviceRevisionUpdate();
+    emit firmwareVersionMajorUpdate();
+    emit firmwareVersionMinorUpdate();
+    emit firmwareVersionPatchUpdate();
+}
 
-    case CommonId::PROTOCOL_VERSION: {
-        common_protocol_version m(msg);
+void PingSensor::handleProtocolVersion(const ping_message& msg)
+{
+    common_protocol_version m(msg);
 
-        _protocol_version_major = m.version_major();
-        _protocol_version_minor = m.version_minor();
-        _protocol_version_patch = m.version_patch();
+    _protocol_version_major = m.version_major();
+    _protocol_version_minor = m.version_minor();
+    _protocol_version_patch = m.version_patch();
 
-        emit protocolVersionMajorUpdate();
-        emit protocolVersionMinorUpdate();
-        emit protocolVersionPatchUpdate();
-        break;
-    }
+    emit protocolVersionMajorUpdate();
+    emit protocolVersionMinorUpdate();
+    emit protocolVersionPatchUpdate();
+}
 
+void PingSensor::handleFirmwareVersion(const ping_message& msg)
+{
     //Will be deprecated in future firmware versions of Ping1D
-    case Ping1dId::FIRMWARE_VERSION: {
-        ping1d_firmware_version m(msg);
-
-        m.device_type();
-        // Ping1D uses device_model as device_type to specify which sersion is it
-        _device_type = m.device_model();
-        _firmware_version_major = m.firmware_version_major();
-        _firmware_version_minor = m.firmware_version_minor();
-
-        emit deviceTypeUpdate();
-        emit firmwareVersionMajorUpdate();
-        emit firmwareVersionMinorUpdate();
-        break;
-    }
+    ping1d_firmware_version m(msg);
 
-    default:
-        // Not a common message
-        break;
-    }
+    // Ping1D uses device_model as device_type to specify which sersion is it
+    _device_type = m.device_model();
+    _firmware_version_major = m.firmware_version_major();
+    _firmware_version_minor = m.firmware_version_minor();
 
-    handleMessage(msg);
+    emit deviceTypeUpdate();
+    emit firmwareVersionMajorUpdate();
+    emit firmwareVersionMinorUpdate();
 }
 
 void PingSensor::printStatus() const
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "messagedispatchtable.h"
+#include "ping-message-common.h"
+#include "ping-message-ping1d.h"
 #include "sensor.h"
+#include "sharedframebuffer.h"
 
 /**
  * @brief Abstract ping sensors
@@ -197,6 +201,20 @@ protected:
      */
     void writeMessage(const ping_message& msg) const;
 
+    /**
+     * @brief Set the shared memory name used to publish frames
+     *  The shared memory exists while SettingsManager::sharedMemoryOutput is enabled
+     *
+     * @param name
+     */
+    void setSharedFrameBufferName(const QString& name);
+
+    /**
+     * @brief Open or close the shared memory following the settings
+     *
+     */
+    void updateSharedFrameBuffer();
+
     QString _ascii_text;
     uint8_t _device_revision{0};
     uint8_t _device_type{0};
@@ -209,8 +227,32 @@ protected:
     uint8_t _protocol_version_major{0};
     uint8_t _protocol_version_minor{0};
     uint8_t _protocol_version_patch{0};
+    SharedFrameBuffer _sharedFrameBuffer;
+    QString _sharedFrameBufferName;
     uint8_t _srcId{0};
 
 private:
     Q_DISABLE_COPY(PingSensor)
+
+    /**
+     * @brief Common message handlers, called by handleMessagePrivate
+     *
+     * @param msg
+     */
+    void handleAck(const ping_message& msg);
+    void handleNack(const ping_message& msg);
+    void handleAsciiText(const ping_message& msg);
+    void handleDeviceInformation(const ping_message& msg);
+    void handleProtocolVersion(const ping_message& msg);
+    void handleFirmwareVersion(const ping_message& msg);
+
+    using CommonDispatch = MessageDispatchTable<PingSensor,
+          CommonId::ACK,
+          CommonId::NACK,
+          CommonId::ASCII_TEXT,
+          CommonId::DEVICE_INFORMATION,
+          CommonId::PROTOCOL_VERSION,
+          Ping1dId::FIRMWARE_VERSION
+          >;
+    CommonDispatch::Statistics _commonStatistics;
 };
@@ -0,0 +1,286 @@
+#pragma once
+
+/**
+ * Shared memory ring buffer of decoded sensor frames
+ *  This header has no Qt dependency, it's used by PingViewer to publish frames (SharedFrameBuffer)
+ *  and by external processes to read them (PingShm::Reader), check tools/pingshm/example.cpp.
+ *
+ *  Layout: Header followed by slotCount slots of slotSize bytes, each slot is a FrameHeader followed by samples.
+ *  Frame n is written in slot n % slotCount with a seqlock:
+ *   the writer makes the slot sequence odd, writes the frame, makes it even and then publishes writeIndex = n + 1.
+ *   A reader reads the sequence, the frame and the sequence again, the frame is valid if both are equal and even,
+ *   and if the frame number is the one requested, otherwise the writer lapped the reader.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PING_SHM_POSIX
+#endif
+
+namespace PingShm {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+    "Shared memory atomics must be lock free");
+
+// "PSHM"
+constexpr uint32_t magic = 0x4d485350;
+constexpr uint32_t version = 1;
+
+enum SensorType : uint16_t {
+    Ping1D = 1,
+    Ping360 = 2,
+};
+
+/**
+ * @brief Shared memory header, in the start of the memory
+ *
+ */
+struct alignas(64) Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    // Size of each slot, FrameHeader included
+    uint32_t slotSize;
+    // Number of frames published
+    std::atomic<uint64_t> writeIndex;
+};
+
+/**
+ * @brief Decoded frame header, followed by sampleCount uint8_t samples
+ *  Ping1D uses distance, confidence, scanStart and scanLength in mm,
+ *  Ping360 uses angle in gradians [0, 400), samplePeriod in 25 ns ticks, transmitFrequency in kHz.
+ *
+ */
+struct alignas(8) FrameHeader {
+    // Seqlock sequence, odd while the slot is written
+    std::atomic<uint32_t> sequence;
+    uint16_t sensorType;
+    uint16_t gainSetting;
+    uint64_t frameNumber;
+    // Nanoseconds since epoch
+    int64_t timestampNs;
+    uint32_t pingNumber;
+    uint32_t distance;
+    uint32_t confidence;
+    uint32_t scanStart;
+    uint32_t scanLength;
+    uint32_t angle;
+    uint32_t samplePeriod;
+    uint32_t transmitFrequency;
+    uint32_t transmitDuration;
+    uint32_t sampleCount;
+};
+
+/**
+ * @brief Return the slot size for frames with up to maximumSamples, slots are aligned
+ *
+ * @param maximumSamples
+ * @return size_t
+ */
+inline size_t slotSize(uint32_t maximumSamples)
+{
+    return (sizeof(FrameHeader) + maximumSamples + alignof(FrameHeader) - 1) / alignof(FrameHeader)
+        * alignof(FrameHeader);
+}
+
+/**
+ * @brief Return the shared memory size for a ring buffer
+ *
+ * @param slotCount
+ * @param maximumSamples
+ * @return size_t
+ */
+inline size_t memorySize(uint32_t slotCount, uint32_t maximumSamples)
+{
+    return sizeof(Header) + slotCount * slotSize(maximumSamples);
+}
+
+/**
+ * @brief Frame copied out of the shared memory
+ *
+ */
+struct Frame {
+    FrameHeader header;
+    std::vector<uint8_t> samples;
+};
+
+/**
+ * @brief Read frames from a shared memory ring buffer
+ *
+ */
+class Reader {
+public:
+    enum Status {
+        // Frame read
+        Ok,
+        // No new frame
+        NoData,
+        // Memory is not open
+        Closed,
+    };
+
+    Reader() = default;
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    ~Reader() { close(); }
+
+    /**
+     * @brief Open a shared memory ring buffer
+     *  Reading starts in the next published frame
+     *
+     * @param name shared memory name, e.g. "/ping-viewer-ping1d"
+     * @return true
+     * @return false
+     */
+    bool open(const std::string& name)
+    {
+        close();
+#ifdef PING_SHM_POSIX
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if(fd < 0) {
+            return false;
+        }
+        struct stat status;
+        if(fstat(fd, &status) < 0 || static_cast<size_t>(status.st_size) < sizeof(Header)) {
+            ::close(fd);
+            return false;
+        }
+        void* memory = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(memory == MAP_FAILED) {
+            return false;
+        }
+
+        _memory = static_cast<const uint8_t*>(memory);
+        _memorySize = status.st_size;
+        const Header* header = this->header();
+        if(header->magic != magic || header->version != version || !header->slotCount
+            || memorySize(header->slotCount, 0) > _memorySize
+            || sizeof(Header) + static_cast<size_t>(header->slotCount) * header->slotSize > _memorySize) {
+            close();
+            return false;
+        }
+        _nextFrame = header->writeIndex.load(std::memory_order_acquire);
+        return true;
+#else
+        (void)name;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Unmap the shared memory
+     *
+     */
+    void close()
+    {
+#ifdef PING_SHM_POSIX
+        if(_memory) {
+            munmap(const_cast<uint8_t*>(_memory), _memorySize);
+        }
+#endif
+        _memory = nullptr;
+        _memorySize = 0;
+    }
+
+    /**
+     * @brief Return true if the shared memory is open
+     *
+     */
+    bool isOpen() const { return _memory != nullptr; }
+
+    /**
+     * @brief Return the number of frames overwritten before being read
+     *  The reader skips to the oldest frame available when the writer laps it
+     *
+     */
+    uint64_t lostFrames() const { return _lostFrames; }
+
+    /**
+     * @brief Copy the next frame
+     *
+     * @param frame
+     * @return Status
+     */
+    Status read(Frame& frame)
+    {
+        return readInPlace([&frame](const FrameHeader& header, const uint8_t* samples) {
+            std::memcpy(static_cast<void*>(&frame.header), &header, sizeof(FrameHeader));
+            frame.samples.assign(samples, samples + header.sampleCount);
+        });
+    }
+
+    /**
+     * @brief Call function with the next frame without copying it
+     *  The writer may change the frame while function runs, the results of function are only valid
+     *  if the status is Ok, function can be called more than once before a frame is read.
+     *
+     * @param function void(const FrameHeader&, const uint8_t* samples)
+     * @return Status
+     */
+    template<typename Function>
+    Status readInPlace(Function&& function)
+    {
+        if(!_memory) {
+            return Closed;
+        }
+
+        const Header* header = this->header();
+        while(true) {
+            const uint64_t writeIndex = header->writeIndex.load(std::memory_order_acquire);
+            if(_nextFrame >= writeIndex) {
+                return NoData;
+            }
+            if(writeIndex - _nextFrame > header->slotCount) {
+                // Oldest frame that may be still in the buffer
+                const uint64_t oldest = writeIndex - header->slotCount;
+                _lostFrames += oldest - _nextFrame;
+                _nextFrame = oldest;
+            }
+
+            const FrameHeader* frame = slot(_nextFrame % header->slotCount);
+            const uint32_t sequence = frame->sequence.load(std::memory_order_acquire);
+            if(!(sequence & 1) && frame->frameNumber == _nextFrame
+                && frame->sampleCount <= header->slotSize - sizeof(FrameHeader)) {
+                function(*frame, reinterpret_cast<const uint8_t*>(frame + 1));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(frame->sequence.load(std::memory_order_relaxed) == sequence) {
+                    _nextFrame++;
+                    return Ok;
+                }
+            }
+
+            // The slot was being written or was already reused, try again with the updated write index
+            if(writeIndex - _nextFrame < header->slotCount) {
+                continue;
+            }
+            _lostFrames++;
+            _nextFrame++;
+        }
+    }
+
+private:
+    const Header* header() const { return reinterpret_cast<const Header*>(_memory); }
+
+    const FrameHeader* slot(uint64_t index) const
+    {
+        return reinterpret_cast<const FrameHeader*>(_memory + sizeof(Header) + index * header()->slotSize);
+    }
+
+    const uint8_t* _memory = nullptr;
+    size_t _memorySize = 0;
+    uint64_t _nextFrame = 0;
+    uint64_t _lostFrames = 0;
+};
+
+} // namespace PingShm
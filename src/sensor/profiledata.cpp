@@ -0,0 +1,21 @@
+#include <cstring>
+
+#include "profiledata.h"
+
+ProfileData::ProfileData(int size, QObject* parent)
+    : QObject(parent)
+    , _samples(size, 0)
+{
+}
+
+void ProfileData::setSamples(const uint8_t* data, int length)
+{
+    // resize and data() will detach if the buffer is shared with a renderer
+    _samples.resize(length);
+    if(length > 0) {
+        memcpy(_samples.data(), data, length);
+    }
+    emit samplesChanged();
+}
+
+ProfileData::~ProfileData() = default;
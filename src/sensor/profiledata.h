@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QObject>
+#include <QVector>
+
+/**
+ * @brief Immutable sensor profile shared between sensors and renderers
+ *  Samples are kept as received from the sensor (uint8_t), the normalization is done only on access.
+ *  The internal buffer is implicitly shared, any copy done by `samples()` is only a reference to the
+ *  same data, and it will remain valid and unchanged after the sensor receives a new profile.
+ *
+ */
+class ProfileData : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Construct a new Profile Data object
+     *
+     * @param size initial number of samples, all zero
+     * @param parent
+     */
+    ProfileData(int size = 0, QObject* parent = nullptr);
+
+    /**
+     * @brief Destroy the Profile Data object
+     *
+     */
+    ~ProfileData();
+
+    /**
+     * @brief Return a pointer to the raw samples
+     *
+     * @return const uint8_t*
+     */
+    const uint8_t* constData() const { return _samples.constData(); }
+
+    /**
+     * @brief Return the samples, this is a reference to the same buffer and not a deep copy
+     *
+     * @return QVector<uint8_t>
+     */
+    QVector<uint8_t> samples() const { return _samples; }
+
+    /**
+     * @brief Return the number of samples
+     *
+     * @return int
+     */
+    int size() const { return _samples.size(); }
+    Q_PROPERTY(int size READ size NOTIFY samplesChanged)
+
+    /**
+     * @brief Return true if there is no samples
+     *
+     * @return bool
+     */
+    bool isEmpty() const { return _samples.isEmpty(); }
+
+    /**
+     * @brief Return the normalized sample value [0, 1]
+     *
+     * @param index
+     * @return double 0 if index is out of range
+     */
+    Q_INVOKABLE double valueAt(int index) const
+    {
+        return index >= 0 && index < _samples.size() ? _samples[index] / 255.0 : 0;
+    }
+
+    /**
+     * @brief Replace profile samples
+     *  If someone still holds the previous buffer, a new one is allocated, otherwise the memory is reused
+     *
+     * @param data
+     * @param length
+     */
+    void setSamples(const uint8_t* data, int length);
+
+signals:
+    void samplesChanged();
+
+private:
+    Q_DISABLE_COPY(ProfileData)
+    QVector<uint8_t> _samples;
+};
+
+Q_DECLARE_METATYPE(ProfileData*)
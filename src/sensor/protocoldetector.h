@@ -124,6 +124,8 @@ private slots:
 
 private:
     Q_DISABLE_COPY(ProtocolDetector)
+    // Used to benchmark and fuzz checkBuffer
+    friend class ParserBenchmark;
     bool _active { false };
     bool _detected { false };
     QVector<LinkConfiguration> _availableLinks;
@@ -27,6 +27,7 @@ Sensor::Sensor()
         _connected = false;
         emit this->connectionUpdate();
     });
+
 }
 
 // TODO: rework this after sublasses and parser rework
@@ -55,8 +56,13 @@ void Sensor::connectLink(const LinkConfiguration conConf, const LinkConfiguratio
 
     emit linkUpdate();
 
-    if (_parser) {
-        connect(link(), &AbstractLink::newData, _parser, &Parser::parseBuffer);
+    _linkTee.setSource(link());
+    // The parser is fast and lives in the link thread, no need to queue
+    if(_parser && _parserSink < 0) {
+        Parser* parser = _parser;
+        _parserSink = _linkTee.addSink(QStringLiteral("parser"), parser, [parser](const QByteArray& data) {
+            parser->parseBuffer(data);
+        }, 0);
     }
 
     emit connectionOpen();
@@ -69,6 +75,8 @@ void Sensor::connectLink(const LinkConfiguration conConf, const LinkConfiguratio
         }
 
         if(linkLog()->isOpen()) {
+            _linkTee.removeSink(_linkLogSink);
+            _linkLogSink = -1;
             linkLog()->finishConnection();
             _linkOut.clear();
         }
@@ -88,6 +96,8 @@ void Sensor::connectLinkLog(const LinkConfiguration& logConf)
             qCCritical(PING_PROTOCOL_SENSOR) << "No connection to log !" << linkLog()->errorString();
             return;
         }
+        _linkTee.removeSink(_linkLogSink);
+        _linkLogSink = -1;
         _linkOut.clear();
     }
 
@@ -104,7 +114,12 @@ void Sensor::connectLinkLog(const LinkConfiguration& logConf)
         return;
     }
 
-    connect(link(), &AbstractLink::newData, linkLog(), &AbstractLink::sendData);
+    // The log receives every buffer in order, a queued sink would lose bytes from the middle of the stream
+    // Writing does not block, the file link queues records in its AsyncLogWriter that reports dropped records
+    AbstractLink* log = linkLog();
+    _linkLogSink = _linkTee.addSink(QStringLiteral("log"), log, [log](const QByteArray& data) {
+        emit log->sendData(data);
+    }, 0);
     emit linkLogUpdate();
 }
 
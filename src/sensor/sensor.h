@@ -6,6 +6,7 @@
 
 #include "flasher.h"
 #include "link.h"
+#include "linktee.h"
 #include "parser.h"
 #include "protocoldetector.h"
 
@@ -37,6 +38,28 @@ public:
     AbstractLink* linkLog() const { return _linkOut.data() ? _linkOut->self() : nullptr; };
     Q_PROPERTY(AbstractLink* linkLog READ linkLog NOTIFY linkLogUpdate)
 
+    /**
+     * @brief Return the tee that delivers the entry link data to parser, log and other consumers
+     *  Relays and recorders should add their own sinks instead of connecting to the link.
+     *
+     * @return LinkTee*
+     */
+    LinkTee* linkTee() { return &_linkTee; };
+
+    /**
+     * @brief Return delivered, dropped and queued buffers of each link consumer
+     *
+     * @return QVariantMap
+     */
+    Q_INVOKABLE QVariantMap linkTeeStatistics() const { return _linkTee.statistics(); };
+
+    /**
+     * @brief Return the parser that decodes the entry link data
+     *
+     * @return Parser*
+     */
+    Parser* parser() const { return _parser; };
+
     /**
      * @brief Return sensor name
      *
@@ -135,7 +158,10 @@ protected:
     Flasher _flasher;
     QSharedPointer<Link> _linkIn;
     QSharedPointer<Link> _linkOut;
+    LinkTee _linkTee;
+    int _linkLogSink = -1;
     Parser* _parser; // communication implementation
+    int _parserSink = -1;
 
     QString _name; // TODO: populate
 
@@ -5,3 +5,8 @@ HEADERS += \
 
 SOURCES += \
     $$PWD/*.cpp
+
+# shm_open lives in librt before glibc 2.34
+unix:!macx {
+    LIBS += -lrt
+}
@@ -0,0 +1,137 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#include "logger.h"
+#include "sharedframebuffer.h"
+
+PING_LOGGING_CATEGORY(SHAREDFRAMEBUFFER, "ping.sharedframebuffer");
+
+bool SharedFrameBuffer::open(const QString& name, int slotCount, int maximumSamples)
+{
+    close();
+#ifdef PING_SHM_POSIX
+    if(slotCount <= 0 || maximumSamples <= 0) {
+        qCWarning(SHAREDFRAMEBUFFER) << "Invalid ring buffer size:" << slotCount << maximumSamples;
+        return false;
+    }
+
+    const QByteArray shmName = name.toLocal8Bit();
+    // Old readers keep the previous memory, new ones get the new layout
+    shm_unlink(shmName.constData());
+    const int fd = shm_open(shmName.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(fd < 0) {
+        qCWarning(SHAREDFRAMEBUFFER) << "Failed to create shared memory" << name << strerror(errno);
+        return false;
+    }
+
+    const size_t size = PingShm::memorySize(slotCount, maximumSamples);
+    void* memory = MAP_FAILED;
+    struct stat status;
+    if(fstat(fd, &status) == 0 && ftruncate(fd, size) == 0) {
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if(memory == MAP_FAILED) {
+        qCWarning(SHAREDFRAMEBUFFER) << "Failed to map shared memory" << name << strerror(errno);
+        shm_unlink(shmName.constData());
+        return false;
+    }
+
+    // ftruncate fills the memory with zeros, all slots start with an even sequence and no frame
+    _header = new(memory) PingShm::Header;
+    _header->slotCount = slotCount;
+    _header->slotSize = PingShm::slotSize(maximumSamples);
+    _header->writeIndex.store(0, std::memory_order_relaxed);
+    _header->version = PingShm::version;
+    // Readers check the magic number, it's written last
+    std::atomic_thread_fence(std::memory_order_release);
+    _header->magic = PingShm::magic;
+
+    _name = name;
+    _size = size;
+    _device = status.st_dev;
+    _inode = status.st_ino;
+    qCDebug(SHAREDFRAMEBUFFER) << "Shared memory" << name << "with" << slotCount << "frames of" << maximumSamples
+                               << "samples";
+    return true;
+#else
+    Q_UNUSED(slotCount)
+    Q_UNUSED(maximumSamples)
+    qCWarning(SHAREDFRAMEBUFFER) << "Shared memory is not available in this platform:" << name;
+    return false;
+#endif
+}
+
+void SharedFrameBuffer::publish(PingShm::FrameHeader& frame, const uint8_t* samples, int sampleCount)
+{
+    if(!_header) {
+        return;
+    }
+
+    const uint64_t frameNumber = _header->writeIndex.load(std::memory_order_relaxed);
+    auto slot = reinterpret_cast<PingShm::FrameHeader*>(
+        reinterpret_cast<uint8_t*>(_header) + sizeof(PingShm::Header) + frameNumber % _header->slotCount * _header->slotSize);
+
+    // Seqlock: odd sequence while the slot is written
+    const uint32_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    frame.frameNumber = frameNumber;
+    frame.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    frame.sampleCount = qBound<int>(0, sampleCount, _header->slotSize - sizeof(PingShm::FrameHeader));
+    // The sequence is not copied, the memory after it is plain data
+    const size_t offset = sizeof(frame.sequence);
+    memcpy(reinterpret_cast<uint8_t*>(slot) + offset, reinterpret_cast<const uint8_t*>(&frame) + offset,
+           sizeof(PingShm::FrameHeader) - offset);
+    memcpy(slot + 1, samples, frame.sampleCount);
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    _header->writeIndex.store(frameNumber + 1, std::memory_order_release);
+}
+
+void SharedFrameBuffer::close()
+{
+#ifdef PING_SHM_POSIX
+    if(_header) {
+        // Checked while mapped, so the inode can't be reused by another memory
+        if(isOwner()) {
+            shm_unlink(_name.toLocal8Bit().constData());
+        } else {
+            qCDebug(SHAREDFRAMEBUFFER) << "Shared memory" << _name << "was replaced, it's not removed";
+        }
+        munmap(_header, _size);
+    }
+#endif
+    _header = nullptr;
+    _size = 0;
+    _device = 0;
+    _inode = 0;
+    _name.clear();
+}
+
+bool SharedFrameBuffer::isOwner() const
+{
+#ifdef PING_SHM_POSIX
+    const int fd = shm_open(_name.toLocal8Bit().constData(), O_RDONLY, 0);
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat status;
+    const bool sameMemory = fstat(fd, &status) == 0 && static_cast<quint64>(status.st_dev) == _device
+                            && static_cast<quint64>(status.st_ino) == _inode;
+    ::close(fd);
+    return sameMemory;
+#else
+    return false;
+#endif
+}
+
+SharedFrameBuffer::~SharedFrameBuffer()
+{
+    close();
+}
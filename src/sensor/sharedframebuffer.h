@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <QString>
+
+#include "pingshm.h"
+
+Q_DECLARE_LOGGING_CATEGORY(SHAREDFRAMEBUFFER)
+
+/**
+ * @brief Publish decoded sensor frames in a POSIX shared memory ring buffer
+ *  The writer never waits for readers, slow readers lose the oldest frames.
+ *  Check pingshm.h for the memory layout and the reader.
+ *
+ */
+class SharedFrameBuffer
+{
+public:
+    /**
+     * @brief Construct a new Shared Frame Buffer object
+     *
+     */
+    SharedFrameBuffer() = default;
+
+    /**
+     * @brief Destroy the Shared Frame Buffer object, the shared memory is removed if it was not replaced
+     *
+     */
+    ~SharedFrameBuffer();
+
+    /**
+     * @brief Create the shared memory, replacing any previous one with the same name
+     *
+     * @param name e.g. "/ping-viewer-ping1d"
+     * @param slotCount number of frames kept
+     * @param maximumSamples larger frames are truncated
+     * @return true
+     * @return false shared memory is not available
+     */
+    bool open(const QString& name, int slotCount = defaultSlotCount, int maximumSamples = defaultMaximumSamples);
+
+    /**
+     * @brief Unmap and remove the shared memory, readers keep their mapping until they close it
+     *  The name is only removed if it still refers to our memory, another buffer may have replaced it with open.
+     *
+     */
+    void close();
+
+    /**
+     * @brief Return true if the shared memory is open
+     *
+     * @return true
+     * @return false
+     */
+    bool isOpen() const { return _header != nullptr; };
+
+    /**
+     * @brief Return shared memory name
+     *
+     * @return QString
+     */
+    QString name() const { return _name; };
+
+    /**
+     * @brief Publish a frame
+     *  sequence, frameNumber, timestampNs and sampleCount of frame are filled by this function
+     *
+     * @param frame
+     * @param samples
+     * @param sampleCount
+     */
+    void publish(PingShm::FrameHeader& frame, const uint8_t* samples, int sampleCount);
+
+    static const int defaultSlotCount = 256;
+    // Ping360 has up to 1200 samples and Ping1D profiles have 200
+    static const int defaultMaximumSamples = 2048;
+
+private:
+    Q_DISABLE_COPY(SharedFrameBuffer)
+
+    /**
+     * @brief Return true if the name still refers to the shared memory created by open
+     *
+     * @return true
+     * @return false
+     */
+    bool isOwner() const;
+
+    // Device and inode of the shared memory, they identify it while the name is reused
+    quint64 _device = 0;
+    quint64 _inode = 0;
+    QString _name;
+    PingShm::Header* _header = nullptr;
+    size_t _size = 0;
+};
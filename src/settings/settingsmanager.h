@@ -110,6 +110,20 @@ private:
     AUTO_PROPERTY(bool, reset, false)
     AUTO_PROPERTY(bool, darkTheme, false)
     AUTO_PROPERTY(bool, enableSensorAdvancedConfiguration, false)
+    // AsyncLogWriter::FlushPolicy and its interval in milliseconds, FlushPeriodically limits the data lost in a crash
+    AUTO_PROPERTY(int, logFlushPolicy, 1)
+    AUTO_PROPERTY(int, logFlushInterval, 1000)
+    AUTO_PROPERTY(bool, logCompression, false)
+    // Serial low latency mode (Linux ASYNC_LOW_LATENCY) and QSerialPort read buffer size, 0 for unlimited
+    AUTO_PROPERTY(bool, serialLowLatency, false)
+    AUTO_PROPERTY(int, serialReadBufferSize, 0)
+    // Local ports that re-serve the sensor stream (LinkRelay), 0 to disable
+    AUTO_PROPERTY(int, relayTcpPort, 0)
+    AUTO_PROPERTY(int, relayUdpPort, 0)
+    // Publish decoded frames in shared memory (SharedFrameBuffer)
+    AUTO_PROPERTY(bool, sharedMemoryOutput, false)
+    // FrameQueue::Policy of the plots, used when profiles arrive faster than they are drawn
+    AUTO_PROPERTY(int, framePolicy, 0)
     //AUTO_PROPERTY_MODEL(QString, adistanceUnits, QStringList, MODEL({"Metric", "Imperial"})) // Example
     AUTO_PROPERTY_JSONMODEL(distanceUnits, QByteArrayLiteral(R"({
             "settings": [
@@ -10,11 +10,14 @@ test {
 
     SOURCES += \
         $$PWD/test.cpp
+} else:benchmark {
+    include($$PWD/benchmark/benchmark.pri)
 } else {
     SOURCES += \
         $$PWD/main.cpp
 }
 
+include($$PWD/batch/batch.pri)
 include($$PWD/devicemanager/devicemanager.pri)
 include($$PWD/filemanager/filemanager.pri)
 include($$PWD/flash/flash.pri)
@@ -8,19 +8,36 @@
 #include <QQuickStyle>
 #include <QDebug>
 #include <QRegularExpression>
+#include <QTcpServer>
+#include <QUdpSocket>
 
 #include "abstractlink.h"
+#include "asynclogwriter.h"
 #include "filemanager.h"
+#include "framequeue.h"
 #include "linkconfiguration.h"
+#include "linkrelay.h"
+#include "linktee.h"
 #include "logger.h"
+#include "parser-ping.h"
 #include "ping.h"
+#include "ping1dsimulationlink.h"
+#include "ping360simulationlink.h"
+#include "pingchecksum.h"
+#include "sensorlogreader.h"
+#include "sensorlogsession.h"
+#include "sensorlogwriter.h"
 #include "settingsmanager.h"
+#include "sharedframebuffer.h"
+#include "tcplink.h"
+#include "udplink.h"
 #include "util.h"
 #include "waterfall.h"
 
 #include "test.h"
 
 #include "ping-message-ping1d.h"
+#include "ping-message-ping360.h"
 
 void Test::initTestCase()
 {
@@ -95,6 +112,544 @@ void Test::ringVector()
     }
 }
 
+void Test::pingChecksum()
+{
+    // Vectorized and scalar versions should agree with any length and alignment
+    QByteArray data(2048, 0);
+    for(int i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(qrand() % 256);
+    }
+    for(int offset = 0; offset < 16; offset++) {
+        for(int length = 0; length < data.size() - offset; length += 37) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.constData()) + offset;
+            QVERIFY2(PingChecksum::calculate(bytes, length) == PingChecksum::calculateScalar(bytes, length),
+                     qPrintable(QString("Checksum does not match: offset %1, length %2").arg(offset).arg(length)));
+        }
+    }
+
+    // Must be the same checksum calculated by ping-cpp
+    ping360_device_data deviceData(1200);
+    for(int i = 0; i < 1200; i++) {
+        deviceData.set_data_at(i, data[i]);
+    }
+    deviceData.updateChecksum();
+    const QByteArray reference(reinterpret_cast<const char*>(deviceData.msgData), deviceData.msgDataLength());
+    PingChecksum::update(deviceData);
+    const QByteArray message(reinterpret_cast<const char*>(deviceData.msgData), deviceData.msgDataLength());
+    QVERIFY2(message == reference, qPrintable("Checksum is different from ping_message::updateChecksum."));
+
+    // Messages should be parsed in a single buffer, in split buffers and after garbage
+    PingParserExt parser;
+    int received = 0;
+    connect(&parser, &Parser::newMessage, [&received, &message](const ping_message& msg) {
+        received++;
+        QVERIFY(QByteArray(reinterpret_cast<const char*>(msg.msgData), msg.msgDataLength()) == message);
+    });
+    parser.parseBuffer(message + message);
+    parser.parseBuffer(message.left(100));
+    parser.parseBuffer(message.mid(100) + "garbage" + message);
+    QVERIFY2(received == 4, qPrintable(QString("Wrong number of parsed messages: %1").arg(received)));
+
+    // Corrupted messages should not be parsed
+    QByteArray corrupted = message;
+    corrupted[500] = corrupted[500] + 1;
+    parser.parseBuffer(corrupted);
+    QVERIFY2(received == 4 && parser.errors == 1, qPrintable("Corrupted message was parsed."));
+}
+
+void Test::sensorLog()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable("Not possible to create temporary folder."));
+
+    QVector<QByteArray> packets;
+    for(int i = 0; i < 3000; i++) {
+        packets.append(QByteArray(i % 300, static_cast<char>(i)));
+    }
+
+    // Correlated profiles split in packets of different sizes, as received from a serial link
+    // Compressed chunks delta encode the samples of the frames that are inside a single packet
+    QByteArray profiles;
+    for(int i = 0; i < 600; i++) {
+        ping1d_profile profile(200);
+        profile.set_ping_number(i);
+        profile.set_scan_length(10000);
+        profile.set_profile_data_length(200);
+        for(int sample = 0; sample < 200; sample++) {
+            profile.set_profile_data_at(sample, (sample + i / 10) % 256);
+        }
+        PingChecksum::update(profile);
+        profiles.append(reinterpret_cast<const char*>(profile.msgData), profile.msgDataLength());
+    }
+    for(int i = 0, offset = 0; offset < profiles.size(); i++) {
+        const int size = 1 + (i * 37) % 600;
+        packets.append(profiles.mid(offset, size));
+        offset += size;
+    }
+
+    // Version 1: QDataStream with time string
+    const QString version1 = dir.filePath("version1.bin");
+    {
+        QFile file(version1);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QDataStream out(&file);
+        for(int i = 0; i < packets.size(); i++) {
+            out << QTime::fromMSecsSinceStartOfDay(i * 10).toString("hh:mm:ss.zzz") << packets[i];
+        }
+    }
+
+    // Version 2 with small compressed chunks
+    const QString version2 = dir.filePath("version2.bin");
+    {
+        SensorLogWriter writer;
+        QVERIFY(writer.open(version2, 0, true, 4096));
+        for(int i = 0; i < packets.size(); i++) {
+            QVERIFY(writer.append(i * 10000000LL, packets[i]));
+        }
+    }
+
+    const QString converted = dir.filePath("converted.bin");
+    QVERIFY2(SensorLogWriter::convert(version1, converted), qPrintable("Log conversion failed."));
+
+    for(const auto& fileName : {version1, version2, converted}) {
+        SensorLogReader reader;
+        QVERIFY2(reader.open(fileName), qPrintable(QString("Not possible to open: %1").arg(fileName)));
+        reader.waitForIndex();
+        QVERIFY2(reader.size() == packets.size(),
+                 qPrintable(QString("Wrong number of packets in %1: %2").arg(fileName).arg(reader.size())));
+        // Out of order access, crossing chunks
+        for(int i = packets.size() - 1; i >= 0; i -= 7) {
+            QVERIFY2(reader.packet(i) == packets[i], qPrintable(QString("Packet %1 is different.").arg(i)));
+            const qint64 elapsed = reader.timestamp(i) - reader.timestamp(0);
+            QVERIFY2(elapsed == i * 10000000LL, qPrintable(QString("Packet %1 time is wrong: %2").arg(i).arg(elapsed)));
+        }
+
+        // Time seek, between packets should return the next one
+        const qint64 start = reader.timestamp(0);
+        for(int i = 0; i < packets.size(); i += 13) {
+            QVERIFY2(reader.indexAt(start + i * 10000000LL) == i, qPrintable(QString("Wrong seek to %1.").arg(i)));
+            QVERIFY2(reader.indexAt(start + i * 10000000LL - 1) == i, qPrintable(QString("Wrong seek before %1.").arg(i)));
+            QVERIFY2(reader.keyframeIndex(i) <= i, qPrintable(QString("Keyframe after %1.").arg(i)));
+        }
+        QVERIFY(reader.indexAt(start + packets.size() * 10000000LL) == packets.size());
+    }
+
+    // Newer versions are refused, they are not read as version 1 logs
+    const QString newer = dir.filePath("newer.bin");
+    {
+        QFile file(version2);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QByteArray data = file.readAll();
+        qToLittleEndian<quint32>(SensorLogFormat::version + 1, data.data() + 8);
+        QFile newerFile(newer);
+        QVERIFY(newerFile.open(QIODevice::WriteOnly) && newerFile.write(data) == data.size());
+    }
+    SensorLogReader newerReader;
+    QVERIFY2(!newerReader.open(newer), qPrintable("Log with a newer version should not be opened."));
+
+    // Session of two logs, the second starts 2 seconds after the end of the first one
+    const qint64 lastTimestamp = (packets.size() - 1) * 10000000LL;
+    const QString next = dir.filePath("next.bin");
+    {
+        SensorLogWriter writer;
+        QVERIFY(writer.open(next, lastTimestamp + 2000000000LL, true, 4096));
+        for(int i = 0; i < packets.size(); i++) {
+            QVERIFY(writer.append(i * 10000000LL, packets[i]));
+        }
+    }
+
+    SensorLogSession session;
+    QVERIFY(session.open({next, version2}));
+    QVERIFY(session.fileNames() == QStringList({version2, next}));
+    session.waitForIndex();
+    QVERIFY2(session.size() == 2 * packets.size(), qPrintable(QString("Wrong session size: %1").arg(session.size())));
+    // The gap between logs is limited
+    const qint64 nextStart = lastTimestamp + SensorLogSession::maximumGapNSecs;
+    QVERIFY2(session.timestamp(packets.size()) == nextStart,
+             qPrintable(QString("Wrong time of the second log: %1").arg(session.timestamp(packets.size()))));
+    for(int i = 0; i < 2 * packets.size(); i += 11) {
+        QVERIFY2(session.packet(i) == packets[i % packets.size()], qPrintable(QString("Session packet %1 is different.").arg(i)));
+    }
+    QVERIFY(session.indexAt(lastTimestamp + 1) == packets.size());
+    QVERIFY(session.indexAt(nextStart + 130000000LL) == packets.size() + 13);
+    QVERIFY(session.keyframeIndex(packets.size() + 13) >= packets.size());
+
+    // Version 1 times are relative to the log creation, logs are ordered by the creation time in the name
+    // or by the last modification minus the log duration
+    const QDateTime modified = QDateTime::currentDateTime().addSecs(-3600);
+    auto writeVersion1 = [&packets](const QString& fileName, int firstSecond, const QDateTime& lastModified) {
+        QFile file(fileName);
+        if(!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        QDataStream out(&file);
+        for(int i = 0; i < 3; i++) {
+            out << QTime::fromMSecsSinceStartOfDay((firstSecond + i) * 1000).toString("hh:mm:ss.zzz") << packets[i];
+        }
+        file.flush();
+        return !lastModified.isValid() || file.setFileTime(lastModified, QFileDevice::FileModificationTime);
+    };
+    const QString earlier = dir.filePath("later-name.bin");
+    const QString later = dir.filePath("earlier-name.bin");
+    const QString named = dir.filePath(modified.addDays(-1).toString("yyyyMMdd-hhmmsszzz") + ".bin");
+    QVERIFY(writeVersion1(earlier, 10, modified));
+    QVERIFY(writeVersion1(later, 1, modified.addSecs(60)));
+    QVERIFY(writeVersion1(named, 20, {}));
+
+    qint64 timestamp;
+    qint64 time;
+    QVERIFY(SensorLogReader::firstPacketTime(earlier, &timestamp, &time));
+    QVERIFY2(time == (modified.toMSecsSinceEpoch() - 2000) * 1000000LL,
+             qPrintable(QString("Wrong start of version 1 log: %1").arg(time)));
+
+    SensorLogSession version1Session;
+    QVERIFY(version1Session.open({later, earlier, named}));
+    QVERIFY2(version1Session.fileNames() == QStringList({named, earlier, later}),
+             qPrintable(QString("Wrong version 1 order: %1").arg(version1Session.fileNames().join(' '))));
+}
+
+void Test::asyncLogWriter()
+{
+    // Producer and consumer in different threads should keep the order
+    SpscQueue<int> queue(1000);
+    QVERIFY2(queue.capacity() == 1024, qPrintable("Capacity should be a power of two."));
+    static const int numberOfItems = 100000;
+    QScopedPointer<QThread> producer(QThread::create([&queue] {
+        for(int i = 0; i < numberOfItems;) {
+            int item = i;
+            if(queue.push(std::move(item))) {
+                i++;
+            }
+        }
+    }));
+    producer->start();
+    for(int expected = 0; expected < numberOfItems;) {
+        int item;
+        if(queue.pop(item)) {
+            QVERIFY2(item == expected, qPrintable(QString("Wrong item: %1 != %2").arg(item).arg(expected)));
+            expected++;
+        }
+    }
+    producer->wait();
+    QVERIFY(queue.isEmpty());
+
+    // Everything appended should be in the log after close
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath("async.bin");
+    AsyncLogWriter writer;
+    QVERIFY(writer.open(fileName, 0, false, AsyncLogWriter::SyncPeriodically, 10));
+    for(int i = 0; i < 1000; i++) {
+        QVERIFY(writer.append(i, QByteArray::number(i)));
+    }
+    writer.close();
+    QVERIFY2(writer.writtenPackets() == 1000 && writer.droppedPackets() == 0,
+             qPrintable(QString("Wrong number of written packets: %1").arg(writer.writtenPackets())));
+
+    SensorLogReader reader;
+    QVERIFY(reader.open(fileName));
+    reader.waitForIndex();
+    QVERIFY2(reader.size() == 1000, qPrintable(QString("Wrong number of packets: %1").arg(reader.size())));
+    QVERIFY(reader.packet(999) == QByteArray::number(999));
+}
+
+void Test::tcpLink()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    TCPLink link;
+    QVERIFY(link.setConfiguration({LinkType::Tcp, {"127.0.0.1", QString::number(server.serverPort())}}));
+    QByteArray received;
+    connect(&link, &AbstractLink::newData, [&received](const QByteArray& data) { received.append(data); });
+    QVERIFY(link.startConnection());
+    QVERIFY(link.isOpen());
+
+    QVERIFY(server.waitForNewConnection(1000));
+    QScopedPointer<QTcpSocket> peer(server.nextPendingConnection());
+    QTRY_VERIFY(link.isConnected());
+    QVERIFY(link.tcpSocket()->socketOption(QAbstractSocket::LowDelayOption).toInt() == 1);
+
+    // Writes split in many segments arrive complete and in order
+    QByteArray data;
+    for(int i = 0; i < 100; i++) {
+        data.append(QByteArray(i + 1, static_cast<char>(i)));
+        peer->write(data.right(i + 1));
+    }
+    peer->flush();
+    QTRY_VERIFY2(received == data, qPrintable(QString("Received %1 of %2 bytes.").arg(received.size()).arg(data.size())));
+
+    emit link.sendData(data);
+    QByteArray sent;
+    QTRY_VERIFY((sent.append(peer->readAll()), sent == data));
+
+    // Link reconnects after the server drops the connection
+    peer->disconnectFromHost();
+    QTRY_VERIFY(server.hasPendingConnections());
+    peer.reset(server.nextPendingConnection());
+    QTRY_VERIFY(link.isConnected());
+    QVERIFY2(link.reconnections() > 0, qPrintable("Link did not reconnect."));
+
+    link.finishConnection();
+    QVERIFY(!link.isOpen());
+}
+
+void Test::udpLink()
+{
+    QUdpSocket server;
+    QVERIFY(server.bind(QHostAddress::LocalHost));
+
+    UDPLink link;
+    QVERIFY(link.setConfiguration({LinkType::Udp, {"127.0.0.1", QString::number(server.localPort())}}));
+    QByteArray received;
+    connect(&link, &AbstractLink::newData, [&received](const QByteArray& data) { received.append(data); });
+    QVERIFY(link.startConnection());
+    QTRY_VERIFY(link.udpSocket()->state() == QAbstractSocket::ConnectedState);
+
+    // The server answers to the address of the first datagram
+    emit link.sendData("hello");
+    QTRY_VERIFY(server.hasPendingDatagrams());
+    QHostAddress client;
+    quint16 clientPort;
+    QByteArray hello(5, 0);
+    QVERIFY(server.readDatagram(hello.data(), hello.size(), &client, &clientPort) == 5 && hello == "hello");
+
+    // Ping numbers 0..99 with 50 and 51 swapped
+    QByteArray data;
+    for(int i = 0; i < 100; i++) {
+        ping1d_distance distance;
+        distance.set_ping_number(i == 50 ? 51 : i == 51 ? 50 : i);
+        PingChecksum::update(distance);
+        const QByteArray message(reinterpret_cast<const char*>(distance.msgData), distance.msgDataLength());
+        QVERIFY(server.writeDatagram(message, client, clientPort) == message.size());
+        data.append(message);
+    }
+    QTRY_VERIFY2(received == data, qPrintable(QString("Received %1 of %2 bytes.").arg(received.size()).arg(data.size())));
+
+    const QVariantMap statistics = link.statistics();
+    QVERIFY2(statistics["datagrams"].toULongLong() == 100,
+             qPrintable(QString("Wrong number of datagrams: %1").arg(statistics["datagrams"].toULongLong())));
+    QVERIFY2(statistics["reorders"].toULongLong() == 1,
+             qPrintable(QString("Wrong number of reorders: %1").arg(statistics["reorders"].toULongLong())));
+}
+
+void Test::linkTee()
+{
+    QObject context;
+    LinkTee tee;
+    QList<QByteArray> direct;
+    QList<QByteArray> oldest;
+    QList<QByteArray> newest;
+    tee.addSink("direct", &context, [&direct](const QByteArray& data) { direct.append(data); }, 0);
+    tee.addSink("oldest", &context, [&oldest](const QByteArray& data) { oldest.append(data); }, 2,
+                LinkTee::DropOldest);
+    const int newestSink = tee.addSink("newest", &context,
+                                       [&newest](const QByteArray& data) { newest.append(data); }, 2,
+                                       LinkTee::DropNewest);
+
+    for(int i = 0; i < 4; i++) {
+        tee.push(QByteArray::number(i));
+    }
+    // Direct sinks are called by push, queued sinks wait for the event loop
+    QVERIFY(direct.size() == 4 && oldest.isEmpty() && newest.isEmpty());
+
+    QCoreApplication::processEvents();
+    QVERIFY2(oldest == QList<QByteArray>({"2", "3"}), qPrintable(QString("Wrong oldest sink data")));
+    QVERIFY2(newest == QList<QByteArray>({"0", "1"}), qPrintable(QString("Wrong newest sink data")));
+
+    const QVariantMap statistics = tee.statistics();
+    QVERIFY(statistics["direct"].toMap()["delivered"].toULongLong() == 4);
+    QVERIFY(statistics["oldest"].toMap()["dropped"].toULongLong() == 2);
+    QVERIFY(statistics["newest"].toMap()["delivered"].toULongLong() == 2);
+
+    // Removed sinks do not receive pending buffers
+    tee.push("4");
+    tee.removeSink(newestSink);
+    QCoreApplication::processEvents();
+    QVERIFY(newest.size() == 2 && oldest.last() == "4");
+}
+
+void Test::linkRelay()
+{
+    // Find free ports
+    quint16 tcpPort;
+    quint16 udpPort;
+    {
+        QTcpServer server;
+        QUdpSocket socket;
+        QVERIFY(server.listen(QHostAddress::LocalHost) && socket.bind(QHostAddress::LocalHost));
+        tcpPort = server.serverPort();
+        udpPort = socket.localPort();
+    }
+
+    LinkRelay relay;
+    QVERIFY(relay.listen(QHostAddress::LocalHost, tcpPort, udpPort));
+    QByteArray commands;
+    connect(&relay, &LinkRelay::clientData, [&commands](const QByteArray& data) { commands.append(data); });
+
+    TCPLink tcpLink;
+    QVERIFY(tcpLink.setConfiguration({LinkType::Tcp, {"127.0.0.1", QString::number(tcpPort)}}));
+    QByteArray tcpReceived;
+    connect(&tcpLink, &AbstractLink::newData, [&tcpReceived](const QByteArray& data) { tcpReceived.append(data); });
+    QVERIFY(tcpLink.startConnection());
+
+    // UDP clients are registered by their first datagram
+    UDPLink udpLink;
+    QVERIFY(udpLink.setConfiguration({LinkType::Udp, {"127.0.0.1", QString::number(udpPort)}}));
+    QByteArray udpReceived;
+    connect(&udpLink, &AbstractLink::newData, [&udpReceived](const QByteArray& data) { udpReceived.append(data); });
+    QVERIFY(udpLink.startConnection());
+    QTRY_VERIFY(udpLink.udpSocket()->state() == QAbstractSocket::ConnectedState);
+    emit udpLink.sendData("udp");
+
+    QTRY_VERIFY2(relay.clients() == 2, qPrintable(QString("Wrong number of clients: %1").arg(relay.clients())));
+    QVERIFY(commands == "udp");
+
+    QByteArray data;
+    for(int i = 0; i < 100; i++) {
+        const QByteArray chunk(i + 1, static_cast<char>(i));
+        relay.send(chunk);
+        data.append(chunk);
+    }
+    QTRY_VERIFY2(tcpReceived == data, qPrintable(QString("TCP received %1 of %2 bytes.").arg(tcpReceived.size()).arg(data.size())));
+    QTRY_VERIFY2(udpReceived == data, qPrintable(QString("UDP received %1 of %2 bytes.").arg(udpReceived.size()).arg(data.size())));
+    QVERIFY(relay.statistics()["droppedBytes"].toULongLong() == 0);
+
+    // A client that does not read loses old data but does not block the others
+    // Reopening the relay drops the clients, the TCP link reconnects
+    udpLink.finishConnection();
+    QVERIFY(relay.listen(QHostAddress::LocalHost, tcpPort, 0));
+    QTRY_VERIFY(relay.clients() == 1);
+    QTcpSocket stalled;
+    stalled.connectToHost(QHostAddress::LocalHost, tcpPort);
+    QVERIFY(stalled.waitForConnected(1000));
+    QTRY_VERIFY(relay.clients() == 2);
+    stalled.setReadBufferSize(1);
+    tcpReceived.clear();
+    const QByteArray block(64 * 1024, 'x');
+    for(int i = 0; i < 256; i++) {
+        relay.send(block);
+        QCoreApplication::processEvents();
+    }
+    QTRY_VERIFY2(tcpReceived.size() == 256 * block.size(),
+                 qPrintable(QString("TCP received %1 bytes.").arg(tcpReceived.size())));
+    QVERIFY(relay.statistics()["droppedBytes"].toULongLong() > 0);
+
+    tcpLink.finishConnection();
+    relay.close();
+    QVERIFY(!relay.isListening() && relay.clients() == 0);
+}
+
+void Test::sharedFrameBuffer()
+{
+#ifdef PING_SHM_POSIX
+    const QString name = QStringLiteral("/ping-viewer-test-%1").arg(QCoreApplication::applicationPid());
+    SharedFrameBuffer buffer;
+    QVERIFY(buffer.open(name, 4, 100));
+
+    PingShm::Reader reader;
+    QVERIFY(reader.open(name.toStdString()));
+    PingShm::Frame frame;
+    QVERIFY(reader.read(frame) == PingShm::Reader::NoData);
+
+    QByteArray samples(200, 0);
+    for(int i = 0; i < samples.size(); i++) {
+        samples[i] = static_cast<char>(i);
+    }
+    const auto publish = [&buffer, &samples](uint32_t pingNumber, int sampleCount) {
+        PingShm::FrameHeader header{};
+        header.sensorType = PingShm::Ping1D;
+        header.pingNumber = pingNumber;
+        buffer.publish(header, reinterpret_cast<const uint8_t*>(samples.constData()), sampleCount);
+    };
+
+    // Frames larger than the slot are truncated, slots are aligned and may take a few more samples
+    publish(0, 10);
+    publish(1, 200);
+    QVERIFY(reader.read(frame) == PingShm::Reader::Ok);
+    QVERIFY(frame.header.pingNumber == 0 && frame.samples.size() == 10 && frame.samples[9] == 9);
+    QVERIFY(reader.read(frame) == PingShm::Reader::Ok);
+    QVERIFY(frame.header.pingNumber == 1 && frame.header.timestampNs > 0
+            && frame.samples.size() == PingShm::slotSize(100) - sizeof(PingShm::FrameHeader));
+    QVERIFY(reader.read(frame) == PingShm::Reader::NoData);
+
+    // A slow reader continues from the oldest frame available
+    for(uint32_t i = 2; i < 12; i++) {
+        publish(i, 50);
+    }
+    QVERIFY(reader.read(frame) == PingShm::Reader::Ok);
+    QVERIFY2(frame.header.pingNumber == 8 && reader.lostFrames() == 6,
+             qPrintable(QString("Wrong frame %1 with %2 lost frames.").arg(frame.header.pingNumber).arg(reader.lostFrames())));
+
+    buffer.close();
+    QVERIFY(!reader.open(name.toStdString()));
+
+    // A buffer replaced by a new one with the same name, e.g. when the sensor is reconnected, keeps the new one
+    SharedFrameBuffer oldBuffer;
+    SharedFrameBuffer newBuffer;
+    QVERIFY(oldBuffer.open(name, 4, 100));
+    QVERIFY(newBuffer.open(name, 4, 100));
+    oldBuffer.close();
+    QVERIFY(reader.open(name.toStdString()));
+    newBuffer.close();
+    QVERIFY(!reader.open(name.toStdString()));
+#endif
+}
+
+void Test::simulationLink()
+{
+    const LinkConfiguration configuration{LinkType::Ping1DSimulation,
+        {"rate=2000", "samples=500", "noise=gaussian", "seed=7", "burst=20:10"}};
+    QVERIFY(configuration.isValid());
+
+    // Links with the same configuration generate the same stream
+    Ping1DSimulationLink first;
+    Ping1DSimulationLink second;
+    QByteArray firstData;
+    QByteArray secondData;
+    connect(&first, &AbstractLink::newData, [&firstData](const QByteArray& data) { firstData.append(data); });
+    connect(&second, &AbstractLink::newData, [&secondData](const QByteArray& data) { secondData.append(data); });
+    QVERIFY(first.setConfiguration(configuration) && second.setConfiguration(configuration));
+    QVERIFY(first.startConnection() && second.startConnection());
+    QTRY_VERIFY(first.messages() >= 500 && second.messages() >= 500);
+    first.finishConnection();
+    second.finishConnection();
+    QVERIFY(!first.isOpen());
+
+    const int length = qMin(firstData.size(), secondData.size());
+    QVERIFY(length > 0 && firstData.left(length) == secondData.left(length));
+
+    // Everything generated is valid and in order
+    PingParserExt parser;
+    int profiles = 0;
+    connect(&parser, &PingParserExt::newMessage, [&profiles](const ping_message& message) {
+        QVERIFY(message.message_id() == Ping1dId::PROFILE);
+        const ping1d_profile profile(message);
+        QVERIFY(profile.ping_number() == static_cast<uint>(++profiles));
+        QVERIFY(profile.profile_data_length() == 500);
+    });
+    parser.parseBuffer(firstData);
+    QVERIFY2(profiles == static_cast<int>(first.messages()) && !parser.errors,
+             qPrintable(QString("Parsed %1 of %2 messages.").arg(profiles).arg(first.messages())));
+
+    // A different seed changes the noise
+    Ping360SimulationLink other;
+    QByteArray otherData;
+    connect(&other, &AbstractLink::newData, [&otherData](const QByteArray& data) { otherData.append(data); });
+    QVERIFY(other.setConfiguration({LinkType::Ping360Simulation, {"seed=1", "noise=uniform"}}));
+    QVERIFY(other.startConnection());
+    QTRY_VERIFY(other.messages() >= 1);
+    Ping360SimulationLink same;
+    QByteArray sameData;
+    connect(&same, &AbstractLink::newData, [&sameData](const QByteArray& data) { sameData.append(data); });
+    QVERIFY(same.setConfiguration({LinkType::Ping360Simulation, {"seed=2", "noise=uniform"}}));
+    QVERIFY(same.startConnection());
+    QTRY_VERIFY(same.messages() >= 1);
+    QVERIFY(otherData.left(1000) != sameData.left(1000));
+
+    QVERIFY(!first.setConfiguration({LinkType::Ping1DSimulation, {"rate=0"}}));
+    QVERIFY(!LinkConfiguration({LinkType::Ping1DSimulation, {"fast"}}).isValid());
+}
+
 void Test::settingsManager()
 {
     auto settingsManager = SettingsManager::self();
@@ -170,4 +725,48 @@ void Test::waterfallGradient()
 
 }
 
+void Test::frameQueue()
+{
+    QList<FrameQueue::Frame> drawn;
+    FrameQueue queue([&drawn](const FrameQueue::Frame& frame) { drawn.append(frame); });
+    queue.setCapacity(2);
+    const QVector<QVector<uint8_t>> profiles = {{10, 200}, {50, 20}, {30, 40}};
+
+    // Frames are drawn by the event loop, the oldest is dropped when the queue is full
+    for(int i = 0; i < profiles.size(); i++) {
+        queue.push(profiles[i], {static_cast<float>(i)});
+    }
+    QVERIFY(drawn.isEmpty() && queue.queued() == 2 && queue.dropped() == 1);
+    QTRY_VERIFY(drawn.size() == 2);
+    QVERIFY(drawn[0].samples == profiles[1] && drawn[1].parameters == QVector<float>({2}));
+
+    // Merged frames have the arguments of the newest profile
+    queue.setCapacity(1);
+    queue.setPolicy(FrameQueue::MergeMax);
+    for(const auto& profile : profiles) {
+        queue.push(profile, {0});
+    }
+    queue.flush();
+    QVERIFY2(drawn.last().samples == QVector<uint8_t>({50, 200}) && drawn.last().merged == 3,
+             qPrintable(QString("Wrong max merge")));
+
+    queue.setPolicy(FrameQueue::MergeMean);
+    for(const auto& profile : profiles) {
+        queue.push(profile, {0});
+    }
+    queue.flush();
+    QVERIFY2(drawn.last().samples == QVector<uint8_t>({30, 87}), qPrintable(QString("Wrong mean merge")));
+    QVERIFY(queue.merged() == 4);
+
+    // Block draws the oldest frame before queuing, nothing is lost
+    drawn.clear();
+    queue.setPolicy(FrameQueue::Block);
+    for(const auto& profile : profiles) {
+        queue.push(profile, {0});
+    }
+    QVERIFY(drawn.size() == 2 && queue.blocked() == 2);
+    queue.flush();
+    QVERIFY(drawn.size() == 3 && drawn.last().samples == profiles.last() && queue.dropped() == 1);
+}
+
 QTEST_MAIN(Test)
\ No newline at end of file
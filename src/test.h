@@ -26,6 +26,60 @@ private slots:
      */
     void ringVector();
 
+    /**
+     * @brief Test vectorized checksum and the parser bulk path
+     *
+     */
+    void pingChecksum();
+
+    /**
+     * @brief Test sensor log writer, reader and conversion between formats
+     *
+     */
+    void sensorLog();
+
+    /**
+     * @brief Test lock-free queue and asynchronous log writer
+     *
+     */
+    void asyncLogWriter();
+
+    /**
+     * @brief Test TCP link against a loopback server, including reconnection
+     *
+     */
+    void tcpLink();
+
+    /**
+     * @brief Test UDP link datagram batching and counters against a loopback server
+     *
+     */
+    void udpLink();
+
+    /**
+     * @brief Test link tee delivery and overflow policies
+     *
+     */
+    void linkTee();
+
+    /**
+     * @brief Test link relay serving TCP and UDP links on loopback
+     *
+     */
+    void linkRelay();
+
+    /**
+     * @brief Test shared memory frame publishing and reading
+     *
+     */
+    void sharedFrameBuffer();
+
+    /**
+     * @brief Test simulation links rate and reproducibility
+     *
+     */
+    void simulationLink();
+
     /**
      * @brief Test settings manager
      *
@@ -37,4 +91,10 @@ private slots:
      *
      */
     void waterfallGradient();
+
+    /**
+     * @brief Test frame queue overflow policies
+     *
+     */
+    void frameQueue();
 };
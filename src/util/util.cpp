@@ -2,6 +2,7 @@
 #include <QtCharts/QXYSeries>
 
 #include "logger.h"
+#include "profiledata.h"
 #include "util.h"
 
 PING_LOGGING_CATEGORY(util, "ping.util");
@@ -20,7 +21,7 @@ QStringList Util::serialPortList()
     return portNameList;
 }
 
-void Util::update(QtCharts::QAbstractSeries* series, const QVector<double>& points,
+void Util::update(QtCharts::QAbstractSeries* series, ProfileData* profile,
                   const float initPos, const float finalPos,
                   const float minPoint, const float maxPoint,
                   const float multiplier)
@@ -28,7 +29,7 @@ void Util::update(QtCharts::QAbstractSeries* series, const QVector<double>& poin
     static const int numberOfPoints = 300;
 
     // Check inputs
-    if (!series && points.isEmpty()) {
+    if (!series || !profile || profile->isEmpty()) {
         qCDebug(util) << "Serie or vector not valid.";
         return;
     }
@@ -56,10 +57,11 @@ void Util::update(QtCharts::QAbstractSeries* series, const QVector<double>& poin
 
     // Data
     const int lastDataPoint = int((finalPos - initPos)*distPoints);
-    const float dataIndexScale = points.length()/((finalPos - initPos)*distPoints);
+    const uint8_t* points = profile->constData();
+    const float dataIndexScale = profile->size()/((finalPos - initPos)*distPoints);
     #pragma omp for
     for(int i = 0; i < lastDataPoint; i++) {
-        realPoints << QPointF(i + lastStartPoint, multiplier * points[static_cast<int>(i*dataIndexScale)]);
+        realPoints << QPointF(i + lastStartPoint, multiplier * points[static_cast<int>(i*dataIndexScale)] / 255.0);
     }
 
     // Final
@@ -3,6 +3,7 @@
 #include <QLoggingCategory>
 #include <QtCharts>
 
+class ProfileData;
 class QJSEngine;
 class QQmlEngine;
 
@@ -20,17 +21,17 @@ class Util : public QObject
 
 public:
     /**
-     * @brief Create a QAbstractSeries from a list of points
+     * @brief Create a QAbstractSeries from a profile
      *
      * @param series
-     * @param points
+     * @param profile
      * @param initPos
      * @param finalPos
      * @param minPoint
      * @param maxPoint
      * @param multiplier
      */
-    Q_INVOKABLE void update(QtCharts::QAbstractSeries * series, const QVector<double>& points,
+    Q_INVOKABLE void update(QtCharts::QAbstractSeries * series, ProfileData* profile,
                             const float initPos, const float finalPos,
                             const float minPoint, const float maxPoint,
                             const float multiplier = 1
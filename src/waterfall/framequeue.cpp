@@ -0,0 +1,157 @@
+#include <algorithm>
+
+#include <QElapsedTimer>
+
+#include "framequeue.h"
+#include "logger.h"
+
+PING_LOGGING_CATEGORY(framequeue, "ping.framequeue")
+
+FrameQueue::FrameQueue(Consumer consumer, QObject* parent)
+    : QObject(parent)
+    , _consumer(consumer)
+{
+    _drainTimer.setSingleShot(true);
+    _drainTimer.setInterval(0);
+    connect(&_drainTimer, &QTimer::timeout, this, &FrameQueue::drain);
+}
+
+void FrameQueue::push(const QVector<uint8_t>& samples, const QVector<float>& parameters)
+{
+    if(_queue.size() >= _capacity) {
+        switch(_policy) {
+        case MergeMax:
+        case MergeMean:
+            if(_queue.last().samples.size() == samples.size()) {
+                Frame& frame = _queue.last();
+                merge(frame, samples);
+                // The merged frame is drawn with the arguments of the newest profile
+                frame.parameters = parameters;
+                _merged++;
+                return;
+            }
+            // A profile with a different size can't be merged, e.g. after a range change
+            _queue.dequeue();
+            _dropped++;
+            break;
+        case Block:
+            while(_queue.size() >= _capacity) {
+                drawOldest();
+                _blocked++;
+            }
+            break;
+        case DropOldest:
+        default:
+            _queue.dequeue();
+            _dropped++;
+            break;
+        }
+    }
+
+    _queue.enqueue({samples, parameters});
+    if(!_drainTimer.isActive()) {
+        _drainTimer.start();
+    }
+}
+
+void FrameQueue::merge(Frame& frame, const QVector<uint8_t>& samples) const
+{
+    uint8_t* points = frame.samples.data();
+    const uint8_t* newPoints = samples.constData();
+    const int size = samples.size();
+
+    if(_policy == MergeMax) {
+        for(int i = 0; i < size; i++) {
+            points[i] = std::max(points[i], newPoints[i]);
+        }
+        frame.sums.clear();
+        frame.merged++;
+        return;
+    }
+
+    // Sums avoid the rounding error of a running mean with uint8_t samples
+    if(frame.sums.isEmpty()) {
+        frame.sums.resize(size);
+        for(int i = 0; i < size; i++) {
+            frame.sums[i] = points[i] * frame.merged;
+        }
+    }
+    frame.merged++;
+    const quint32 count = frame.merged;
+    for(int i = 0; i < size; i++) {
+        frame.sums[i] += newPoints[i];
+        points[i] = static_cast<uint8_t>((frame.sums[i] + count / 2) / count);
+    }
+}
+
+void FrameQueue::drawOldest()
+{
+    const Frame frame = _queue.dequeue();
+    _consumer(frame);
+    _drawn++;
+}
+
+void FrameQueue::drain()
+{
+    QElapsedTimer timer;
+    timer.start();
+    while(!_queue.isEmpty() && timer.elapsed() < drawBudgetMs) {
+        drawOldest();
+    }
+
+    // Let the event loop handle other events, e.g. new sensor data, before drawing the rest
+    if(!_queue.isEmpty()) {
+        qCDebug(framequeue) << "Plot is behind the sensor," << _queue.size() << "frames queued";
+        _drainTimer.start();
+    }
+    emit statisticsChanged();
+}
+
+void FrameQueue::flush()
+{
+    _drainTimer.stop();
+    while(!_queue.isEmpty()) {
+        drawOldest();
+    }
+    emit statisticsChanged();
+}
+
+void FrameQueue::clear()
+{
+    _drainTimer.stop();
+    _queue.clear();
+    emit statisticsChanged();
+}
+
+void FrameQueue::setCapacity(int capacity)
+{
+    _capacity = std::max(1, capacity);
+    while(_queue.size() > _capacity) {
+        _queue.dequeue();
+        _dropped++;
+    }
+    emit statisticsChanged();
+}
+
+void FrameQueue::setPolicy(Policy policy)
+{
+    if(policy < DropOldest || policy > Block) {
+        qCWarning(framequeue) << "Invalid policy:" << policy;
+        return;
+    }
+    _policy = policy;
+    emit statisticsChanged();
+}
+
+QVariantMap FrameQueue::statistics() const
+{
+    return {
+        {"policy", _policy},
+        {"capacity", _capacity},
+        {"queued", _queue.size()},
+        {"drawn", _drawn},
+        {"dropped", _dropped},
+        {"merged", _merged},
+        {"blocked", _blocked},
+    };
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <functional>
+
+#include <QLoggingCategory>
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+#include <QVariantMap>
+#include <QVector>
+
+Q_DECLARE_LOGGING_CATEGORY(framequeue)
+
+/**
+ * @brief Bounded queue of profiles between a sensor and a plot
+ *  Sensors can deliver profiles faster than a plot is able to draw them, the plot pushes each profile
+ *  and the queue draws them in the next event loop iterations, limited by a time budget per iteration.
+ *  When the queue is full, the new profile is handled following the policy.
+ *
+ */
+class FrameQueue : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief What to do when a profile arrives and the queue is full
+     *
+     */
+    enum Policy {
+        // Drop the oldest profile, the plot shows the latest data
+        DropOldest,
+        // Merge the profile into the newest queued one, taking the maximum of each sample
+        MergeMax,
+        // Merge the profile into the newest queued one, taking the mean of each sample
+        MergeMean,
+        // Draw the oldest profile before queuing the new one, nothing is lost and the sensor waits for the plot
+        Block,
+    };
+    Q_ENUM(Policy)
+
+    /**
+     * @brief Profile samples and the draw arguments of the plot
+     *
+     */
+    struct Frame {
+        QVector<uint8_t> samples;
+        QVector<float> parameters;
+        // Number of profiles merged in this frame
+        int merged = 1;
+        // Sum of the merged samples, used by MergeMean
+        QVector<quint32> sums;
+    };
+
+    using Consumer = std::function<void(const Frame&)>;
+
+    /**
+     * @brief Construct a new Frame Queue object
+     *
+     * @param consumer draws a frame
+     * @param parent
+     */
+    FrameQueue(Consumer consumer, QObject* parent = nullptr);
+
+    /**
+     * @brief Queue a profile
+     *  Samples are implicitly shared, they are not copied unless the profile is merged
+     *
+     * @param samples
+     * @param parameters
+     */
+    void push(const QVector<uint8_t>& samples, const QVector<float>& parameters);
+
+    /**
+     * @brief Draw all queued frames now
+     *
+     */
+    void flush();
+
+    /**
+     * @brief Discard all queued frames, counters are kept
+     *
+     */
+    void clear();
+
+    /**
+     * @brief Set the maximum number of queued frames
+     *
+     * @param capacity
+     */
+    void setCapacity(int capacity);
+    int capacity() const { return _capacity; };
+
+    /**
+     * @brief Set the overflow policy
+     *
+     * @param policy
+     */
+    void setPolicy(Policy policy);
+    Policy policy() const { return _policy; };
+
+    /**
+     * @brief Return the number of frames dropped by DropOldest
+     *  Merge policies also drop frames when the profile size changes
+     *
+     * @return quint64
+     */
+    quint64 dropped() const { return _dropped; };
+
+    /**
+     * @brief Return the number of profiles merged into another frame
+     *
+     * @return quint64
+     */
+    quint64 merged() const { return _merged; };
+
+    /**
+     * @brief Return the number of frames drawn by push while the queue was full with Block
+     *
+     * @return quint64
+     */
+    quint64 blocked() const { return _blocked; };
+
+    /**
+     * @brief Return the number of drawn frames
+     *
+     * @return quint64
+     */
+    quint64 drawn() const { return _drawn; };
+
+    /**
+     * @brief Return the number of queued frames
+     *
+     * @return int
+     */
+    int queued() const { return _queue.size(); };
+
+    /**
+     * @brief Return policy and frame counters
+     *
+     * @return QVariantMap
+     */
+    QVariantMap statistics() const;
+
+    static const int defaultCapacity = 64;
+    // Maximum time spent drawing frames in each event loop iteration
+    static const int drawBudgetMs = 8;
+
+signals:
+    /**
+     * @brief Counters changed, emitted at most once per event loop iteration
+     *
+     */
+    void statisticsChanged();
+
+private:
+    Q_DISABLE_COPY(FrameQueue)
+
+    /**
+     * @brief Draw queued frames until the time budget is over
+     *
+     */
+    void drain();
+
+    /**
+     * @brief Draw the oldest frame
+     *
+     */
+    void drawOldest();
+
+    /**
+     * @brief Merge samples into frame following the policy
+     *
+     * @param frame
+     * @param samples
+     */
+    void merge(Frame& frame, const QVector<uint8_t>& samples) const;
+
+    quint64 _blocked = 0;
+    int _capacity = defaultCapacity;
+    Consumer _consumer;
+    QTimer _drainTimer;
+    quint64 _drawn = 0;
+    quint64 _dropped = 0;
+    quint64 _merged = 0;
+    Policy _policy = DropOldest;
+    QQueue<Frame> _queue;
+};
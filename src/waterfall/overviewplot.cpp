@@ -0,0 +1,99 @@
+#include "overviewplot.h"
+
+#include <QPainter>
+#include <QPainterPath>
+
+PING_LOGGING_CATEGORY(overviewplot, "ping.overviewplot")
+
+OverviewPlot::OverviewPlot(QQuickItem* parent)
+    : Waterfall(parent)
+{
+    setAcceptedMouseButtons(Qt::NoButton);
+    setAcceptHoverEvents(false);
+    connect(this, &Waterfall::themeChanged, this, &OverviewPlot::updateImage);
+}
+
+void OverviewPlot::setOverview(LogOverview* overview)
+{
+    if(_overview == overview) {
+        return;
+    }
+
+    if(_overview) {
+        disconnect(_overview, &LogOverview::updated, this, &OverviewPlot::updateImage);
+    }
+    _overview = overview;
+    if(_overview) {
+        // The overview is updated from its worker thread
+        connect(_overview, &LogOverview::updated, this, &OverviewPlot::updateImage, Qt::QueuedConnection);
+    }
+    updateImage();
+    emit overviewChanged();
+}
+
+void OverviewPlot::clear()
+{
+    _image = QImage();
+    _depth.clear();
+    _maxDepth = 0;
+    update();
+}
+
+void OverviewPlot::updateImage()
+{
+    if(!_overview) {
+        clear();
+        return;
+    }
+
+    const QImage waterfall = _overview->waterfall();
+    _depth = _overview->depth();
+    _maxDepth = _overview->maxDepth();
+
+    // Convert intensity to the theme colors with a lookup table
+    QVector<QRgb> colors(256);
+    for(int i = 0; i < colors.size(); i++) {
+        colors[i] = valueToRGB(i / 255.0f).rgb();
+    }
+    // Intensity is used as color index, the conversion makes a deep copy of the waterfall data
+    QImage indexed(waterfall.constBits(), waterfall.width(), waterfall.height(), waterfall.bytesPerLine(),
+                   QImage::Format_Indexed8);
+    indexed.setColorTable(colors);
+    _image = indexed.convertToFormat(QImage::Format_RGB32);
+    update();
+}
+
+void OverviewPlot::paint(QPainter* painter)
+{
+    if(_image.isNull()) {
+        return;
+    }
+
+    const QRectF area(0, 0, width(), height());
+    painter->drawImage(area, _image);
+
+    if(_maxDepth <= 0 || _depth.isEmpty()) {
+        return;
+    }
+
+    // Depth track, columns without distance break the line
+    QPainterPath track;
+    bool drawing = false;
+    const float columnWidth = width() / _depth.size();
+    for(int column = 0; column < _depth.size(); column++) {
+        if(_depth[column] < 0) {
+            drawing = false;
+            continue;
+        }
+        const QPointF point((column + 0.5f) * columnWidth, _depth[column] / _maxDepth * height());
+        if(drawing) {
+            track.lineTo(point);
+        } else {
+            track.moveTo(point);
+            drawing = true;
+        }
+    }
+    painter->setRenderHint(QPainter::Antialiasing, antialiasing());
+    painter->setPen(QPen(Qt::white, 1.5));
+    painter->drawPath(track);
+}
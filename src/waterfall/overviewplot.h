@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QImage>
+#include <QPointer>
+#include <QQuickPaintedItem>
+#include <QVector>
+
+#include "logger.h"
+#include "logoverview.h"
+#include "waterfall.h"
+
+Q_DECLARE_LOGGING_CATEGORY(overviewplot)
+
+/**
+ * @brief Minimap of a sensor log, draws the LogOverview waterfall and depth track
+ *  Mouse events are not accepted, allowing the item to be used as background of other controls (e.g. Slider)
+ *
+ */
+class OverviewPlot : public Waterfall
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Construct a new Overview Plot object
+     *
+     * @param parent
+     */
+    OverviewPlot(QQuickItem* parent = nullptr);
+
+    /**
+     * @brief Paint overview image and depth track
+     *
+     * @param painter
+     */
+    void paint(QPainter* painter) final override;
+
+    /**
+     * @brief Clear overview image
+     *
+     */
+    Q_INVOKABLE void clear() final override;
+
+    /**
+     * @brief Return overview
+     *
+     * @return LogOverview*
+     */
+    LogOverview* overview() const { return _overview; }
+
+    /**
+     * @brief Set the overview
+     *
+     * @param overview
+     */
+    void setOverview(LogOverview* overview);
+    Q_PROPERTY(LogOverview* overview READ overview WRITE setOverview NOTIFY overviewChanged)
+
+signals:
+    void overviewChanged();
+
+private:
+    /**
+     * @brief Update image with the overview data using the waterfall theme
+     *
+     */
+    void updateImage();
+
+    QPointer<LogOverview> _overview;
+    QImage _image;
+    QVector<float> _depth;
+    float _maxDepth = 0;
+};
@@ -35,6 +35,7 @@ PolarPlot::PolarPlot(QQuickItem *parent)
 void PolarPlot::clear()
 {
     qCDebug(polarplot) << "Cleaning waterfall and restarting internal variables";
+    _frameQueue.clear();
     _image.fill(Qt::transparent);
     _distances.fill(0, _angularResolution);
     _maxDistance = 0;
@@ -60,11 +61,28 @@ void PolarPlot::setImage(const QImage &image)
     setImplicitHeight(image.height());
 }
 
-void PolarPlot::draw(const QVector<double>& points, float angle, float initPoint, float length, float angleGrad,
+void PolarPlot::draw(ProfileData* profile, float angle, float initPoint, float length, float angleGrad,
                      float sectorSize)
 {
-    Q_UNUSED(initPoint)
-    Q_UNUSED(length)
+    if(!profile || profile->isEmpty()) {
+        qCWarning(polarplot) << "Invalid profile.";
+        return;
+    }
+
+    _frameQueue.push(profile->samples(), {angle, initPoint, length, angleGrad, sectorSize});
+}
+
+void PolarPlot::drawFrame(const FrameQueue::Frame& frame)
+{
+    const float angle = frame.parameters[0];
+    const float initPoint = frame.parameters[1];
+    const float length = frame.parameters[2];
+    const float angleGrad = frame.parameters[3];
+    const float sectorSize = frame.parameters[4];
+
+    // Samples are normalized only when drawn
+    static const float sampleScale = 1/255.0f;
+    const uint8_t* points = frame.samples.constData();
 
     static const QPoint center(_image.width()/2, _image.height()/2);
     static const float degreeToRadian = M_PI/180.0f;
@@ -91,10 +109,10 @@ void PolarPlot::draw(const QVector<double>& points, float angle, float initPoint
         emit maxDistanceChanged();
     }
 
-    const float linearFactor = points.size()/(float)center.x();
+    const float linearFactor = frame.samples.size()/(float)center.x();
     for(int i = 1; i < center.x(); i++) {
         if(i < center.x()*length/_maxDistance) {
-            pointColor = valueToRGB(points[static_cast<int>(i*linearFactor - 1)]);
+            pointColor = valueToRGB(points[static_cast<int>(i*linearFactor - 1)]*sampleScale);
         } else {
             pointColor = QColor(0, 0, 0, 0);
         }
@@ -4,6 +4,7 @@
 #include <QImage>
 
 #include "logger.h"
+#include "profiledata.h"
 #include "ringvector.h"
 #include "waterfall.h"
 #include "waterfallgradient.h"
@@ -42,16 +43,17 @@ public:
     void setImage(const QImage &image);
 
     /**
-     * @brief Draw a list of points in the waterfall
+     * @brief Queue a profile to be drawn in the polar waterfall
+     *  Check FrameQueue
      *
-     * @param points
+     * @param profile
      * @param angle
      * @param initPoint
      * @param length
      * @param angleGrad
      * @param sectorSize
      */
-    Q_INVOKABLE void draw(const QVector<double>& points, float angle, float initPoint, float length, float angleGrad,
+    Q_INVOKABLE void draw(ProfileData* profile, float angle, float initPoint, float length, float angleGrad,
                           float sectorSize);
 
     /**
@@ -101,6 +103,14 @@ signals:
     void mouseSampleAngleChanged();
     void mouseSampleDistanceChanged();
 
+protected:
+    /**
+     * @brief Draw a queued profile
+     *
+     * @param frame
+     */
+    void drawFrame(const FrameQueue::Frame& frame) final override;
+
 private:
     Q_DISABLE_COPY(PolarPlot)
 
@@ -61,8 +61,10 @@ QList<WaterfallGradient> Waterfall::_gradients {
 Waterfall::Waterfall(QQuickItem *parent)
     :QQuickPaintedItem(parent)
     ,_containsMouse(false)
+    ,_frameQueue([this](const FrameQueue::Frame& frame) {drawFrame(frame);})
     ,_smooth(true)
 {
+    connect(&_frameQueue, &FrameQueue::statisticsChanged, this, &Waterfall::framesChanged);
     setAntialiasing(_smooth);
     setAcceptedMouseButtons(Qt::AllButtons);
     setAcceptHoverEvents(true);
@@ -115,6 +117,16 @@ void Waterfall::setTheme(const QString& theme)
     qCWarning(waterfall) << "Not valid theme:" << theme <<" in:" << _themes;
 }
 
+WaterfallGradient Waterfall::gradient(const QString& theme)
+{
+    for(const auto& gradient : _gradients) {
+        if(gradient.name() == theme) {
+            return gradient;
+        }
+    }
+    return WaterfallGradient();
+}
+
 QColor Waterfall::valueToRGB(float point)
 {
     return _gradient.getColor(point);
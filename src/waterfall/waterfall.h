@@ -3,6 +3,7 @@
 #include <QQuickPaintedItem>
 #include <QImage>
 
+#include "framequeue.h"
 #include "logger.h"
 #include "ringvector.h"
 #include "waterfallgradient.h"
@@ -39,6 +40,14 @@ public:
      */
     void setTheme(const QString& theme);
 
+    /**
+     * @brief Return a built-in gradient, allows rendering without a waterfall item
+     *
+     * @param theme gradient name
+     * @return WaterfallGradient isOk is false if theme does not exist
+     */
+    static WaterfallGradient gradient(const QString& theme);
+
     /**
      * @brief Transform a power value 0-1 to color
      *
@@ -139,8 +148,62 @@ public:
     void setAliasing(bool antialiasing) {setAntialiasing(antialiasing); emit antialiasingChanged();}
     Q_PROPERTY(bool antialiasing READ antialiasing WRITE setAliasing NOTIFY antialiasingChanged)
 
+    /**
+     * @brief Return the policy used when profiles arrive faster than they are drawn
+     *  Check FrameQueue::Policy
+     *
+     * @return int
+     */
+    int framePolicy() const {return _frameQueue.policy();}
+
+    /**
+     * @brief Set the frame policy
+     *
+     * @param policy
+     */
+    void setFramePolicy(int policy) {_frameQueue.setPolicy(static_cast<FrameQueue::Policy>(policy));}
+    Q_PROPERTY(int framePolicy READ framePolicy WRITE setFramePolicy NOTIFY framesChanged)
+
+    /**
+     * @brief Return the number of profiles that were dropped without being drawn
+     *
+     * @return quint64
+     */
+    quint64 droppedFrames() const {return _frameQueue.dropped();}
+    Q_PROPERTY(quint64 droppedFrames READ droppedFrames NOTIFY framesChanged)
+
+    /**
+     * @brief Return the number of profiles that were merged into another column
+     *
+     * @return quint64
+     */
+    quint64 mergedFrames() const {return _frameQueue.merged();}
+    Q_PROPERTY(quint64 mergedFrames READ mergedFrames NOTIFY framesChanged)
+
+    /**
+     * @brief Return the number of profiles waiting to be drawn
+     *
+     * @return int
+     */
+    int queuedFrames() const {return _frameQueue.queued();}
+    Q_PROPERTY(int queuedFrames READ queuedFrames NOTIFY framesChanged)
+
+    /**
+     * @brief Return the queue between the sensor and the plot
+     *
+     * @return FrameQueue*
+     */
+    FrameQueue* frameQueue() {return &_frameQueue;}
+
+    /**
+     * @brief Draw all queued profiles now
+     *
+     */
+    Q_INVOKABLE void flush() {_frameQueue.flush();}
+
 signals:
     void antialiasingChanged();
+    void framesChanged();
 
     void mouseConfidenceChanged();
     // TODO: mouseMove should be renamed
@@ -152,7 +215,16 @@ signals:
     void smoothChanged();
 
 protected:
+    /**
+     * @brief Draw a profile that left the frame queue, plots without profiles (e.g. overview) don't use it
+     *
+     * @param frame
+     */
+    virtual void drawFrame(const FrameQueue::Frame& frame) {Q_UNUSED(frame)}
+
     bool _containsMouse;
+    // Profiles are drawn by the queue, in the next event loop iterations
+    FrameQueue _frameQueue;
     WaterfallGradient _gradient;
     static QList<WaterfallGradient> _gradients;
     QPoint _mousePos;
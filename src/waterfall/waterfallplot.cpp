@@ -77,6 +77,7 @@ void WaterfallPlot::setImage(const QImage &image)
 void WaterfallPlot::clear()
 {
     qCDebug(waterfall) << "Cleaning waterfall and restarting internal variables";
+    _frameQueue.clear();
     _maxDepthToDrawInPixels = 0;
     _minDepthToDrawInPixels = 0;
     _mouseDepth = 0;
@@ -84,8 +85,23 @@ void WaterfallPlot::clear()
     _image.fill(Qt::transparent);
 }
 
-void WaterfallPlot::draw(const QVector<double>& points, float confidence, float initPoint, float length, float distance)
+void WaterfallPlot::draw(ProfileData* profile, float confidence, float initPoint, float length, float distance)
 {
+    if(!profile || profile->isEmpty()) {
+        qCWarning(waterfallplot) << "Invalid profile.";
+        return;
+    }
+
+    _frameQueue.push(profile->samples(), {confidence, initPoint, length, distance});
+}
+
+void WaterfallPlot::drawFrame(const FrameQueue::Frame& frame)
+{
+    const float confidence = frame.parameters[0];
+    const float initPoint = frame.parameters[1];
+    const float length = frame.parameters[2];
+    const float distance = frame.parameters[3];
+
     /*
         initPoint: The lowest point of the last sample in meters
         length: The length of the last sample in meters
@@ -129,10 +145,21 @@ void WaterfallPlot::draw(const QVector<double>& points, float confidence, float
             virtualHeight = ((length + initPoint - _minDepthToDraw)*_minPixelsPerMeter*dynamicPixelsPerMeterScalar);
     */
 
+    // Samples are normalized only when drawn
+    static const float sampleScale = 1/255.0f;
+    const uint8_t* points = frame.samples.constData();
+    const int numberOfPoints = frame.samples.size();
+
     // Declare oldImage variable to do image spins
     static QImage old = _image;
     // Declare oldPoints variable to do some filter
-    static QVector<double> oldPoints = points;
+    static QVector<float> oldPoints;
+    if(oldPoints.size() != numberOfPoints) {
+        oldPoints.resize(numberOfPoints);
+        for(int i = 0; i < numberOfPoints; i++) {
+            oldPoints[i] = points[i]*sampleScale;
+        }
+    }
 
     // This ring vector will store variables of the last n samples for user access
     _DCRing.append({initPoint, length, confidence, distance});
@@ -230,10 +257,10 @@ void WaterfallPlot::draw(const QVector<double>& points, float confidence, float
     }
 
     // Do up/downsampling
-    float factor = points.length()/((float)(virtualHeight));
+    float factor = numberOfPoints/((float)(virtualHeight));
 
     // Check if everything is correct before the draw
-    if(floor(factor*virtualHeight) > points.length() || factor*virtualHeight < 0) {
+    if(floor(factor*virtualHeight) > numberOfPoints || factor*virtualHeight < 0) {
         qCWarning(waterfallplot) << "Wrong factor !";
         qCDebug(waterfallplot).noquote() << QStringLiteral("virtualHeight: %1\t virtualFloor: %2\t factor: %3\t").
                                          arg(virtualHeight).arg(virtualFloor).arg(factor);
@@ -255,21 +282,22 @@ void WaterfallPlot::draw(const QVector<double>& points, float confidence, float
 
     if(smooth()) {
         #pragma omp for
-        for(int i = 0; i < points.length(); i++) {
-            oldPoints[i] = points[i]*0.2 + oldPoints[i]*0.8;
+        for(int i = 0; i < numberOfPoints; i++) {
+            oldPoints[i] = points[i]*sampleScale*0.2f + oldPoints[i]*0.8f;
         }
 
         #pragma omp for
         for(int i = 0; i < virtualHeight; i++) {
-            _image.setPixelColor(_currentDrawIndex, i + virtualFloor, valueToRGB(oldPoints[factor*i]));
+            _image.setPixelColor(_currentDrawIndex, i + virtualFloor, valueToRGB(oldPoints[static_cast<int>(factor*i)]));
         }
     } else {
         #pragma omp for
         for(int i = 0; i < virtualHeight; i++) {
-            _image.setPixelColor(_currentDrawIndex, i + virtualFloor, valueToRGB(points[factor*i]));
+            _image.setPixelColor(_currentDrawIndex, i + virtualFloor, valueToRGB(points[static_cast<int>(factor*i)]*sampleScale));
         }
     }
-    _currentDrawIndex++; // This can get to be an issue at very fast update rates from ping
+    // Fast update rates are limited by the frame queue, each drawn frame is one column
+    _currentDrawIndex++;
 
     // Fix max update in 20Hz at max
     if(!_updateTimer->isActive()) {
@@ -4,6 +4,7 @@
 #include <QImage>
 
 #include "logger.h"
+#include "profiledata.h"
 #include "ringvector.h"
 #include "waterfall.h"
 #include "waterfallgradient.h"
@@ -49,15 +50,16 @@ public:
     Q_INVOKABLE void setWaterfallMaxDepth(float maxDepth);
 
     /**
-     * @brief Draw a list of points in the waterfall
+     * @brief Queue a profile to be drawn in the waterfall
+     *  Check FrameQueue
      *
-     * @param points
+     * @param profile
      * @param confidence
      * @param initPoint
      * @param length
      * @param distance
      */
-    Q_INVOKABLE void draw(const QVector<double>& points, float confidence = 0, float initPoint = 0, float length = 50,
+    Q_INVOKABLE void draw(ProfileData* profile, float confidence = 0, float initPoint = 0, float length = 50,
                           float distance = 0);
 
     /**
@@ -120,6 +122,14 @@ signals:
     void mouseColumnDepthChanged();
     void mouseDepthChanged();
 
+protected:
+    /**
+     * @brief Draw a queued profile
+     *
+     * @param frame
+     */
+    void drawFrame(const FrameQueue::Frame& frame) final override;
+
 private:
     Q_DISABLE_COPY(WaterfallPlot)
 
@@ -0,0 +1,54 @@
+/**
+ * Example of a process reading PingViewer frames from shared memory
+ *  Enable "Shared memory output" in PingViewer settings, then:
+ *   g++ -std=c++17 -O2 -I../../src/sensor example.cpp -o pingshm-example -lrt
+ *   ./pingshm-example /ping-viewer-ping360
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "pingshm.h"
+
+int main(int argc, char* argv[])
+{
+    const std::string name = argc > 1 ? argv[1] : "/ping-viewer-ping1d";
+
+    PingShm::Reader reader;
+    while(!reader.open(name)) {
+        std::fprintf(stderr, "Waiting for %s\n", name.c_str());
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    PingShm::Frame frame;
+    uint64_t lostFrames = 0;
+    while(true) {
+        if(reader.read(frame) != PingShm::Reader::Ok) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // Strongest sample of the profile
+        uint8_t maximum = 0;
+        for(const uint8_t sample : frame.samples) {
+            maximum = sample > maximum ? sample : maximum;
+        }
+
+        if(frame.header.sensorType == PingShm::Ping360) {
+            std::printf("frame %llu angle %u samples %u maximum %u\n",
+                static_cast<unsigned long long>(frame.header.frameNumber), frame.header.angle,
+                frame.header.sampleCount, maximum);
+        } else {
+            std::printf("frame %llu distance %u mm confidence %u%% samples %u maximum %u\n",
+                static_cast<unsigned long long>(frame.header.frameNumber), frame.header.distance,
+                frame.header.confidence, frame.header.sampleCount, maximum);
+        }
+
+        if(reader.lostFrames() != lostFrames) {
+            lostFrames = reader.lostFrames();
+            std::fprintf(stderr, "%llu frames lost\n", static_cast<unsigned long long>(lostFrames));
+        }
+    }
+    return 0;
+}
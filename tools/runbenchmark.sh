@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Variables
+bold=$(tput bold)
+normal=$(tput sgr0)
+scriptpath="$( cd "$(dirname "$0")" ; pwd -P )"
+projectpath=${scriptpath}/..
+
+# Functions
+echob() {
+    echo "${bold}${1}${normal}"
+}
+
+echob "Compile code in benchmark mode:"
+build_benchmark="$projectpath/build_benchmark"
+rm -rf $build_benchmark
+mkdir -p ${build_benchmark}
+qmake -o ${build_benchmark} -r -Wall -Wlogic -Wparser CONFIG+=benchmark CONFIG+=release ${projectpath}
+make -C ${build_benchmark} || exit 1
+
+echob "Run benchmark:"
+# Any argument is passed to the benchmark, E.g: --log Sensor_Log.bin --output result.json
+# End to end pipeline, runs offscreen: --pipeline --rate 5000 --duration 10000 --output pipeline.json
+$build_benchmark/pingviewer "$@"